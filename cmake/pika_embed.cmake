@@ -17,6 +17,10 @@
 # The original software has been modified to remove unwanted features
 # and to adapt the API to the Pikaball-Revamped project.
 
+# This file can also run in script mode (cmake -P) to embed a file generated at build time
+# (see pika_embed_generated). In that mode, only the source file generation is done.
+if (NOT CMAKE_SCRIPT_MODE_FILE)
+
 # Remember the binary dir for later
 set(EMBED_BINARY_DIR ${CMAKE_CURRENT_BINARY_DIR}/embed CACHE INTERNAL "binary directory of the battery::embed library" FORCE)
 
@@ -150,6 +154,8 @@ set(EMBED_IDENTIFIERS "" CACHE INTERNAL "list of all identifiers used by battery
 set(EMBED_FILENAMES "" CACHE INTERNAL "list of all filenames used by battery::embed")
 set(EMBED_TARGETS "" CACHE INTERNAL "list of all targets used by battery::embed")
 
+endif() # NOT CMAKE_SCRIPT_MODE_FILE
+
 # Defer the function call until the end of the configure step
 function(_embed_generate_all_hpps)
     message(STATUS "Generating pika::b::embed() HPP files ...")
@@ -302,3 +308,77 @@ function(pika_embed TARGET)
     endif()
 
 endfunction()
+
+# Embed files that are generated at build time (e.g. by a host tool).
+# The identifiers are registered at configure time, and the source files are generated
+# with this script (cmake -P) once the files exist.
+# The resource key of each file is its path relative to BASE_DIR.
+function(pika_embed_generated TARGET BASE_DIR)
+    if (NOT ARGN)
+        message(FATAL_ERROR "embed: pika_embed_generated requires at least one filename")
+    endif()
+
+    string(TOLOWER "${TARGET}" TARGET_ID)
+    string(REGEX REPLACE "[^a-zA-Z0-9_]" "_" TARGET_ID "${TARGET_ID}")
+
+    set(EMBED_HPP "${EMBED_BINARY_DIR}/autogen/${TARGET_ID}/include/battery/pika_embed.hpp")
+    set(EMBED_CPP_TEMPLATE "${EMBED_BINARY_DIR}/pika_embed_source_file_template.cpp")
+    file(MAKE_DIRECTORY "${EMBED_BINARY_DIR}/autogen/${TARGET_ID}/include/battery")
+    file(MAKE_DIRECTORY "${EMBED_BINARY_DIR}/autogen/${TARGET_ID}/src")
+
+    set(GENERATED_CPPS "")
+
+    foreach(FILENAME IN LISTS ARGN)
+        message(STATUS "Embedding generated file '${FILENAME}'")
+        file(RELATIVE_PATH _REL_PATH "${BASE_DIR}" "${FILENAME}")
+
+        string(TOLOWER "${TARGET_ID}_${_REL_PATH}" IDENTIFIER)
+        string(REGEX REPLACE "[^a-zA-Z0-9_]" "_" IDENTIFIER "${IDENTIFIER}")
+        embed_validate_identifier("${IDENTIFIER}")
+
+        set(CPP_FILE "${EMBED_BINARY_DIR}/autogen/${TARGET_ID}/src/pika_${IDENTIFIER}.cpp")
+
+        list(FIND EMBED_IDENTIFIERS ${IDENTIFIER} EMBED_USED_IDENTIFIERS_INDEX)
+        if (NOT EMBED_USED_IDENTIFIERS_INDEX EQUAL -1)
+            message(FATAL_ERROR "embed: Identifier already in use: '${IDENTIFIER}'")
+        endif()
+
+        set(EMBED_IDENTIFIERS ${EMBED_IDENTIFIERS} ${IDENTIFIER} CACHE INTERNAL "list of all identifiers used by the embed library")
+        set(EMBED_FILENAMES ${EMBED_FILENAMES} ${_REL_PATH} CACHE INTERNAL "list of all filenames used by the embed library")
+        set(EMBED_TARGETS ${EMBED_TARGETS} ${TARGET} CACHE INTERNAL "list of all targets used by the embed library")
+
+        # Generate the source file when the embedded file changes
+        add_custom_command(
+            OUTPUT "${CPP_FILE}"
+            COMMAND ${CMAKE_COMMAND}
+                "-DEMBED_INFILE=${EMBED_CPP_TEMPLATE}"
+                "-DEMBED_OUTFILE=${CPP_FILE}"
+                "-DEMBED_ABS_PATH=${FILENAME}"
+                "-DEMBED_IDENTIFIER=${IDENTIFIER}"
+                "-DEMBED_FILENAME=${_REL_PATH}"
+                -P "${CMAKE_CURRENT_FUNCTION_LIST_FILE}"
+            DEPENDS "${FILENAME}" "${EMBED_CPP_TEMPLATE}"
+            COMMENT "Embedding ${_REL_PATH}"
+            VERBATIM
+        )
+
+        list(APPEND GENERATED_CPPS "${CPP_FILE}")
+    endforeach()
+
+    # Generate header files (with the new identifiers)
+    _embed_generate_all_hpps()
+
+    target_include_directories(${TARGET} PUBLIC ${EMBED_BINARY_DIR}/autogen/${TARGET_ID}/include)
+    target_sources(${TARGET} PRIVATE ${GENERATED_CPPS} ${EMBED_HPP})
+endfunction()
+
+# Script mode: generate the source file of a file created at build time
+if (CMAKE_SCRIPT_MODE_FILE)
+    embed_generate_configure(
+        INFILE "${EMBED_INFILE}"
+        OUTFILE "${EMBED_OUTFILE}"
+        ABS_PATH "${EMBED_ABS_PATH}"
+        IDENTIFIER "${EMBED_IDENTIFIER}"
+        FILENAME "${EMBED_FILENAME}"
+    )
+endif()
@@ -0,0 +1,111 @@
+#ifndef PIKA_ALLOC_TRACKING_HPP
+#define PIKA_ALLOC_TRACKING_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Allocation tracking (opt-in with the PIKA_ALLOC_TRACKING build option).
+ *
+ * When enabled, the global operator new and the SDL memory functions count every allocation and
+ * attribute it to the subsystem of the calling thread, set with PIKA_ALLOC_SCOPE. The game uses it
+ * to report the allocations per frame and to check that the frames of a rally do not allocate.
+ * When disabled, the scopes are empty and the counts are always zero.
+ */
+namespace pika::alloc {
+
+/** Parts of the frame loop. Allocations outside any scope (e.g. other threads) are Background */
+enum class Subsystem : std::size_t {
+  Background,
+  Game,         // Game logic not included in the other subsystems
+  Events,
+  Controllers,
+  Physics,
+  Sound,
+  Render,
+  Present,
+};
+constexpr std::size_t num_subsystems = 8;
+constexpr std::array<const char*, num_subsystems> subsystem_names {
+  "background", "game", "events", "controllers", "physics", "sound", "render", "present"
+};
+
+/** Number of allocations and allocated bytes of each subsystem */
+struct Counts {
+  std::array<std::uint64_t, num_subsystems> allocations {};
+  std::array<std::uint64_t, num_subsystems> bytes {};
+
+  /** Allocations made by the frame loop (all the subsystems but Background) */
+  [[nodiscard]] std::uint64_t frame_allocations() const {
+    std::uint64_t total = 0;
+    for (std::size_t i = static_cast<std::size_t>(Subsystem::Game); i < num_subsystems; i++) {
+      total += allocations[i];
+    }
+    return total;
+  }
+
+  /** Counts made since an older snapshot */
+  [[nodiscard]] Counts operator-(const Counts& older) const {
+    Counts result;
+    for (std::size_t i = 0; i < num_subsystems; i++) {
+      result.allocations[i] = allocations[i] - older.allocations[i];
+      result.bytes[i] = bytes[i] - older.bytes[i];
+    }
+    return result;
+  }
+};
+
+// Subsystem of the calling thread
+inline thread_local Subsystem current_subsystem {Subsystem::Background};
+
+/** Sets the subsystem of the calling thread for the rest of the scope (restores the previous one) */
+class Scope {
+public:
+  explicit Scope(const Subsystem subsystem) : previous_(current_subsystem) {
+    current_subsystem = subsystem;
+  }
+  ~Scope() {
+    current_subsystem = previous_;
+  }
+  Scope(Scope const&) = delete;
+  Scope(Scope &&) = delete;
+  Scope &operator=(Scope const&) = delete;
+  Scope &operator=(Scope &&) = delete;
+
+private:
+  Subsystem previous_;
+};
+
+#ifdef PIKA_ALLOC_TRACKING
+constexpr bool tracking_enabled = true;
+
+/**
+ * Count the allocations made by SDL (and SDL_mixer / SDL_ttf). Call it before initializing SDL.
+ * The hooks call the original SDL functions, so memory allocated before is still freed correctly.
+ */
+void install_sdl_hooks();
+
+/** Allocations counted since the start of the program */
+[[nodiscard]] Counts counts();
+#else
+constexpr bool tracking_enabled = false;
+
+inline void install_sdl_hooks() {}
+
+[[nodiscard]] inline Counts counts() { return {}; }
+#endif
+
+} // namespace pika::alloc
+
+#define PIKA_ALLOC_CONCAT_IMPL(a, b) a##b
+#define PIKA_ALLOC_CONCAT(a, b) PIKA_ALLOC_CONCAT_IMPL(a, b)
+/** Attribute the allocations of the rest of the current scope to a subsystem */
+#ifdef PIKA_ALLOC_TRACKING
+#define PIKA_ALLOC_SCOPE(subsystem) \
+  const ::pika::alloc::Scope PIKA_ALLOC_CONCAT(pika_alloc_scope_, __LINE__) {::pika::alloc::Subsystem::subsystem}
+#else
+#define PIKA_ALLOC_SCOPE(subsystem) static_cast<void>(::pika::alloc::Subsystem::subsystem)
+#endif
+
+#endif // PIKA_ALLOC_TRACKING_HPP
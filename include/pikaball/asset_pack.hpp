@@ -0,0 +1,139 @@
+#ifndef PIKA_ASSET_PACK_HPP
+#define PIKA_ASSET_PACK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pika {
+
+/**
+ * 64-bit FNV-1a hash, used to index the assets of a pack by name.
+ * It is constexpr, so the hashes of the fixed asset names can be computed at compile time.
+ */
+constexpr std::uint64_t fnv1a(const std::string_view name) {
+  std::uint64_t hash = 0xcbf29ce484222325;
+  for (const char c : name) {
+    hash ^= static_cast<std::uint8_t>(c);
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+namespace lz {
+
+/**
+ * Compress a block with an LZ4-style format (sequences of literals and matches of at least
+ * 4 bytes with a 16-bit offset). Fast to decompress, and good enough for the raw pixels
+ * and sounds of the game.
+ * @param input The data to compress
+ * @return The compressed block
+ */
+std::vector<std::byte> compress(std::span<const std::byte> input);
+
+/**
+ * Decompress a block generated by compress()
+ * @param input The compressed block
+ * @param output Buffer for the decompressed data. Its size must be the exact original size
+ * @return True if the block is valid and fills the whole output
+ */
+bool decompress(std::span<const std::byte> input, std::span<std::byte> output);
+
+} // namespace pika::lz
+
+/**
+ * Read-only archive with all the game assets.
+ *
+ * The index is sorted by the FNV-1a hash of the asset names, so finding an asset is a binary search.
+ * Each asset is stored raw or compressed. Compressed assets are decompressed on their first access
+ * (from any thread) and kept in memory; raw assets are used directly from the pack data.
+ *
+ * Layout (little-endian): magic "PIKP", version, number of entries (Uint32), then one index
+ * entry per asset (hash, name offset, name size, data offset, packed size, size, flags),
+ * then the names, then the data of each asset.
+ */
+class AssetPack {
+public:
+  /** Name and contents of an asset to pack */
+  struct Input {
+    std::string name;
+    std::vector<std::byte> data;
+  };
+
+  ~AssetPack();
+  AssetPack(AssetPack const&) = delete;
+  AssetPack(AssetPack &&) = delete;
+  AssetPack &operator=(AssetPack const&) = delete;
+  AssetPack &operator=(AssetPack &&) = delete;
+
+  /**
+   * Read a pack in memory. The data is not copied, so it must outlive the pack
+   * @param data The contents of the pack (e.g. embedded in the binary)
+   */
+  explicit AssetPack(std::span<const std::byte> data);
+
+  /**
+   * Map a pack file into memory (read-only)
+   * @param path The pack file
+   * @return The pack, or nullptr if the file does not exist or it is not a valid pack
+   */
+  static std::unique_ptr<AssetPack> map_file(const std::string& path);
+
+  /**
+   * Build a pack. Each asset is compressed only if it gets smaller
+   * @param assets The assets to pack
+   * @return The contents of the pack file
+   */
+  static std::vector<std::byte> build(const std::vector<Input>& assets);
+
+  /** False if the data is not a valid pack (the pack is empty) */
+  [[nodiscard]] bool is_valid() const { return valid_; }
+
+  /** Number of assets in the pack */
+  [[nodiscard]] std::size_t size() const { return entries_.size(); }
+
+  /**
+   * Get the contents of an asset, decompressing it if this is the first access.
+   * Thread-safe. The returned data lives as long as the pack.
+   * @param name The asset name (the resource filename)
+   * @return The asset data, or nothing if the pack does not have it (or it is corrupted)
+   */
+  [[nodiscard]] std::optional<std::span<const std::byte>> find(std::string_view name) const;
+
+private:
+  struct Entry {
+    std::uint64_t hash {0};
+    std::string_view name;
+    std::span<const std::byte> packed;
+    std::size_t size {0};
+    bool compressed {false};
+  };
+
+  bool valid_ {false};
+  // Sorted by hash
+  std::vector<Entry> entries_;
+  // Contents of each entry, decompressed on the first access
+  std::unique_ptr<std::once_flag[]> load_once_;
+  mutable std::vector<std::unique_ptr<std::byte[]>> decompressed_;
+  mutable std::vector<std::optional<std::span<const std::byte>>> contents_;
+  // Mapped file (map_file() only)
+  void* mapping_ {nullptr};
+  std::size_t mapping_size_ {0};
+  std::vector<std::byte> file_data_;
+
+  AssetPack() = default;
+  /** Parse the header and the index */
+  void parse(std::span<const std::byte> data);
+  /** Get the contents of an entry (called once per entry) */
+  [[nodiscard]] std::optional<std::span<const std::byte>> load(std::size_t index) const;
+};
+
+} // namespace pika
+
+#endif // PIKA_ASSET_PACK_HPP
@@ -0,0 +1,237 @@
+#ifndef PIKA_BAKED_ASSETS_HPP
+#define PIKA_BAKED_ASSETS_HPP
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+/**
+ * Format of the pre-baked assets, generated at build time by pikaball_bake (src/bake_main.cpp).
+ *
+ * The sprite sheet is stored as raw pixels in the texture format, and the text font as
+ * an atlas with the glyphs already rasterized, so loading them is a copy and a texture
+ * upload (no PNG decoding or font rasterization at startup).
+ * All the integers are little-endian. The pixels are stored as packed 32-bit values
+ * in the byte order of the build machine.
+ *
+ * Image: magic, version, width, height (Uint32), then height rows of width pixels.
+ * Font: magic, version, line height, number of glyphs (Uint32),
+ *       then x, y, w, h and advance of each glyph (Uint16),
+ *       then the number of kerning pairs (Uint32) and the left and right characters (Uint8)
+ *       and the kerning (Sint16) of each pair, sorted by characters, then the atlas image.
+ */
+namespace pika::baked {
+
+using SDL_Surface_ptr = std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)>;
+
+// Identifies the baked files ("PIKB") and the version of their layout
+constexpr Uint32 magic = 0x424B4950;
+constexpr Uint32 version = 2;
+// Pixel format of the baked images (the format of the game textures, so the upload needs no conversion)
+constexpr SDL_PixelFormat pixel_format = SDL_PIXELFORMAT_ARGB8888;
+// Characters in the font atlas (printable ASCII)
+constexpr char first_glyph = ' ';
+constexpr char last_glyph = '~';
+constexpr std::size_t num_glyphs = last_glyph - first_glyph + 1;
+
+/** Position of a glyph in the font atlas */
+struct Glyph {
+  Uint16 x {0};
+  Uint16 y {0};
+  Uint16 w {0};
+  Uint16 h {0};
+  // Horizontal distance from the start of this glyph to the start of the next one
+  Uint16 advance {0};
+};
+
+/** Horizontal adjustment of a pair of characters (only the pairs that are not 0 are baked) */
+struct KerningPair {
+  char left {0};
+  char right {0};
+  Sint16 kerning {0};
+};
+
+/** Font atlas with white glyphs. The coverage is stored in the alpha channel */
+struct Font {
+  // Height of a line of text
+  int height {0};
+  std::array<Glyph, num_glyphs> glyphs {};
+  // Sorted by the left and then the right character
+  std::vector<KerningPair> kerning_pairs;
+  SDL_Surface_ptr atlas {nullptr, SDL_DestroySurface};
+
+  /**
+   * Get the glyph of a character
+   * @return A pointer to the glyph, or nullptr if the character is not in the atlas
+   */
+  [[nodiscard]] const Glyph* glyph(const char c) const {
+    if (c < first_glyph || c > last_glyph) {
+      return nullptr;
+    }
+    return &glyphs[static_cast<std::size_t>(c - first_glyph)];
+  }
+
+  /**
+   * Get the kerning between two characters, as applied by SDL_ttf when rendering a text
+   * @return The offset added to the advance of the left character
+   */
+  [[nodiscard]] int kerning(const char left, const char right) const {
+    const auto pair = std::ranges::lower_bound(kerning_pairs, std::pair {left, right}, {}, [](const KerningPair& p) {
+      return std::pair {p.left, p.right};
+    });
+    if (pair == kerning_pairs.end() || pair->left != left || pair->right != right) {
+      return 0;
+    }
+    return pair->kerning;
+  }
+};
+
+namespace detail {
+
+inline bool read_header(SDL_IOStream* io, Uint32& first, Uint32& second) {
+  Uint32 file_magic = 0;
+  Uint32 file_version = 0;
+  if (!SDL_ReadU32LE(io, &file_magic) || !SDL_ReadU32LE(io, &file_version) ||
+      !SDL_ReadU32LE(io, &first) || !SDL_ReadU32LE(io, &second)) {
+    return false;
+  }
+  if (file_magic != magic || file_version != version) {
+    SDL_Log("Baked asset with an unknown format (version %u)", file_version);
+    return false;
+  }
+  return true;
+}
+
+inline bool write_header(SDL_IOStream* io, const Uint32 first, const Uint32 second) {
+  return SDL_WriteU32LE(io, magic) && SDL_WriteU32LE(io, version) &&
+         SDL_WriteU32LE(io, first) && SDL_WriteU32LE(io, second);
+}
+
+} // namespace pika::baked::detail
+
+/**
+ * Read a baked image
+ * @param io The stream to read from (may be null). It is not closed
+ * @return The image in pixel_format, or nullptr if the stream does not contain a valid image
+ */
+inline SDL_Surface_ptr read_image(SDL_IOStream* io) {
+  SDL_Surface_ptr image {nullptr, SDL_DestroySurface};
+  Uint32 width = 0;
+  Uint32 height = 0;
+  if (io == nullptr || !detail::read_header(io, width, height)) {
+    return image;
+  }
+  image.reset(SDL_CreateSurface(static_cast<int>(width), static_cast<int>(height), pixel_format));
+  if (!image) {
+    return image;
+  }
+  // A single copy if the surface rows are not padded
+  const std::size_t row_size = static_cast<std::size_t>(width) * SDL_BYTESPERPIXEL(pixel_format);
+  const std::size_t rows = (static_cast<std::size_t>(image->pitch) == row_size) ? 1 : height;
+  const std::size_t read_size = (rows == 1) ? row_size * height : row_size;
+  for (std::size_t y = 0; y < rows; y++) {
+    auto* dst = static_cast<Uint8*>(image->pixels) + y * image->pitch;
+    if (SDL_ReadIO(io, dst, read_size) != read_size) {
+      image.reset();
+      break;
+    }
+  }
+  return image;
+}
+
+/**
+ * Write a baked image
+ * @param io The stream to write to. It is not closed
+ * @param surface The image, in any format
+ * @return True if the image was written
+ */
+inline bool write_image(SDL_IOStream* io, SDL_Surface* surface) {
+  const SDL_Surface_ptr image {SDL_ConvertSurface(surface, pixel_format), SDL_DestroySurface};
+  if (!image || !detail::write_header(io, static_cast<Uint32>(image->w), static_cast<Uint32>(image->h))) {
+    return false;
+  }
+  const std::size_t row_size = static_cast<std::size_t>(image->w) * SDL_BYTESPERPIXEL(pixel_format);
+  for (int y = 0; y < image->h; y++) {
+    const auto* row = static_cast<const Uint8*>(image->pixels) + static_cast<std::size_t>(y) * image->pitch;
+    if (SDL_WriteIO(io, row, row_size) != row_size) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Read a baked font atlas
+ * @param io The stream to read from (may be null). It is not closed
+ * @return The font, or nothing if the stream does not contain a valid font
+ */
+inline std::optional<Font> read_font(SDL_IOStream* io) {
+  Font font;
+  Uint32 height = 0;
+  Uint32 glyph_count = 0;
+  if (io == nullptr || !detail::read_header(io, height, glyph_count) || glyph_count != num_glyphs) {
+    return std::nullopt;
+  }
+  font.height = static_cast<int>(height);
+  for (auto& glyph : font.glyphs) {
+    if (!SDL_ReadU16LE(io, &glyph.x) || !SDL_ReadU16LE(io, &glyph.y) || !SDL_ReadU16LE(io, &glyph.w) ||
+        !SDL_ReadU16LE(io, &glyph.h) || !SDL_ReadU16LE(io, &glyph.advance)) {
+      return std::nullopt;
+    }
+  }
+  Uint32 pair_count = 0;
+  if (!SDL_ReadU32LE(io, &pair_count) || pair_count > num_glyphs * num_glyphs) {
+    return std::nullopt;
+  }
+  font.kerning_pairs.resize(pair_count);
+  for (auto& pair : font.kerning_pairs) {
+    Uint8 left = 0;
+    Uint8 right = 0;
+    if (!SDL_ReadU8(io, &left) || !SDL_ReadU8(io, &right) || !SDL_ReadS16LE(io, &pair.kerning)) {
+      return std::nullopt;
+    }
+    pair.left = static_cast<char>(left);
+    pair.right = static_cast<char>(right);
+  }
+  font.atlas = read_image(io);
+  if (!font.atlas) {
+    return std::nullopt;
+  }
+  return font;
+}
+
+/**
+ * Write a baked font atlas
+ * @param io The stream to write to. It is not closed
+ * @param font The font to write
+ * @return True if the font was written
+ */
+inline bool write_font(SDL_IOStream* io, const Font& font) {
+  if (!detail::write_header(io, static_cast<Uint32>(font.height), num_glyphs)) {
+    return false;
+  }
+  for (const auto& glyph : font.glyphs) {
+    if (!SDL_WriteU16LE(io, glyph.x) || !SDL_WriteU16LE(io, glyph.y) || !SDL_WriteU16LE(io, glyph.w) ||
+        !SDL_WriteU16LE(io, glyph.h) || !SDL_WriteU16LE(io, glyph.advance)) {
+      return false;
+    }
+  }
+  if (!SDL_WriteU32LE(io, static_cast<Uint32>(font.kerning_pairs.size()))) {
+    return false;
+  }
+  for (const auto& pair : font.kerning_pairs) {
+    if (!SDL_WriteU8(io, static_cast<Uint8>(pair.left)) || !SDL_WriteU8(io, static_cast<Uint8>(pair.right)) ||
+        !SDL_WriteS16LE(io, pair.kerning)) {
+      return false;
+    }
+  }
+  return write_image(io, font.atlas.get());
+}
+
+} // namespace pika::baked
+
+#endif // PIKA_BAKED_ASSETS_HPP
@@ -13,6 +13,9 @@ static constexpr char window_name [] = "PikaBall MLP Revamped";
 
 static constexpr unsigned long ns_per_second = 1000000000;
 
+// Size of the text font (also used to bake the font atlas)
+static constexpr unsigned int text_font_size = 45;
+
 
 // Options menu strings
 // TODO: Localization?
@@ -52,7 +52,8 @@ enum class VolleyGameState {
   StartRound,
   PlayRound,
   EndRound,
-  GameEnd
+  GameEnd,
+  Replay  // Instant replay of the last rally
 };
 
 } // namespace pika
@@ -0,0 +1,116 @@
+#ifndef PIKA_PERF_COUNTERS_HPP
+#define PIKA_PERF_COUNTERS_HPP
+
+#include <array>
+#include <cstddef>
+
+namespace pika {
+
+/** Hardware events measured by PerfCounters */
+enum class PerfEvent : std::size_t {
+  Cycles,
+  Instructions,
+  BranchMisses,
+  L1DMisses,   // L1 data cache read misses
+  LLCMisses,   // Last level cache misses
+};
+constexpr std::size_t num_perf_events = 5;
+constexpr std::array<const char*, num_perf_events> perf_event_names {
+  "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses"
+};
+
+/** Values of the hardware events. Events that the CPU (or the kernel) does not support are not available */
+struct PerfCounts {
+  std::array<double, num_perf_events> values {};
+  std::array<bool, num_perf_events> available {};
+
+  [[nodiscard]] bool has(const PerfEvent event) const { return available[static_cast<std::size_t>(event)]; }
+  [[nodiscard]] double operator[](const PerfEvent event) const { return values[static_cast<std::size_t>(event)]; }
+
+  /** Instructions per cycle (0 if not available) */
+  [[nodiscard]] double ipc() const {
+    if (!has(PerfEvent::Cycles) || !has(PerfEvent::Instructions) || (*this)[PerfEvent::Cycles] <= 0.0) {
+      return 0.0;
+    }
+    return (*this)[PerfEvent::Instructions] / (*this)[PerfEvent::Cycles];
+  }
+
+  /** Accumulate counts. An event stays available only if it is available in both */
+  PerfCounts& operator+=(const PerfCounts& other) {
+    for (std::size_t i = 0; i < num_perf_events; i++) {
+      values[i] += other.values[i];
+      available[i] = available[i] && other.available[i];
+    }
+    return *this;
+  }
+
+  /** Counts divided by a number of operations (e.g. per frame) */
+  [[nodiscard]] PerfCounts per(const double operations) const {
+    PerfCounts result = *this;
+    for (auto& value : result.values) {
+      value /= operations;
+    }
+    return result;
+  }
+};
+
+/**
+ * Hardware performance counters of the calling thread (user space only), read with perf_event_open.
+ * Only available on Linux, and only if the kernel allows it (see /proc/sys/kernel/perf_event_paranoid).
+ * In other platforms, or if the counters cannot be opened, is_available() is false and the counts are empty.
+ *
+ * The counters measure the thread that creates the object, so it must be used from that thread.
+ * All the events are opened as one group led by the cycles, so the kernel always schedules them
+ * together: if the group is multiplexed with other programs, all the counts cover the same time
+ * windows and are scaled by the same factor (the ratios, like the IPC, stay consistent).
+ */
+class PerfCounters {
+public:
+  PerfCounters();
+  ~PerfCounters();
+  PerfCounters(PerfCounters const&) = delete;
+  PerfCounters(PerfCounters &&) = delete;
+  PerfCounters &operator=(PerfCounters const&) = delete;
+  PerfCounters &operator=(PerfCounters &&) = delete;
+
+  /** True if at least the cycles can be counted */
+  [[nodiscard]] bool is_available() const { return leader() >= 0; }
+
+  /** Set the counters to zero */
+  void reset();
+
+  /** Start or resume counting. The counts accumulate until reset() */
+  void enable();
+
+  /** Pause counting */
+  void disable();
+
+  /** Read the counts since the last reset */
+  [[nodiscard]] PerfCounts read() const;
+
+  /** Reset the counters and start counting */
+  void start() {
+    reset();
+    enable();
+  }
+
+  /** Stop counting and read the counters */
+  [[nodiscard]] PerfCounts stop() {
+    disable();
+    return read();
+  }
+
+private:
+  // File descriptor of each event (-1 if it could not be opened). The cycles lead the group
+  std::array<int, num_perf_events> fds_ {};
+  // Events of the group in the order of their values in a group read
+  std::array<PerfEvent, num_perf_events> group_events_ {};
+  std::size_t group_size_ {0};
+
+  /** File descriptor of the group leader */
+  [[nodiscard]] int leader() const { return fds_[static_cast<std::size_t>(PerfEvent::Cycles)]; }
+};
+
+} // namespace pika
+
+#endif // PIKA_PERF_COUNTERS_HPP
@@ -2,29 +2,129 @@
 #define PIKA_BALL_HPP
 
 #include <array>
+#include <cstdint>
 
 #include <pikaball/input.hpp>
+#include <pikaball/random.hpp>
 #include "physics_common.hpp"
+#include "physics_events.hpp"
+#include "physics_rules.hpp"
 #include "player.hpp"
 
 namespace pika {
 
-enum class BallSound {
-  None,
-  Hit,
-  Ground
+/**
+ * Hot simulation state of the ball.
+ * The trajectory only depends on these fields, so the landing predictions
+ * copy this struct instead of the whole Ball object with its cosmetic state.
+ */
+struct BallState {
+  int x {56};  // 0x30, initialized to 56 (left) or 376 (right)
+  int y {0};   // 0x34
+  int velocity_x {0};  // 0x38
+  // y velocity is positive when going down (gravity)
+  int velocity_y {1};  // 0x3C
+};
+static_assert(sizeof(BallState) <= 64, "BallState must fit in a single cache line");
+
+/** Result of a landing point prediction */
+struct LandingPrediction {
+  // x coordinate of the landing point
+  int x {0};
+  // Number of frames until the ball touches the ground
+  int frames {0};
+  // False if the simulation was stopped by infinite_loop_limit before landing
+  bool landed {false};
+};
+
+/**
+ * Compact copy of the ball state that is needed to draw it (used by the instant replay).
+ */
+struct BallSnapshot {
+  std::int16_t x {0};
+  std::int16_t y {0};
+  std::int16_t punch_effect_x {0};
+  std::int16_t punch_effect_y {0};
+  std::array<std::int16_t, 2> trailing_x {};
+  std::array<std::int16_t, 2> trailing_y {};
+  std::uint8_t rotation {0};
+  std::uint8_t punch_effect_radius {0};
+  bool power_hit {false};
 };
 
-class Ball {
+/**
+ * Check if the ball is colliding with the net pillar (top or side) in the given state
+ * @param state The ball state
+ * @return true if the ball will bounce on the net in the next step
+ */
+[[nodiscard]] inline bool touches_net(const BallState& state) {
+  const auto net_distance = (state.x > ground_h_width) ? state.x - ground_h_width
+                                                       : ground_h_width - state.x;
+  return net_distance < net_pillar_h_width && state.y > net_top_top_y;
+}
+
+/**
+ * Move the ball one frame, processing the collisions with the world bounds and the net.
+ * Only the trajectory is simulated (no effects or sounds).
+ * Part of FUN_00402dc0 / processCollisionBetweenBallAndWorldAndSetBallPosition()
+ * @tparam Rules The physics rules policy (world bounds)
+ * @param state The ball state to update
+ * @param net_bounce Optional output, set to true if the net reflected the velocity of the ball
+ * @return true if the ball is touching the ground. In that case the position is not updated.
+ */
+template <PhysicsRules Rules = OriginalRules>
+bool step_trajectory(BallState& state, bool* net_bounce = nullptr);
+
+/**
+ * Simulate the future ball assuming no players until reaching the ground.
+ * FUN_004031b0
+ * @tparam Rules The physics rules policy (world bounds and loop limit)
+ * @param state The current ball state (the simulation runs on a copy)
+ * @return The landing point and the number of frames to reach it
+ */
+template <PhysicsRules Rules = OriginalRules>
+[[nodiscard]] LandingPrediction predict_landing(BallState state);
+
+extern template bool step_trajectory<OriginalRules>(BallState&, bool*);
+extern template bool step_trajectory<SymmetricRules>(BallState&, bool*);
+extern template LandingPrediction predict_landing<OriginalRules>(BallState);
+extern template LandingPrediction predict_landing<SymmetricRules>(BallState);
+
+/**
+ * Class representing the ball.
+ * @tparam Rules The physics rules policy (world bounds, loop limit and hit velocities)
+ */
+template <PhysicsRules Rules = OriginalRules>
+class BasicBall {
 public:
-  Ball() = default;
-  ~Ball() = default;
-  Ball(const Ball&) = default;
-  Ball& operator=(const Ball&) = default;
+  BasicBall() = default;
+  ~BasicBall() = default;
+  BasicBall(const BasicBall&) = default;
+  BasicBall& operator=(const BasicBall&) = default;
+
+  /**
+   * Copy a ball simulated with other rules (e.g. a headless simulation, to build a PhysicsView).
+   * @param other The ball to copy
+   */
+  template <PhysicsRules OtherRules>
+  explicit BasicBall(const BasicBall<OtherRules>& other) :
+    state_(other.state_),
+    expected_landing_x_(other.expected_landing_x_),
+    frames_until_landing_(other.frames_until_landing_),
+    landing_outdated_(other.landing_outdated_),
+    rotation_(other.rotation_),
+    fine_rotation_(other.fine_rotation_),
+    punch_effect_x_(other.punch_effect_x_),
+    punch_effect_y_(other.punch_effect_y_),
+    trailing_x_(other.trailing_x_),
+    trailing_y_(other.trailing_y_),
+    punch_effect_radius_(other.punch_effect_radius_),
+    power_hit_(other.power_hit_)
+  {}
 
   // Delete move operations
-  Ball(Ball&&) = delete;
-  Ball& operator=(Ball&&) = delete;
+  BasicBall(BasicBall&&) = delete;
+  BasicBall& operator=(BasicBall&&) = delete;
 
   /**
    * Initialize the ball for a new round (reset state)
@@ -35,9 +135,10 @@ public:
   /**
    * Process collision between the ball and the world and update the ball state
    * FUN_00402dc0 / processCollisionBetweenBallAndWorldAndSetBallPosition()
+   * @param events Queue to emit the ball events (ground, net bounce)
    * @return true if the ball is touching the ground
    */
-  bool update();
+  bool update(PhysicsEventQueue& events);
 
   /**
    * Calculate the x coordinate of the landing point.
@@ -46,13 +147,22 @@ public:
    */
   void calculate_landing_point();
 
+  /**
+   * Refresh the expected landing point only if the trajectory has changed.
+   * Between player hits the flight is deterministic, so the prediction made
+   * after the last trajectory change stays valid and only the remaining frames
+   * count down. It is recomputed after a new round, a ground bounce, a velocity
+   * change or when the last simulation was cut by infinite_loop_limit.
+   */
+  void update_landing_point();
+
   /**
    * Check if there is a collision between the ball and a player
    * FUN_00403070
    * @param player a reference to one of the players
    * @return true if the ball is touching the given player
    */
-  [[nodiscard]] bool collision_with_player(const Player& player) const;
+  [[nodiscard]] bool collision_with_player(const BasicPlayer<Rules>& player) const;
 
   /**
    * Process the collision between the ball and a player.
@@ -61,14 +171,29 @@ public:
    * FUN_004030a0 / processCollisionBetweenBallAndPlayer
    * @param player The player that is in contact with the ball.
    * @param input The input for the given player.
+   * @param events Queue to emit the ball hit event
+   * @param random Generator of the random direction of slow hits
    */
-  void process_player_hit(const Player& player, const PlayerInput& input);
+  void process_player_hit(const BasicPlayer<Rules>& player, const PlayerInput& input,
+                          PhysicsEventQueue& events, PhysicsRandom& random);
+
+  /** Get a compact copy of the state needed to draw the ball */
+  [[nodiscard]] BallSnapshot snapshot() const;
+
+  /**
+   * Restore the drawn state from a snapshot.
+   * Only the fields stored in the snapshot are set, so the ball can be rendered
+   * but must not be simulated afterwards.
+   * @param snapshot The snapshot to restore
+   */
+  void restore(const BallSnapshot& snapshot);
 
   // Getters
-  [[nodiscard]] auto x() const { return x_; }
-  [[nodiscard]] auto y() const { return y_; }
-  [[nodiscard]] auto velocity_x() const { return velocity_x_; }
-  [[nodiscard]] auto velocity_y() const { return velocity_y_; }
+  [[nodiscard]] const BallState& state() const { return state_; }
+  [[nodiscard]] auto x() const { return state_.x; }
+  [[nodiscard]] auto y() const { return state_.y; }
+  [[nodiscard]] auto velocity_x() const { return state_.velocity_x; }
+  [[nodiscard]] auto velocity_y() const { return state_.velocity_y; }
   [[nodiscard]] auto rotation() const { return rotation_; }
   [[nodiscard]] auto punch_effect_radius() const { return punch_effect_radius_; }
   [[nodiscard]] auto punch_effect_x() const { return punch_effect_x_; }
@@ -77,22 +202,35 @@ public:
   [[nodiscard]] auto trailing_x() const { return trailing_x_; }
   [[nodiscard]] auto trailing_y() const { return trailing_y_; }
   [[nodiscard]] auto expected_landing_x() const { return expected_landing_x_; }
-  [[nodiscard]] auto sound() const { return sound_; }
+  /** Number of update() calls left until the ball touches the ground (according to the prediction) */
+  [[nodiscard]] auto frames_until_landing() const { return frames_until_landing_; }
 
-  void set_velocity_x(const int vel_x) { velocity_x_ = vel_x; }
-  void set_velocity_y(const int vel_y) { velocity_y_ = vel_y; }
+  void set_velocity_x(const int vel_x) {
+    state_.velocity_x = vel_x;
+    landing_outdated_ = true;
+  }
+  void set_velocity_y(const int vel_y) {
+    state_.velocity_y = vel_y;
+    landing_outdated_ = true;
+  }
 
   void decrease_punch_effect_radius();
-  /** Resets the current sound state to avoid re-triggers */
-  void reset_sound();
 
 private:
+  template <PhysicsRules> friend class BasicBall;
+
+  /* Hot state: everything the simulation needs every frame */
+
   // Ball coordinates and velocities
-  int x_ {56};  // 0x30, initialized to 56 (left) or 376 (right)
-  int y_ {0};   // 0x34
-  int velocity_x_ {0};   // 0x38
-  // y velocity is positive when going down (gravity)
-  int velocity_y_ {1};   // 0x3C
+  BallState state_ {};
+  int expected_landing_x_ {0};   // 0x40
+  // Remaining frames of the current prediction (not in the original game)
+  int frames_until_landing_ {0};
+  // Set when the trajectory changed and the landing point must be predicted again
+  bool landing_outdated_ {true};
+
+  /* Cold state: effects and animations (only needed to draw the game) */
+
   /**
    * Ball rotation frame number selector (animation).
    * During the period where it continues to be 5, hyper ball glitch occur.
@@ -107,21 +245,39 @@ private:
   std::array<int, 2> trailing_x_ {0};  // 0x58, 0x5C
   std::array<int, 2> trailing_y_ {0};  // 0x60, 0x64
   int punch_effect_radius_ {0};  // 0x4C
-  int expected_landing_x_ {0};   // 0x40
   bool power_hit_ {false};                // 0x68
 
-  // Current sound state for the ball
-  BallSound sound_ {BallSound::None};
-
   /**
    * Part of the update() function (FUN_00402dc0) that only
    * checks collisions and updates the ball state (no rotation or trailing).
-   * This code has been isolated to be reused in calculate_landing_point()
+   * The trajectory is handled by step_trajectory(), which is shared with predict_landing().
+   * @param events Queue to emit the ball events (ground, net bounce)
    * @return true if the ball is touching the ground
    */
-  bool update_position();
+  bool update_position(PhysicsEventQueue& events);
+
+  /**
+   * Emit a ball event at the current position
+   * @param type The event type
+   * @param side The side of the field related to the event
+   * @param events The queue of events of the current update
+   */
+  void emit(PhysicsEventType type, FieldSide side, PhysicsEventQueue& events) const;
+
+  /** Side of the field where the ball is */
+  [[nodiscard]] FieldSide field_side() const {
+    return (state_.x < ground_h_width) ? FieldSide::Left : FieldSide::Right;
+  }
 };
 
+// The supported rules are compiled once in ball.cpp
+extern template class BasicBall<OriginalRules>;
+extern template class BasicBall<SymmetricRules>;
+extern template class BasicBall<HeadlessRules>;
+
+/** Ball with the rules of the original game */
+using Ball = BasicBall<OriginalRules>;
+
 } // namespace pika
 
 #endif // PIKA_BALL_HPP
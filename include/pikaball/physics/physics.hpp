@@ -2,13 +2,38 @@
 #define PIKA_PHYSICS_HPP
 
 #include "ball.hpp"
+#include "physics_events.hpp"
+#include "physics_rules.hpp"
 #include "pikaball/input.hpp"
 #include "player.hpp"
 
+#include <array>
+#include <cstdint>
 #include <memory>
 
 namespace pika {
 
+/**
+ * Compact copy of everything that is drawn on the volley field in one frame.
+ * Used to store the history of a rally for the instant replay.
+ */
+struct PhysicsSnapshot {
+  BallSnapshot ball {};
+  PlayerSnapshot player_left {};
+  PlayerSnapshot player_right {};
+};
+static_assert(sizeof(PhysicsSnapshot) <= 40, "PhysicsSnapshot should stay compact");
+
+/** Maximum number of objects subscribed to the events of a Physics object */
+constexpr std::size_t max_physics_listeners = 4;
+
+/**
+ * Physics engine: ball, players and the interactions between them.
+ * The rules policy is resolved at compile time, so every variant is fully
+ * specialized code. Physics<> (OriginalRules) is the original game.
+ * @tparam Rules The physics rules policy (e.g. OriginalRules or SymmetricRules)
+ */
+template <PhysicsRules Rules = OriginalRules>
 class Physics {
 public:
   // Utility typedef
@@ -32,10 +57,20 @@ public:
   /** Reset ball and players positions for a new game */
   void restart();
 
+  /**
+   * Seed the random choices of the simulation (the direction of slow ball hits).
+   * Objects seeded with the same value and updated with the same inputs simulate the same game.
+   * By default the generator is seeded randomly.
+   * @param seed The seed of the generator
+   */
+  void seed(std::uint32_t seed);
+
   /**
    * Update the world state based on the user input.
    * If any of the players is controlled by the computer, its input is ignored
    * and its commands are computed by function TODO: XXXX.
+   * The events emitted during the update are sent to the listeners at the end,
+   * and they can be read with events() until the next update.
    * FUN_00403dd0 / physicsEngine
    * @param input_left Input for the left player.
    * @param input_right Input for the right player.
@@ -49,35 +84,82 @@ public:
    */
   void end_game(const FieldSide& field_side);
 
-  /** Reset sounds of players and ball after an iteration */
-  void reset_sound();
+  /**
+   * Subscribe a listener to the physics events.
+   * @param listener Non-owning pointer to the listener. It must outlive this object or unsubscribe.
+   * @return false if the maximum number of listeners was reached
+   */
+  bool subscribe(PhysicsEventListener* listener);
+
+  /**
+   * Remove a listener from the physics events
+   * @param listener The listener to remove
+   */
+  void unsubscribe(const PhysicsEventListener* listener);
+
+  /** Events emitted during the last update (oldest first) */
+  [[nodiscard]] const PhysicsEventQueue& events() const { return events_; }
+
+  /** Get a compact copy of the drawn state of the ball and players */
+  [[nodiscard]] PhysicsSnapshot capture() const;
+
+  /**
+   * Restore the drawn state of the ball and players from a snapshot.
+   * Meant for a Physics object that is only rendered (e.g. instant replay),
+   * the restored state must not be simulated.
+   * @param snapshot The snapshot to restore
+   */
+  void restore(const PhysicsSnapshot& snapshot);
 
-  [[nodiscard]] const Ball& ball() const { return ball_; }
-  [[nodiscard]] const Player& player(const FieldSide& side) const;
+  [[nodiscard]] const BasicBall<Rules>& ball() const { return ball_; }
+  [[nodiscard]] const BasicPlayer<Rules>& player(const FieldSide& side) const;
 private:
-  Player player_left_;
-  Player player_right_;
-  Ball ball_ {};
+  BasicPlayer<Rules> player_left_;
+  BasicPlayer<Rules> player_right_;
+  BasicBall<Rules> ball_ {};
+
+  // Events of the current update and the objects subscribed to them (not owned)
+  PhysicsEventQueue events_ {};
+  std::array<PhysicsEventListener*, max_physics_listeners> listeners_ {};
+  // True until the ball touches the ground in the current round (to emit a single Score event)
+  bool round_active_ {true};
+  // Random choices of the simulation
+  PhysicsRandom random_;
 
   /**
    * Check and process collisions between the ball and a player
    * @param player a reference to one of the players
    * @param input the input for the given player
    */
-  void collision_ball_player(Player& player, const PlayerInput& input);
+  void collision_ball_player(BasicPlayer<Rules>& player, const PlayerInput& input);
+
+  /** Send the events of the current update to the listeners */
+  void dispatch_events() const;
 
 };
 
+// The supported rules are compiled once in physics.cpp
+extern template class Physics<OriginalRules>;
+extern template class Physics<SymmetricRules>;
+extern template class Physics<HeadlessRules>;
+
 /**
  * A simple interface to the Physics object to be used by the controllers.
  * This prevents the Controller from casting const away
  * from the Physics object and doing nasty stuff
  *
  * The Object holds a const copy to the Ball and Player objects.
+ * Controllers play with the original rules (Physics<>), or with a headless
+ * simulation of the same gameplay (Physics<HeadlessRules>).
  */
 class PhysicsView {
 public:
-  explicit PhysicsView(const Physics& physics) :
+  explicit PhysicsView(const Physics<>& physics) :
+    ball(physics.ball()),
+    player_left(physics.player(FieldSide::Left)),
+    player_right(physics.player(FieldSide::Right))
+  {}
+  explicit PhysicsView(const Physics<HeadlessRules>& physics) :
     ball(physics.ball()),
     player_left(physics.player(FieldSide::Left)),
     player_right(physics.player(FieldSide::Right))
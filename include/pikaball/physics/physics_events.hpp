@@ -0,0 +1,69 @@
+/**
+* This file contains the events emitted by the physics engine
+*/
+#ifndef PIKA_PHYSICS_EVENTS_HPP
+#define PIKA_PHYSICS_EVENTS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pikaball/ring_buffer.hpp>
+#include "physics_common.hpp"
+
+namespace pika {
+
+/** Types of events emitted during a physics update */
+enum class PhysicsEventType : std::uint8_t {
+  Jump,        // A player jumps
+  Dive,        // A player dives
+  PowerHit,    // A player starts a power hit (jumping)
+  BallHit,     // The ball collides with a player
+  BallGround,  // The ball touches the ground
+  NetBounce,   // The ball bounces on the net
+  Win,         // A player starts the winner animation at the end of the game
+  Score,       // The ball touched the ground for the first time in the round
+};
+
+/** An event emitted by the physics engine */
+struct PhysicsEvent {
+  PhysicsEventType type {PhysicsEventType::Jump};
+  /**
+   * Side of the player that caused the event (Jump, Dive, PowerHit, BallHit, Win),
+   * the side of the field where the ball is (BallGround, NetBounce)
+   * or the side that scored the point (Score).
+   */
+  FieldSide side {FieldSide::Left};
+  // Position of the player or the ball when the event happened
+  int x {0};
+  int y {0};
+  // True if the ball was power hit (only used by BallHit)
+  bool power_hit {false};
+};
+
+/** Maximum number of events that can be emitted in a single physics update */
+constexpr std::size_t max_physics_events_per_tick = 16;
+
+/**
+ * Events emitted during the last physics update.
+ * Preallocated, so emitting events never allocates.
+ */
+using PhysicsEventQueue = RingBuffer<PhysicsEvent, max_physics_events_per_tick>;
+
+/**
+ * Interface for the objects that subscribe to the physics events (sound, stats, network...).
+ * Listeners are notified at the end of each physics update, in the order the events happened.
+ */
+class PhysicsEventListener {
+public:
+  virtual ~PhysicsEventListener() = default;
+
+  /**
+   * Called once for every event emitted by the physics engine
+   * @param event The physics event
+   */
+  virtual void on_physics_event(const PhysicsEvent& event) = 0;
+};
+
+} // namespace pika
+
+#endif // PIKA_PHYSICS_EVENTS_HPP
@@ -0,0 +1,78 @@
+/**
+* This file contains the compile-time rules policies used to build variants of the physics engine
+*/
+#ifndef PIKA_PHYSICS_RULES_HPP
+#define PIKA_PHYSICS_RULES_HPP
+
+#include <concepts>
+
+#include "physics_common.hpp"
+
+namespace pika {
+
+/**
+ * Rules of the original game.
+ * All the values are the same as the original machine code, including the
+ * asymmetric ball bounds (see step_trajectory()).
+ */
+struct OriginalRules {
+  /** Ball bounces back from the left wall if its next x is lower than this value */
+  static constexpr int ball_min_x = ball_radius;
+  /** Ball bounces back from the right wall if its next x is greater than this value */
+  static constexpr int ball_max_x = ground_width;
+  /** Limit of simulation steps in the landing point predictions */
+  static constexpr unsigned int infinite_loop_limit = pika::infinite_loop_limit;
+  /** Player x velocity when walking or jumping */
+  static constexpr int player_velocity_x = 6;
+  /** Player x velocity when diving */
+  static constexpr int dive_velocity_x = 8;
+  /** Initial player y velocity when jumping */
+  static constexpr int jump_velocity_y = -16;
+  /** Ball x velocity after a power hit with a direction pressed (halved without direction) */
+  static constexpr int power_hit_velocity_x = 20;
+  /**
+   * Simulate the state that is only needed to draw the game: ball rotation, trailing and
+   * punch effect radius, and the player animation frames that do not affect the gameplay
+   */
+  static constexpr bool simulate_cosmetics = true;
+};
+
+/**
+ * Original rules with left-right symmetric ball bounds.
+ * The right wall is moved by the ball radius, so both walls bounce the ball when
+ * its edge touches them. With these bounds some power hit predictions never land,
+ * so they rely on infinite_loop_limit to terminate.
+ */
+struct SymmetricRules : OriginalRules {
+  static constexpr int ball_max_x = ground_width - ball_radius;
+};
+
+/**
+ * Original rules without the cosmetic state, for headless / batch simulations that never
+ * render the game. The gameplay (positions, velocities, states, events and scoring) is the
+ * same as OriginalRules.
+ */
+struct HeadlessRules : OriginalRules {
+  static constexpr bool simulate_cosmetics = false;
+};
+
+/** Requirements for a physics rules policy */
+template <typename T>
+concept PhysicsRules = requires {
+  { T::ball_min_x } -> std::convertible_to<int>;
+  { T::ball_max_x } -> std::convertible_to<int>;
+  { T::infinite_loop_limit } -> std::convertible_to<unsigned int>;
+  { T::player_velocity_x } -> std::convertible_to<int>;
+  { T::dive_velocity_x } -> std::convertible_to<int>;
+  { T::jump_velocity_y } -> std::convertible_to<int>;
+  { T::power_hit_velocity_x } -> std::convertible_to<int>;
+  { T::simulate_cosmetics } -> std::convertible_to<bool>;
+};
+
+static_assert(PhysicsRules<OriginalRules>);
+static_assert(PhysicsRules<SymmetricRules>);
+static_assert(PhysicsRules<HeadlessRules>);
+
+} // namespace pika
+
+#endif // PIKA_PHYSICS_RULES_HPP
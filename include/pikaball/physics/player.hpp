@@ -2,26 +2,25 @@
 #define PIKA_PLAYER_HPP
 
 #include "physics_common.hpp"
+#include "physics_events.hpp"
+#include "physics_rules.hpp"
+#include "player_animations.hpp"
 
+#include <cstdint>
 #include <pikaball/input.hpp>
 
 namespace pika {
 
-enum class PlayerState {
-  Normal,
-  Jumping,
-  PowerHit,  // Jumping and power-hitting
-  Diving,
-  AfterDiving,  // Lay down on the ground after a dive
-  Winner,
-  Loser
-};
-
-enum class PlayerSound {
-  None,
-  Pika,
-  Chu,
-  Pipikachu
+/**
+ * Compact copy of the player state that is needed to draw it (used by the instant replay).
+ * The side of the field is not stored because it never changes.
+ */
+struct PlayerSnapshot {
+  std::int16_t x {0};
+  std::int16_t y {0};
+  std::uint8_t state {0};  // PlayerState
+  std::int8_t diving_direction {0};  // DirX
+  std::uint8_t anim_frame_number {0};
 };
 
 /**
@@ -34,17 +33,41 @@ enum class PlayerSound {
  * e.g. address to player2.isComputer: 00411F28 -> +28 -> +10 -> +10 -> +A4
  *
  * For initial values: refer to FUN_000403a90 && FUN_00401f40
+ *
+ * @tparam Rules The physics rules policy (velocities of the player)
  */
-class Player {
+template <PhysicsRules Rules = OriginalRules>
+class BasicPlayer {
 public:
-  explicit Player(const FieldSide& field_side);
-  ~Player() = default;
-  Player(const Player&) = default;
-  Player& operator=(const Player&) = default;
+  explicit BasicPlayer(const FieldSide& field_side);
+  ~BasicPlayer() = default;
+  BasicPlayer(const BasicPlayer&) = default;
+  BasicPlayer& operator=(const BasicPlayer&) = default;
+
+  /**
+   * Copy a player simulated with other rules (e.g. a headless simulation, to build a PhysicsView).
+   * @param other The player to copy
+   */
+  template <PhysicsRules OtherRules>
+  explicit BasicPlayer(const BasicPlayer<OtherRules>& other) :
+    collision_with_ball(other.collision_with_ball),
+    x_(other.x_),
+    y_(other.y_),
+    velocity_y_(other.velocity_y_),
+    lying_down_timer_(other.lying_down_timer_),
+    field_side_(other.field_side_),
+    state_(other.state_),
+    diving_direction_(other.diving_direction_),
+    is_winner_(other.is_winner_),
+    game_ended_(other.game_ended_),
+    anim_frame_number_(other.anim_frame_number_),
+    anim_arm_direction_(other.anim_arm_direction_),
+    anim_frame_delay_(other.anim_frame_delay_)
+  {}
 
   // Delete move operations
-  Player(Player&&) = delete;
-  Player& operator=(Player&&) = delete;
+  BasicPlayer(BasicPlayer&&) = delete;
+  BasicPlayer& operator=(BasicPlayer&&) = delete;
 
   /** Initialize the player for a new game (reset state) */
   void initialize_game();
@@ -58,13 +81,22 @@ public:
    * Update player state according to user input.
    * FUN_00401fc0
    * @param input The player's input
+   * @param events Queue to emit the player events (jump, dive, power hit, win)
    */
-  void update(const PlayerInput& input);
+  void update(const PlayerInput& input, PhysicsEventQueue& events);
 
   void end_game(bool is_winner);
 
-  /** Resets the current sound state to avoid re-triggers */
-  void reset_sound();
+  /** Get a compact copy of the state needed to draw the player */
+  [[nodiscard]] PlayerSnapshot snapshot() const;
+
+  /**
+   * Restore the drawn state from a snapshot.
+   * Only the fields stored in the snapshot are set, so the player can be rendered
+   * but must not be simulated afterwards.
+   * @param snapshot The snapshot to restore
+   */
+  void restore(const PlayerSnapshot& snapshot);
 
   // Getters
   [[nodiscard]] auto x() const { return x_; }
@@ -73,25 +105,21 @@ public:
   [[nodiscard]] auto side() const { return field_side_; }
   [[nodiscard]] auto diving_direction() const { return diving_direction_; }
   [[nodiscard]] auto anim_frame_number() const { return anim_frame_number_; }
-  [[nodiscard]] auto sound() const { return sound_; }
 
   // Flag to remember if the ball was already touched
   bool collision_with_ball {false};  // 0xBC
 
 private:
+  template <PhysicsRules> friend class BasicPlayer;
+
+  /* Hot state: everything the simulation needs every frame */
+
   // Player coordinates
   int x_ {36};               // 0xA8, initialized to 36 (left) or 396 (right)
   int y_ {player_ground_y};  // 0xAC
   // y velocity is positive when going down (gravity)
   int velocity_y_ {0};                // 0xB0
 
-  // Current animation frame number
-  int anim_frame_number_ {0};  // 0xC4
-  // Arm swinging direction in the normal mode animation
-  int anim_arm_direction_ {1};  // 0xC8
-  // Delay before switching to the next frame in the animation sequence.
-  int anim_frame_delay_ {0};    // 0xCC
-
   // Remaining time for the player to lay on the ground after diving
   int lying_down_timer_ = {-1};  // 0xB8
 
@@ -99,15 +127,40 @@ private:
   FieldSide field_side_ {FieldSide::Left};
 
   PlayerState state_ {PlayerState::Normal};  // 0xC0 (the state is an integer in the OG game).
-  // Current sound state for this player
-  PlayerSound sound_ {PlayerSound::None};
   // Diving direction. Possible values: -1 (left), 0 (no diving), 1 (right)
   DirX diving_direction_ {DirX::None};     // 0xB4
 
   bool is_winner_ {false};    // 0xD0
   bool game_ended_ {false};   // 0xD0
+
+  /*
+   * Cold state: animations.
+   * Only the power hit frames are used by the simulation (see update()).
+   */
+
+  // Current animation frame number
+  int anim_frame_number_ {0};  // 0xC4
+  // Arm swinging direction in the normal mode animation (PingPong direction)
+  int anim_arm_direction_ {1};  // 0xC8
+  // Delay before switching to the next frame in the animation sequence (see advance_animation()).
+  int anim_frame_delay_ {0};    // 0xCC
+
+  /**
+   * Emit a player event at the current position
+   * @param type The event type
+   * @param events The queue of events of the current update
+   */
+  void emit(PhysicsEventType type, PhysicsEventQueue& events) const;
 };
 
+// The supported rules are compiled once in player.cpp
+extern template class BasicPlayer<OriginalRules>;
+extern template class BasicPlayer<SymmetricRules>;
+extern template class BasicPlayer<HeadlessRules>;
+
+/** Player with the rules of the original game */
+using Player = BasicPlayer<OriginalRules>;
+
 } // namespace pika
 
 #endif // PIKA_PLAYER_HPP
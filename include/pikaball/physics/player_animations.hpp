@@ -0,0 +1,137 @@
+#ifndef PIKA_PLAYER_ANIMATIONS_HPP
+#define PIKA_PLAYER_ANIMATIONS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pika {
+
+enum class PlayerState {
+  Normal,
+  Jumping,
+  PowerHit,  // Jumping and power-hitting
+  Diving,
+  AfterDiving,  // Lay down on the ground after a dive
+  Winner,
+  Loser
+};
+
+constexpr std::size_t num_player_states = 7;
+// Longest animation (the sprite tables of the views have this number of frames for every state)
+constexpr std::size_t max_animation_frames = 5;
+
+/** Index of a player state in the animation tables */
+constexpr std::size_t state_index(const PlayerState state) {
+  return static_cast<std::size_t>(state);
+}
+
+/** How the frame number of an animation advances */
+enum class AnimationMode : std::uint8_t {
+  Static,    // Always the first frame
+  Loop,      // Next frame every tick, back to the first one after the last
+  PingPong,  // Next frame every frame_ticks ticks, reversing the direction at both ends
+  Once,      // Next frame every frame_ticks ticks, stopping at the last one
+  Sequence,  // Hold the first frame for hold_ticks ticks, then next frame every tick and go to next_state
+};
+
+/** Description of the animation of a player state */
+struct PlayerAnimation {
+  std::uint8_t frames {1};
+  AnimationMode mode {AnimationMode::Static};
+  // Ticks each frame is shown (PingPong and Once)
+  std::uint8_t frame_ticks {1};
+  // Ticks the first frame is held when the state is entered (Sequence)
+  std::uint8_t hold_ticks {0};
+  // State after the last frame (Sequence)
+  PlayerState next_state {PlayerState::Normal};
+};
+
+/**
+ * Animation of each player state, indexed by state_index().
+ * Same timings as the OG game: the physics advance the frame counters with them (see
+ * advance_animation()), and the views pick the sprite of the frame from their own tables.
+ */
+constexpr std::array<PlayerAnimation, num_player_states> player_animations = [] {
+  std::array<PlayerAnimation, num_player_states> table {};
+  table[state_index(PlayerState::Normal)] = {.frames = 5, .mode = AnimationMode::PingPong, .frame_ticks = 4};
+  table[state_index(PlayerState::Jumping)] = {.frames = 3, .mode = AnimationMode::Loop};
+  table[state_index(PlayerState::PowerHit)] = {
+    .frames = 5, .mode = AnimationMode::Sequence, .hold_ticks = 5, .next_state = PlayerState::Jumping};
+  table[state_index(PlayerState::Diving)] = {.frames = 1, .mode = AnimationMode::Static};
+  table[state_index(PlayerState::AfterDiving)] = {.frames = 1, .mode = AnimationMode::Static};
+  table[state_index(PlayerState::Winner)] = {.frames = 5, .mode = AnimationMode::Once, .frame_ticks = 5};
+  table[state_index(PlayerState::Loser)] = {.frames = 5, .mode = AnimationMode::Once, .frame_ticks = 5};
+  return table;
+}();
+
+/** Get the animation of a player state */
+constexpr const PlayerAnimation& player_animation(const PlayerState state) {
+  return player_animations[state_index(state)];
+}
+
+static_assert([] {
+  for (const PlayerAnimation& animation : player_animations) {
+    if (animation.frames < 1 || animation.frames > max_animation_frames || animation.frame_ticks < 1) {
+      return false;
+    }
+  }
+  return true;
+}(), "Invalid player animation table");
+
+/**
+ * Advance the frame counters of an animation by one tick
+ * @param state The current state (the animation to advance)
+ * @param frame Current frame number
+ * @param delay Ticks counter of the current frame
+ * @param direction Direction of the PingPong animations (1 or -1)
+ * @return The state after this tick (next_state when a Sequence ends, the same state otherwise)
+ */
+constexpr PlayerState advance_animation(const PlayerState state, int& frame, int& delay, int& direction) {
+  const PlayerAnimation& animation = player_animation(state);
+  const int last_frame = animation.frames - 1;
+  switch (animation.mode) {
+  case AnimationMode::Static:
+    break;
+  case AnimationMode::Loop:
+    frame = (frame + 1) % animation.frames;
+    break;
+  case AnimationMode::PingPong:
+    delay++;
+    if (delay >= animation.frame_ticks) {
+      delay = 0;
+      if (const int next_frame = frame + direction; next_frame < 0 || next_frame > last_frame) {
+        direction = -direction;
+      }
+      frame += direction;
+    }
+    break;
+  case AnimationMode::Once:
+    if (frame < last_frame) {
+      delay++;
+      if (delay >= animation.frame_ticks) {
+        delay = 0;
+        frame++;
+      }
+    }
+    break;
+  case AnimationMode::Sequence:
+    // The delay counts down the ticks left of the hold
+    if (delay < 1) {
+      frame++;
+      if (frame > last_frame) {
+        frame = 0;
+        return animation.next_state;
+      }
+    }
+    else {
+      delay--;
+    }
+    break;
+  }
+  return state;
+}
+
+} // namespace pika
+
+#endif // PIKA_PLAYER_ANIMATIONS_HPP
@@ -0,0 +1,170 @@
+#ifndef PIKA_TRAJECTORY_BATCH_HPP
+#define PIKA_TRAJECTORY_BATCH_HPP
+
+#include <array>
+#include <cstddef>
+
+#include "ball.hpp"
+#include "physics_common.hpp"
+#include "physics_rules.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+// GCC / Clang vector extensions are available for the multi-lane kernel
+#define PIKA_HAS_LANE_VECTOR 1
+#endif
+
+namespace pika {
+
+namespace detail {
+
+/** Number of trajectories simulated by each SIMD vector (one AVX2 or SSE2 / NEON register) */
+#ifdef __AVX2__
+constexpr std::size_t trajectory_lanes = 8;
+#else
+constexpr std::size_t trajectory_lanes = 4;
+#endif
+
+#ifdef PIKA_HAS_LANE_VECTOR
+// GCC / Clang vector extension: trajectory_lanes x int32
+using LaneVector = int __attribute__((vector_size(trajectory_lanes * sizeof(int))));
+#endif
+
+} // namespace pika::detail
+
+/**
+ * Simulate several ball trajectories at once until all of them touch the ground.
+ *
+ * This is the multi-lane version of predict_landing(). The states are stored as a
+ * structure of arrays of SIMD vectors (4 or 8 trajectories per vector) and every
+ * simulation step is computed for all the trajectories with branch-free masks.
+ * The landing point of each lane is latched when it touches the ground, and the loop
+ * runs until the slowest one finishes, so the cost is roughly the one of the longest trajectory.
+ * Compilers without vector extensions fall back to predict_landing() for each state.
+ * It only pays off when every trajectory is needed: a search that can stop at the first good
+ * trajectory (like the power hit of the computer) is faster with predict_landing() one by one.
+ *
+ * The results are exactly the same as calling predict_landing() for each state.
+ * @tparam K Number of trajectories to simulate
+ * @tparam Rules The physics rules policy (world bounds and loop limit)
+ * @param states The initial ball states (one per trajectory)
+ * @return The landing prediction for each trajectory, in the same order
+ */
+template <std::size_t K, PhysicsRules Rules = OriginalRules>
+[[nodiscard]] std::array<LandingPrediction, K> predict_landings(const std::array<BallState, K>& states) {
+  std::array<LandingPrediction, K> predictions {};
+
+#ifdef PIKA_HAS_LANE_VECTOR
+  using V = detail::LaneVector;
+  constexpr std::size_t lanes = detail::trajectory_lanes;
+  constexpr std::size_t groups = (K + lanes - 1) / lanes;
+
+  std::array<V, groups> x {}, y {}, velocity_x {}, velocity_y {};
+  // Landing point and frame count, recorded when each lane touches the ground
+  std::array<V, groups> landing_x {}, landing_frames {};
+  // Lane masks are -1 (true) or 0 (false). Unused lanes start already landed.
+  std::array<V, groups> landed {};
+  for (std::size_t i = 0; i < groups * lanes; i++) {
+    if (i < K) {
+      x[i / lanes][i % lanes] = states[i].x;
+      y[i / lanes][i % lanes] = states[i].y;
+      velocity_x[i / lanes][i % lanes] = states[i].velocity_x;
+      velocity_y[i / lanes][i % lanes] = states[i].velocity_y;
+    }
+    else {
+      landed[i / lanes][i % lanes] = -1;
+    }
+  }
+  // Branch-free helpers. Masks are -1 (true) or 0 (false) in each lane.
+  // select: mask ? a : b
+  const auto select = [](const V mask, const V a, const V b) -> V {
+    return (a & mask) | (b & ~mask);
+  };
+  // negate_if: mask ? -v : v
+  const auto negate_if = [](const V mask, const V v) -> V {
+    return (v ^ mask) - mask;
+  };
+
+  // Same logic as step_trajectory(), for all the lanes at the same time.
+  // Lanes keep moving after landing (the values are discarded), which is cheaper
+  // than masking every update. Only the landing point is latched.
+  constexpr unsigned int termination_check_interval = 4;
+  unsigned int step = 0;
+  while (step < Rules::infinite_loop_limit) {
+    step++;
+    for (std::size_t g = 0; g < groups; g++) {
+      const V bx = x[g];
+      const V by = y[g];
+
+      // Bounce on the world bounds
+      const V next_x = bx + velocity_x[g];
+      V vx = negate_if((next_x < Rules::ball_min_x) | (next_x > Rules::ball_max_x), velocity_x[g]);
+
+      // Bounce on the ceiling
+      V vy = select(by + velocity_y[g] < 0, V {} + 1, velocity_y[g]);
+
+      // Collisions with the net
+      const V net_offset = bx - ground_h_width;
+      const V left_side = net_offset < 0;
+      const V net_distance = negate_if(left_side, net_offset);
+      const V net = (net_distance < net_pillar_h_width) & (by > net_top_top_y);
+      const V net_top = net & (by <= net_top_bottom_y);
+      const V net_side = net & ~net_top;
+      vy = negate_if(net_top & (vy > 0), vy);
+      // Side collision: -abs(vx) on the left side, abs(vx) on the right side
+      const V abs_vx = negate_if(vx < 0, vx);
+      vx = select(net_side, negate_if(left_side, abs_vx), vx);
+
+      // Ground collision or free movement
+      const V ground = (by + vy) > ball_ground_y;
+      x[g] = bx + (vx & ~ground);
+      y[g] = select(ground, V {} + ball_ground_y, by + vy);
+      velocity_x[g] = vx;
+      velocity_y[g] = select(ground, -vy, vy + 1);
+
+      // Latch the result of the lanes that land in this step
+      const V new_landing = ground & ~landed[g];
+      landing_x[g] = select(new_landing, bx, landing_x[g]);
+      landing_frames[g] = select(new_landing, V {} + static_cast<int>(step), landing_frames[g]);
+      landed[g] |= ground;
+    }
+
+    // Check if all the trajectories finished. Landed results are latched, so the
+    // check only runs every few steps to keep the loop free of lane extractions.
+    if (step % termination_check_interval != 0 && step < Rules::infinite_loop_limit) {
+      continue;
+    }
+    V all_landed = landed[0];
+    for (std::size_t g = 1; g < groups; g++) {
+      all_landed &= landed[g];
+    }
+    bool done = true;
+    for (std::size_t i = 0; i < lanes; i++) {
+      done = done && all_landed[i] != 0;
+    }
+    if (done) {
+      break;
+    }
+  }
+
+  for (std::size_t i = 0; i < K; i++) {
+    const std::size_t g = i / lanes;
+    const std::size_t lane = i % lanes;
+    if (landing_frames[g][lane] != 0) {
+      predictions[i] = {landing_x[g][lane], landing_frames[g][lane], true};
+    }
+    else {
+      // Stopped by the loop limit
+      predictions[i] = {x[g][lane], static_cast<int>(step), false};
+    }
+  }
+#else
+  for (std::size_t i = 0; i < K; i++) {
+    predictions[i] = predict_landing<Rules>(states[i]);
+  }
+#endif
+  return predictions;
+}
+
+} // namespace pika
+
+#endif // PIKA_TRAJECTORY_BATCH_HPP
@@ -0,0 +1,76 @@
+#ifndef PIKA_QUALITY_GOVERNOR_HPP
+#define PIKA_QUALITY_GOVERNOR_HPP
+
+#include <cstdint>
+
+namespace pika {
+
+/**
+ * Chooses a quality level from the measured render time of each frame and a time budget.
+ *
+ * Level 0 is the full quality; each level above drops something more. When the smoothed render
+ * time stays near the budget for a few frames, the level goes up one step. It only goes down when
+ * there has been plenty of headroom for a long time, so the quality does not oscillate.
+ * It only decides the level: what each level drops is up to the view.
+ */
+class QualityGovernor {
+public:
+  /** @param max_level Highest (lowest quality) level */
+  explicit QualityGovernor(const int max_level) : max_level_(max_level) {}
+
+  /**
+   * Add the render time of a frame and update the level
+   * @param render_time Render time of the frame (ns)
+   * @param budget Time available for rendering a frame (ns)
+   * @return True if the level changed
+   */
+  bool update(const std::uint64_t render_time, const std::uint64_t budget) {
+    average_ += (static_cast<double>(render_time) - average_) * smoothing_;
+    const double load = average_ / static_cast<double>(budget);
+
+    over_budget_frames_ = (load > high_load_) ? over_budget_frames_ + 1 : 0;
+    headroom_frames_ = (load < low_load_) ? headroom_frames_ + 1 : 0;
+    if (over_budget_frames_ >= degrade_frames_ && level_ < max_level_) {
+      change_level(level_ + 1);
+      return true;
+    }
+    if (headroom_frames_ >= restore_frames_ && level_ > 0) {
+      change_level(level_ - 1);
+      return true;
+    }
+    return false;
+  }
+
+  [[nodiscard]] int level() const { return level_; }
+
+  /** Smoothed render time (ns) */
+  [[nodiscard]] double average_render_time() const { return average_; }
+
+private:
+  // Weight of each new frame in the smoothed render time
+  constexpr static double smoothing_ {0.2};
+  // Fractions of the budget that trigger a change
+  constexpr static double high_load_ {0.9};
+  constexpr static double low_load_ {0.5};
+  // Consecutive frames needed to lower the quality (fast, but enough for the smoothed time to settle)
+  // and to restore it (slow, 5 seconds at 25 FPS)
+  constexpr static unsigned int degrade_frames_ {10};
+  constexpr static unsigned int restore_frames_ {125};
+
+  int max_level_;
+  int level_ {0};
+  double average_ {0.0};
+  unsigned int over_budget_frames_ {0};
+  unsigned int headroom_frames_ {0};
+
+  void change_level(const int level) {
+    level_ = level;
+    // The effect of the new level must be measured again before changing it again
+    over_budget_frames_ = 0;
+    headroom_frames_ = 0;
+  }
+};
+
+} // namespace pika
+
+#endif // PIKA_QUALITY_GOVERNOR_HPP
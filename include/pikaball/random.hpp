@@ -11,14 +11,21 @@ namespace pika {
  * The machine code of the original game use "_rand()" function in Visual Studio 1988 Library.
  * This version generates the random numbers from a uniform distribution using the STL.
  * Actual implementation is delegated to the compiler.
+ * Each thread has its own generator, so the controllers can run in parallel.
  */
 inline uint16_t rand_int() {
-   static std::random_device rd;
-   static std::mt19937 gen(rd());
-   static std::uniform_int_distribution<uint16_t> dist(0, 32767);
+   thread_local std::mt19937 gen(std::random_device{}());
+   thread_local std::uniform_int_distribution<uint16_t> dist(0, 32767);
    return dist(gen);
 }
 
+/**
+ * Seedable generator of the random choices of the physics.
+ * Each Physics object owns one, so a game can be simulated again from its seed and
+ * the inputs of the players (see Physics::seed()).
+ */
+using PhysicsRandom = std::minstd_rand;
+
 } // namespace pika
 
 #endif // PIKA_RANDOM_HPP
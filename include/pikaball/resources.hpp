@@ -2,7 +2,11 @@
 #define PIKA_RESOURCES_HPP
 
 #include <array>
+#include <memory>
+#include <string>
 #include "battery/pika_embed.hpp"
+#include "pikaball/asset_pack.hpp"
+#include "pikaball/common.hpp"
 
 namespace pika {
 
@@ -17,12 +21,25 @@ static constexpr char sound_pipikachu_filename [] = "assets/sounds/pipikachu.wav
 static constexpr char sound_ball_hit_filename [] = "assets/sounds/ball_hit.wav";
 static constexpr char sound_ball_ground_filename [] = "assets/sounds/ball_ground.wav";
 static constexpr char text_font_filename [] = "assets/font.ttf";
-
-static constexpr unsigned int text_font_size = 45;
+// Pre-baked assets (only embedded if they were generated at build time, see baked_assets.hpp)
+static constexpr char baked_sprite_sheet_filename [] = "assets/baked/sprite_sheet.bin";
+static constexpr char baked_font_filename [] = "assets/baked/font.bin";
+// Pack with all the assets (only embedded if it was generated at build time, see asset_pack.hpp)
+static constexpr char asset_pack_filename [] = "assets/pikaball.pack";
+// External pack that overrides the embedded assets: PIKA_ASSET_PACK env variable, or this file next to the executable
+static constexpr char asset_pack_override_filename [] = "pikaball.pack";
 
 namespace embed {
 
-static const std::array<pika::b::EmbedInternal::EmbeddedFile, 10> resource_list {
+#ifdef PIKA_ASSET_PACK
+// Generated at build time by pikaball_pack (it also contains the baked assets, if any)
+static const auto resource_list = std::to_array<pika::b::EmbedInternal::EmbeddedFile>(
+  {
+    { pika::b::embed<"assets/pikaball.pack">() },
+  }
+);
+#else
+static const auto resource_list = std::to_array<pika::b::EmbedInternal::EmbeddedFile>(
   {
     { pika::b::embed<"assets/images/sprite_sheet.png">() },
     { pika::b::embed<"assets/sounds/bgm.mp3">() },
@@ -34,43 +51,117 @@ static const std::array<pika::b::EmbedInternal::EmbeddedFile, 10> resource_list
     { pika::b::embed<"assets/sounds/ball_hit.wav">() },
     { pika::b::embed<"assets/sounds/ball_ground.wav">() },
     { pika::b::embed<"assets/font.ttf">() },
+#ifdef PIKA_BAKED_ASSETS
+    // Generated at build time by pikaball_bake
+    { pika::b::embed<"assets/baked/sprite_sheet.bin">() },
+    { pika::b::embed<"assets/baked/font.bin">() },
+#endif
   }
-};
+);
+#endif
 
 } // namespace pika::embed
 
+/** Asset packs, searched in order before the other embedded files */
+struct AssetPacks {
+  std::unique_ptr<AssetPack> override_pack;
+  std::unique_ptr<AssetPack> embedded_pack;
+};
+
 /**
- * Load a game resource. First try to load it from the binary embedded data.
+ * Get the asset packs. They are opened on the first call (thread-safe):
+ * the external override pack is mapped from disk if it exists, and the embedded pack is indexed.
+ * Compressed assets are decompressed later, on their first access.
+ */
+inline const AssetPacks& asset_packs() {
+  static const AssetPacks packs = [] {
+    AssetPacks result;
+    std::string override_path;
+    if (const char* env_path = SDL_getenv("PIKA_ASSET_PACK")) {
+      override_path = env_path;
+    } else if (const char* base_path = SDL_GetBasePath()) {
+      override_path = std::string(base_path) + asset_pack_override_filename;
+    }
+    if (!override_path.empty()) {
+      result.override_pack = AssetPack::map_file(override_path);
+      if (result.override_pack) {
+        SDL_Log("Using asset pack %s | %zu assets", override_path.c_str(), result.override_pack->size());
+      }
+    }
+    for (const auto & res : embed::resource_list) {
+      if (res.filename() == asset_pack_filename) {
+        result.embedded_pack = std::make_unique<AssetPack>(
+          std::span {reinterpret_cast<const std::byte*>(res.data()), res.size()});
+        if (!result.embedded_pack->is_valid()) {
+          SDL_Log("The embedded asset pack is not valid!");
+        }
+      }
+    }
+    return result;
+  }();
+  return packs;
+}
+
+/**
+ * Open a game resource if it exists. First try to load it from the asset packs
+ * (the external override pack, then the embedded pack), then from the other embedded files.
  * If that fails, load it from disk.
- * If the resource cannot be loaded, an exception is thrown.
  *
  * NOTE: After usage, it is required to manually call SDL_CloseIO to free the memory.
- *   This is usually handled by SDL_LoadPNG(..., bool close_io) and similar functions.
  * @param filename The resource filename (relative to the project root)
- * @return A (owning) pointer to a SDL_IOStream
+ * @return A (owning) pointer to a SDL_IOStream, or nullptr if the resource does not exist
  */
-inline SDL_IOStream* load_resource(const char* filename) {
-  SDL_IOStream* resource_data = nullptr;
+inline SDL_IOStream* find_resource(const char* filename) {
+  const AssetPacks& packs = asset_packs();
+  for (const AssetPack* pack : {packs.override_pack.get(), packs.embedded_pack.get()}) {
+    if (pack == nullptr) {
+      continue;
+    }
+    if (const auto data = pack->find(filename)) {
+      SDL_Log("Loading %s from the asset pack | %zu bytes", filename, data->size());
+      return SDL_IOFromConstMem(data->data(), data->size());
+    }
+  }
+
   for (const auto & res : embed::resource_list) {
     if (res.filename() == filename) {
       SDL_Log("Loading embedded %s | %zu bytes", filename, res.size());
-      resource_data = SDL_IOFromConstMem(res.data(), res.size());
-      break;
+      return SDL_IOFromConstMem(res.data(), res.size());
     }
   }
 
+  SDL_Log("Could not load resource %s from embedded data. Loading from file...", filename);
+  return SDL_IOFromFile(filename, "r");
+}
+
+/**
+ * Load a game resource. First try to load it from the asset packs and the binary embedded data
+ * (see find_resource). If that fails, load it from disk.
+ * If the resource cannot be loaded, an exception is thrown.
+ *
+ * NOTE: After usage, it is required to manually call SDL_CloseIO to free the memory.
+ *   This is usually handled by SDL_LoadPNG(..., bool close_io) and similar functions.
+ * @param filename The resource filename (relative to the project root)
+ * @return A (owning) pointer to a SDL_IOStream
+ */
+inline SDL_IOStream* load_resource(const char* filename) {
+  SDL_IOStream* resource_data = find_resource(filename);
   if (resource_data == nullptr) {
-    SDL_Log("Could not load resource %s from embedded data. Loading from file...", filename);
-    resource_data = SDL_IOFromFile(filename, "r");
-    if (resource_data == nullptr) {
-      SDL_Log( "Unable to load resource %s! SDL Error: %s\n", filename, SDL_GetError());
-      throw std::runtime_error("Failed to load resource!");
-    }
+    SDL_Log( "Unable to load resource %s! SDL Error: %s\n", filename, SDL_GetError());
+    throw std::runtime_error("Failed to load resource!");
   }
-
   return resource_data;
 }
 
+/**
+ * Log the time spent decoding a resource
+ * @param filename The resource filename
+ * @param start_time Timestamp in nanoseconds (SDL_GetTicksNS) when the decoding started
+ */
+inline void log_load_time(const char* filename, const Uint64 start_time) {
+  SDL_Log("Decoded %s in %.2f ms", filename, static_cast<double>(SDL_GetTicksNS() - start_time) / 1e6);
+}
+
 } // namespace pika
 
 #endif // PIKA_RESOURCES_HPP
@@ -0,0 +1,62 @@
+#ifndef PIKA_RING_BUFFER_HPP
+#define PIKA_RING_BUFFER_HPP
+
+#include <array>
+#include <cstddef>
+
+namespace pika {
+
+/**
+ * Fixed-size circular buffer.
+ * The storage is allocated inside the object, so pushing never allocates.
+ * When the buffer is full, new elements overwrite the oldest ones.
+ * @tparam T Type of the stored elements
+ * @tparam N Maximum number of elements
+ */
+template <typename T, std::size_t N>
+class RingBuffer {
+public:
+  static_assert(N > 0, "RingBuffer capacity must be greater than zero");
+
+  /**
+   * Add a new element, overwriting the oldest one if the buffer is full
+   * @param value The element to store
+   */
+  void push(const T& value) {
+    data_[head_] = value;
+    head_ = (head_ + 1) % N;
+    if (size_ < N) {
+      size_++;
+    }
+  }
+
+  /** Remove all the elements (the storage is kept) */
+  void clear() {
+    head_ = 0;
+    size_ = 0;
+  }
+
+  /**
+   * Access the stored elements in insertion order
+   * @param index Position of the element, where 0 is the oldest one. Must be lower than size()
+   * @return The element at the given position
+   */
+  [[nodiscard]] const T& operator[](const std::size_t index) const {
+    return data_[(head_ + N - size_ + index) % N];
+  }
+
+  [[nodiscard]] std::size_t size() const { return size_; }
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+  [[nodiscard]] static constexpr std::size_t capacity() { return N; }
+
+private:
+  std::array<T, N> data_ {};
+  // Position where the next element will be written
+  std::size_t head_ {0};
+  // Number of valid elements
+  std::size_t size_ {0};
+};
+
+} // namespace pika
+
+#endif // PIKA_RING_BUFFER_HPP
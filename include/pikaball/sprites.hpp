@@ -4,7 +4,10 @@
 #include "SDL3/SDL_rect.h"
 #include <array>
 
-/** Pixel locations and sizes of the sprites from the sprite sheet */
+/**
+ * Pixel locations and sizes of the sprites in the sprite sheet.
+ * Generated by pikaball_atlas from assets/images/sprites.txt: do not edit.
+ */
 
 namespace pika::sprite {
 
@@ -409,10 +412,10 @@ constexpr std::array pikachu_hit_animation {
   pikachu_hit_4,
 };
 
+// The short animations are padded to the 5 frames of the longest ones
 constexpr std::array pikachu_dive_animation {
   pikachu_dive_0,
   pikachu_dive_1,
-  // Extra to make it length 5
   pikachu_dive_0,
   pikachu_dive_1,
   pikachu_dive_0,
@@ -420,7 +423,6 @@ constexpr std::array pikachu_dive_animation {
 
 constexpr std::array pikachu_after_diving_animation {
   pikachu_after_diving,
-  // Extra to make it length 5
   pikachu_after_diving,
   pikachu_after_diving,
   pikachu_after_diving,
@@ -443,7 +445,6 @@ constexpr std::array pikachu_loser_animation {
   pikachu_loser_4,
 };
 
-
 /** Menu and UI items **/
 
 constexpr SDL_FRect number_0 {
@@ -544,8 +545,8 @@ constexpr SDL_FRect msg_player_2 {
   .h = 20
 };
 
-
 /** Messages **/
+
 constexpr SDL_FRect msg_pikachu_volleyball {
   .x = 2,
   .y = 530,
@@ -0,0 +1,242 @@
+#ifndef PIKA_TRACE_HPP
+#define PIKA_TRACE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Timeline tracing of the game loop, exported as Chrome Trace Event JSON
+ * (open it in chrome://tracing or https://ui.perfetto.dev).
+ *
+ * Code is instrumented with scoped zones (PIKA_TRACE_ZONE). While tracing is stopped, a zone costs
+ * an atomic load. While it runs, each zone writes one event into a ring buffer of its thread, without
+ * locks or allocations. Each buffer keeps the last events_per_thread events, so a dump shows the last
+ * seconds before it was requested.
+ * The buffers of the registered threads (see Tracer::set_thread_name()) are allocated when tracing
+ * starts, or when the thread is registered if it is already running, never in the middle of a frame.
+ */
+namespace pika::trace {
+
+/** A completed zone */
+struct Event {
+  // Zone name (must be a string with static storage, e.g. a literal)
+  const char* name {nullptr};
+  std::uint64_t start_ns {0};
+  std::uint64_t duration_ns {0};
+};
+
+// Events kept per thread (1.5 MB, allocated when tracing starts)
+constexpr std::size_t events_per_thread = 65536;
+
+inline std::uint64_t now_ns() {
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * Ring buffer of the events of a thread. Only its thread writes to it.
+ * Readers copy the events and discard the ones that were overwritten while copying.
+ * The events are allocated by the Tracer before the thread can write them (see Tracer::start()).
+ */
+class ThreadBuffer {
+public:
+  explicit ThreadBuffer(const unsigned int id) : id_(id) {}
+
+  /** Allocate the events, if they are not allocated yet (they are kept until the program exits) */
+  void allocate() {
+    if (!slots_) {
+      slots_ = std::make_unique<Slot[]>(events_per_thread);
+    }
+  }
+
+  void push(const Event& event) {
+    const std::uint64_t index = written_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[index % events_per_thread];
+    slot.name.store(event.name, std::memory_order_relaxed);
+    slot.start_ns.store(event.start_ns, std::memory_order_relaxed);
+    slot.duration_ns.store(event.duration_ns, std::memory_order_relaxed);
+    written_.store(index + 1, std::memory_order_release);
+  }
+
+  /**
+   * Copy the events that are still in the buffer
+   * @param output The events are appended here (oldest first)
+   */
+  void copy(std::vector<Event>& output) const {
+    const std::uint64_t written = written_.load(std::memory_order_acquire);
+    const std::uint64_t first = (written > events_per_thread) ? written - events_per_thread : 0;
+    const std::size_t begin = output.size();
+    for (std::uint64_t i = first; i < written; i++) {
+      const Slot& slot = slots_[i % events_per_thread];
+      output.push_back({
+        slot.name.load(std::memory_order_relaxed),
+        slot.start_ns.load(std::memory_order_relaxed),
+        slot.duration_ns.load(std::memory_order_relaxed),
+      });
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // The owner thread may have overwritten the oldest events during the copy
+    // (including the slot of the event that it may be writing now)
+    const std::uint64_t write_limit = written_.load(std::memory_order_acquire) + 1;
+    const std::uint64_t overwritten = (write_limit > events_per_thread + first)
+      ? std::min(write_limit - events_per_thread - first, written - first) : 0;
+    output.erase(output.begin() + static_cast<std::ptrdiff_t>(begin),
+                 output.begin() + static_cast<std::ptrdiff_t>(begin + overwritten));
+  }
+
+  [[nodiscard]] unsigned int id() const { return id_; }
+
+  // Thread name shown in the trace (protected by the Tracer mutex)
+  std::string name;
+
+private:
+  // Event fields stored as atomics, so a reader never races with the owner thread
+  struct Slot {
+    std::atomic<const char*> name {nullptr};
+    std::atomic<std::uint64_t> start_ns {0};
+    std::atomic<std::uint64_t> duration_ns {0};
+  };
+
+  unsigned int id_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<std::uint64_t> written_ {0};
+};
+
+/** Owner of the buffers of all the threads (they are kept after the threads exit) */
+class Tracer {
+public:
+  static Tracer& instance() {
+    static Tracer tracer;
+    return tracer;
+  }
+
+  // Acquire: a thread that sees the tracer running also sees the buffers allocated by start()
+  [[nodiscard]] bool is_running() const { return running_.load(std::memory_order_acquire); }
+
+  /**
+   * Start recording events. Events recorded before are not exported.
+   * The buffers of all the registered threads are allocated here, so the zones never allocate
+   */
+  void start() {
+    std::lock_guard lock(mutex_);
+    for (const auto& buffer : buffers_) {
+      buffer->allocate();
+    }
+    start_ns_.store(now_ns(), std::memory_order_relaxed);
+    running_.store(true, std::memory_order_release);
+  }
+
+  /** Stop recording events (the recorded events can still be exported) */
+  void stop() {
+    running_.store(false, std::memory_order_relaxed);
+  }
+
+  /**
+   * Buffer of the calling thread (created and registered on the first call).
+   * Its events are allocated by start(), or here if the tracer is already running
+   */
+  ThreadBuffer& thread_buffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+      std::lock_guard lock(mutex_);
+      buffer = buffers_.emplace_back(
+        std::make_unique<ThreadBuffer>(static_cast<unsigned int>(buffers_.size()) + 1)).get();
+      if (running_.load(std::memory_order_relaxed)) {
+        buffer->allocate();
+      }
+    }
+    return *buffer;
+  }
+
+  /**
+   * Name the calling thread in the trace and register it, so its buffer is allocated when
+   * tracing starts instead of by its first zone
+   */
+  void set_thread_name(const char* name) {
+    ThreadBuffer& buffer = thread_buffer();
+    std::lock_guard lock(mutex_);
+    buffer.name = name;
+  }
+
+  /**
+   * Write the recorded events as Chrome Trace Event JSON ("X" complete events, times in microseconds)
+   * @param filename The output file
+   * @return The number of events written, or -1 if the file could not be written
+   */
+  long dump(const std::string& filename) {
+    std::FILE* file = std::fopen(filename.c_str(), "w");
+    if (file == nullptr) {
+      return -1;
+    }
+    const std::uint64_t start_ns = start_ns_.load(std::memory_order_relaxed);
+    long count = 0;
+    std::vector<Event> events;
+    events.reserve(events_per_thread);
+    std::fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    std::lock_guard lock(mutex_);
+    for (const auto& buffer : buffers_) {
+      const std::string name = buffer->name.empty() ? "thread " + std::to_string(buffer->id()) : buffer->name;
+      std::fprintf(file, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": \"%s\"}}",
+                   (buffer == buffers_.front()) ? "" : ",\n", buffer->id(), name.c_str());
+      events.clear();
+      buffer->copy(events);
+      for (const Event& event : events) {
+        if (event.start_ns < start_ns) {
+          continue;
+        }
+        std::fprintf(file, ",\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}",
+                     event.name, buffer->id(), static_cast<double>(event.start_ns - start_ns) / 1e3,
+                     static_cast<double>(event.duration_ns) / 1e3);
+        count++;
+      }
+    }
+    std::fprintf(file, "\n]}\n");
+    return (std::fclose(file) == 0) ? count : -1;
+  }
+
+private:
+  std::atomic<bool> running_ {false};
+  std::atomic<std::uint64_t> start_ns_ {0};
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+
+  Tracer() = default;
+};
+
+/** Records the time between its construction and its destruction (if tracing is running) */
+class Zone {
+public:
+  explicit Zone(const char* name) :
+    name_(Tracer::instance().is_running() ? name : nullptr),
+    start_ns_((name_ != nullptr) ? now_ns() : 0)
+  {}
+  ~Zone() {
+    if (name_ != nullptr) {
+      Tracer::instance().thread_buffer().push({name_, start_ns_, now_ns() - start_ns_});
+    }
+  }
+  Zone(Zone const&) = delete;
+  Zone(Zone &&) = delete;
+  Zone &operator=(Zone const&) = delete;
+  Zone &operator=(Zone &&) = delete;
+
+private:
+  const char* name_;
+  std::uint64_t start_ns_;
+};
+
+} // namespace pika::trace
+
+#define PIKA_TRACE_CONCAT_IMPL(a, b) a##b
+#define PIKA_TRACE_CONCAT(a, b) PIKA_TRACE_CONCAT_IMPL(a, b)
+/** Trace the rest of the current scope as a zone with the given name (a string literal) */
+#define PIKA_TRACE_ZONE(name) const ::pika::trace::Zone PIKA_TRACE_CONCAT(pika_trace_zone_, __LINE__) {name}
+
+#endif // PIKA_TRACE_HPP
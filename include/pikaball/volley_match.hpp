@@ -0,0 +1,182 @@
+#ifndef PIKA_VOLLEY_MATCH_HPP
+#define PIKA_VOLLEY_MATCH_HPP
+
+#include <cstdint>
+
+#include "game_state.hpp"
+#include "input.hpp"
+#include "physics/physics.hpp"
+
+namespace pika {
+
+/** Everything that drives a frame of a match: the input of the players and the game commands */
+struct MatchFrame {
+  PlayerInput input_left {};
+  PlayerInput input_right {};
+  // Points needed to win the game (it can be changed in the options during the game)
+  int win_score {15};
+  // Skip the end of game animation (only after it was shown for a while)
+  bool skip_game_end {false};
+  // Skip the rest of the round and go to the next one (after the instant replay of the point)
+  bool next_round {false};
+};
+
+/**
+ * State machine and scoring of a volley game: new game message, rounds, points and the
+ * end of the game, as in the VolleyGame state of the original game.
+ *
+ * It is shared by the game and the export tool, which plays recorded matches again: a match
+ * started with the same seed and stepped with the same frames is always the same.
+ * Rendering, sounds, pause, slow motion and the instant replay are handled by the caller,
+ * based on the state and the transition returned by each step.
+ */
+class VolleyMatch {
+public:
+  // Number of frames of the states (the view animations are timed with them)
+  constexpr static unsigned int new_game_frames = 71;
+  constexpr static unsigned int start_round_frames = 30;
+  constexpr static unsigned int end_round_frames = 11;
+  constexpr static unsigned int game_end_frames = 211;
+  constexpr static unsigned int game_end_skip_frames = 70;
+  // Frames after the point that are shown in slow motion
+  constexpr static unsigned int slow_motion_frames = 6;
+
+  /** What changed in a step of the match */
+  enum class Transition {
+    None,
+    FirstRound,    // The new game message ended, the first round starts
+    RoundStarted,  // The start round message ended, the round starts
+    PointScored,   // The ball touched the ground and the round ended
+    GameEnded,     // The ball touched the ground and a player won the game
+    NextRound,     // The end of the round ended, the next round is set up
+    GameOver,      // The end of game animation ended: the match is over
+  };
+
+  /** @param physics The physics of the match (updated and reset by the match) */
+  explicit VolleyMatch(Physics<>& physics) : physics_(physics) {}
+
+  /**
+   * Reset the scores and the physics to start a new game
+   * @param seed Seed of the random choices of the physics (the same seed plays the same match)
+   */
+  void start(const std::uint32_t seed) {
+    state_ = VolleyGameState::NewGame;
+    frame_counter_ = 0;
+    score_left_ = 0;
+    score_right_ = 0;
+    next_serve_side_ = FieldSide::Left;
+    physics_.restart();
+    physics_.seed(seed);
+  }
+
+  /**
+   * Advance the match one frame
+   * @param frame The input and commands of the frame
+   * @param update_physics Called to update the physics with the input of both players, as
+   *                       bool(const PlayerInput& left, const PlayerInput& right). It must call
+   *                       Physics::update() and return its result (the caller can measure or
+   *                       record the update)
+   * @return The transition of the frame
+   */
+  template <typename UpdatePhysics>
+  Transition step(const MatchFrame& frame, UpdatePhysics&& update_physics) {
+    win_score_ = frame.win_score;
+    if (frame.next_round) {
+      next_round();
+      return Transition::NextRound;
+    }
+
+    frame_counter_++;
+    switch (state_) {
+      case VolleyGameState::NewGame:
+        if (frame_counter_ >= new_game_frames) {
+          state_ = VolleyGameState::PlayRound;
+          return Transition::FirstRound;
+        }
+      break;
+      case VolleyGameState::StartRound:
+        if (frame_counter_ >= start_round_frames) {
+          state_ = VolleyGameState::PlayRound;
+          return Transition::RoundStarted;
+        }
+      break;
+      case VolleyGameState::PlayRound:
+        // Update physics and check if the ball is touching the ground
+        if (update_physics(frame.input_left, frame.input_right)) {
+          next_serve_side_ = update_score();
+          frame_counter_ = 0;
+          if (score_left_ >= win_score_ || score_right_ >= win_score_) {
+            physics_.end_game(next_serve_side_);
+            state_ = VolleyGameState::GameEnd;
+            return Transition::GameEnded;
+          }
+          state_ = VolleyGameState::EndRound;
+          return Transition::PointScored;
+        }
+      break;
+      case VolleyGameState::EndRound:
+        // We keep updating the physics, but without checking the ball
+        update_physics(frame.input_left, frame.input_right);
+        if (frame_counter_ >= end_round_frames) {
+          next_round();
+          return Transition::NextRound;
+        }
+      break;
+      case VolleyGameState::GameEnd:
+        // The end of game animation ends after its frames, or earlier if it is skipped
+        if ((frame.skip_game_end && frame_counter_ > game_end_skip_frames) || frame_counter_ > game_end_frames) {
+          return Transition::GameOver;
+        }
+        // Keep updating physics in the end state, without checking the ball touching ground
+        update_physics(frame.input_left, frame.input_right);
+      break;
+      case VolleyGameState::Replay:
+        // Never a state of the match: the instant replay is shown by the caller
+      break;
+    }
+    return Transition::None;
+  }
+
+  [[nodiscard]] VolleyGameState state() const { return state_; }
+  /** Frames since the current state started */
+  [[nodiscard]] unsigned int frame_counter() const { return frame_counter_; }
+  [[nodiscard]] int score_left() const { return score_left_; }
+  [[nodiscard]] int score_right() const { return score_right_; }
+  /** The first frames after the point are shown in slow motion */
+  [[nodiscard]] bool slow_motion() const {
+    return state_ == VolleyGameState::EndRound && frame_counter_ > 0 && frame_counter_ <= slow_motion_frames;
+  }
+
+private:
+  Physics<>& physics_;
+  VolleyGameState state_ {VolleyGameState::NewGame};
+  unsigned int frame_counter_ {0};
+  int score_left_ {0};
+  int score_right_ {0};
+  int win_score_ {15};
+  FieldSide next_serve_side_ {FieldSide::Left};
+
+  /** Set up the next round, served by the side that won the point */
+  void next_round() {
+    frame_counter_ = 0;
+    physics_.init_round(next_serve_side_);
+    state_ = VolleyGameState::StartRound;
+  }
+
+  /**
+   * Update the score based on the position of the ball punch effect.
+   * @return The side that won the point
+   */
+  FieldSide update_score() {
+    if (physics_.ball().punch_effect_x() < ground_h_width) {
+      score_right_++;
+      return FieldSide::Right;
+    }
+    score_left_++;
+    return FieldSide::Left;
+  }
+};
+
+} // namespace pika
+
+#endif // PIKA_VOLLEY_MATCH_HPP
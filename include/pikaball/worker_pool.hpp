@@ -0,0 +1,199 @@
+#ifndef PIKA_WORKER_POOL_HPP
+#define PIKA_WORKER_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "trace.hpp"
+
+namespace pika {
+
+/**
+ * Fixed set of worker threads that run the submitted tasks in order of submission.
+ * The result (or the exception) of each task is returned through a std::future.
+ *
+ * The destructor runs all the pending tasks before joining the workers, so tasks may
+ * reference objects that outlive the pool.
+ * Tasks must not wait for other tasks of the same pool (the pool could run out of workers).
+ */
+class WorkerPool {
+public:
+  /**
+   * Start the worker threads
+   * @param num_threads Number of workers. By default, one less than the hardware threads (at least one)
+   */
+  explicit WorkerPool(const unsigned int num_threads = default_num_threads()) {
+    const unsigned int count = std::max(num_threads, 1u);
+    workers_.reserve(count);
+    for (unsigned int i = 0; i < count; i++) {
+      workers_.emplace_back(&WorkerPool::work, this);
+    }
+  }
+
+  ~WorkerPool() {
+    {
+      std::lock_guard lock(mutex_);
+      stop_requested_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  WorkerPool(WorkerPool const&) = delete;
+  WorkerPool(WorkerPool &&) = delete;
+  WorkerPool &operator=(WorkerPool const&) = delete;
+  WorkerPool &operator=(WorkerPool &&) = delete;
+
+  /**
+   * Queue a task to be run by the first free worker
+   * @param task Callable without arguments
+   * @return Future with the result of the task. Exceptions thrown by the task are rethrown by get()
+   */
+  template <typename F>
+  std::future<std::invoke_result_t<F>> submit(F&& task) {
+    std::packaged_task<std::invoke_result_t<F>()> packaged(std::forward<F>(task));
+    auto result = packaged.get_future();
+    {
+      std::lock_guard lock(mutex_);
+      tasks_.emplace_back(std::move(packaged));
+    }
+    cv_.notify_one();
+    return result;
+  }
+
+  [[nodiscard]] std::size_t size() const { return workers_.size(); }
+
+  /** One less than the hardware threads (the main thread keeps working), and at least one */
+  [[nodiscard]] static unsigned int default_num_threads() {
+    return std::max(std::thread::hardware_concurrency(), 2u) - 1;
+  }
+
+private:
+  std::vector<std::thread> workers_;
+  std::deque<std::move_only_function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_requested_ {false};
+
+  /** Worker loop: run tasks until the pool is destroyed and the queue is empty */
+  void work() {
+    while (true) {
+      std::move_only_function<void()> task;
+      {
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [this] { return !tasks_.empty() || stop_requested_; });
+        if (tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+};
+
+/**
+ * Persistent worker thread for a task that runs every frame, concurrently with the caller.
+ *
+ * The task is set once: start() wakes the worker to run it, and wait() blocks until it ends
+ * (exceptions thrown by the task are rethrown by wait()). Unlike WorkerPool::submit(), running
+ * the task does not allocate, so it can be used in the frames that must not allocate.
+ * The destructor waits for a started task before joining the worker.
+ */
+class FrameWorker {
+public:
+  /**
+   * Start the worker thread
+   * @param name Name of the thread in the traces
+   * @param task Callable without arguments, run by the worker after each start()
+   */
+  FrameWorker(const char* name, std::move_only_function<void()> task) :
+    name_(name),
+    task_(std::move(task)),
+    thread_(&FrameWorker::work, this)
+  {}
+
+  ~FrameWorker() {
+    {
+      std::lock_guard lock(mutex_);
+      stop_requested_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+  }
+
+  FrameWorker(FrameWorker const&) = delete;
+  FrameWorker(FrameWorker &&) = delete;
+  FrameWorker &operator=(FrameWorker const&) = delete;
+  FrameWorker &operator=(FrameWorker &&) = delete;
+
+  /** Run the task on the worker. It must not be running (call wait() before starting it again) */
+  void start() {
+    {
+      std::lock_guard lock(mutex_);
+      running_ = true;
+    }
+    cv_.notify_all();
+  }
+
+  /** Wait until the started task ends, and rethrow its exception (if any) */
+  void wait() {
+    std::unique_lock lock(mutex_);
+    cv_.wait(lock, [this] { return !running_; });
+    if (error_) {
+      std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+  }
+
+private:
+  const char* name_;
+  std::move_only_function<void()> task_;
+  std::mutex mutex_;
+  // Wakes the worker (start, stop) and the caller of wait() (end of the task)
+  std::condition_variable cv_;
+  bool running_ {false};
+  bool stop_requested_ {false};
+  std::exception_ptr error_ {nullptr};
+  // Declared last, so the worker starts after the other members are initialized
+  std::thread thread_;
+
+  /** Worker loop: run the task after each start() until the worker is destroyed */
+  void work() {
+    trace::Tracer::instance().set_thread_name(name_);
+    std::unique_lock lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [this] { return running_ || stop_requested_; });
+      if (!running_) {
+        return;
+      }
+      lock.unlock();
+      std::exception_ptr error {nullptr};
+      try {
+        task_();
+      }
+      catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+      error_ = error;
+      running_ = false;
+      cv_.notify_all();
+    }
+  }
+};
+
+} // namespace pika
+
+#endif // PIKA_WORKER_POOL_HPP
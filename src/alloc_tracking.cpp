@@ -0,0 +1,134 @@
+#include <pikaball/alloc_tracking.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "SDL3/SDL_stdinc.h"
+
+namespace pika::alloc {
+
+namespace {
+
+// Constant initialized: allocations made before main() are also counted
+std::array<std::atomic<std::uint64_t>, num_subsystems> allocation_counts {};
+std::array<std::atomic<std::uint64_t>, num_subsystems> allocated_bytes {};
+
+void record(const std::size_t size) {
+  const auto subsystem = static_cast<std::size_t>(current_subsystem);
+  allocation_counts[subsystem].fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes[subsystem].fetch_add(size, std::memory_order_relaxed);
+}
+
+/**
+ * Allocate like the default operator new (retry with the new handler, or throw)
+ * @param alignment Alignment of the aligned operator new, or 0 for the default one
+ */
+void* allocate(const std::size_t size, const std::size_t alignment) {
+  record(size);
+  const std::size_t alloc_size = (size == 0) ? 1 : size;
+  while (true) {
+    void* ptr = nullptr;
+    if (alignment == 0) {
+      ptr = std::malloc(alloc_size);
+    }
+    else {
+#ifdef _WIN32
+      ptr = _aligned_malloc(alloc_size, alignment);
+#else
+      // aligned_alloc needs a size multiple of the alignment
+      ptr = std::aligned_alloc(alignment, (alloc_size + alignment - 1) / alignment * alignment);
+#endif
+    }
+    if (ptr != nullptr) {
+      return ptr;
+    }
+    const std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+void deallocate_aligned(void* ptr) {
+#ifdef _WIN32
+  _aligned_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+
+// Original SDL memory functions
+SDL_malloc_func sdl_malloc {nullptr};
+SDL_calloc_func sdl_calloc {nullptr};
+SDL_realloc_func sdl_realloc {nullptr};
+SDL_free_func sdl_free {nullptr};
+
+void* SDLCALL tracked_sdl_malloc(const size_t size) {
+  record(size);
+  return sdl_malloc(size);
+}
+
+void* SDLCALL tracked_sdl_calloc(const size_t nmemb, const size_t size) {
+  record(nmemb * size);
+  return sdl_calloc(nmemb, size);
+}
+
+void* SDLCALL tracked_sdl_realloc(void* mem, const size_t size) {
+  // A reallocation may move the block: it is counted as a new allocation
+  record(size);
+  return sdl_realloc(mem, size);
+}
+
+void SDLCALL tracked_sdl_free(void* mem) {
+  sdl_free(mem);
+}
+
+} // namespace
+
+void install_sdl_hooks() {
+  if (sdl_malloc != nullptr) {
+    return;
+  }
+  SDL_GetOriginalMemoryFunctions(&sdl_malloc, &sdl_calloc, &sdl_realloc, &sdl_free);
+  SDL_SetMemoryFunctions(tracked_sdl_malloc, tracked_sdl_calloc, tracked_sdl_realloc, tracked_sdl_free);
+}
+
+Counts counts() {
+  Counts result;
+  for (std::size_t i = 0; i < num_subsystems; i++) {
+    result.allocations[i] = allocation_counts[i].load(std::memory_order_relaxed);
+    result.bytes[i] = allocated_bytes[i].load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
+} // namespace pika::alloc
+
+// Replacements of the global allocation functions. The array and nothrow versions
+// of the standard library call these ones.
+
+void* operator new(const std::size_t size) {
+  return pika::alloc::allocate(size, 0);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment) {
+  return pika::alloc::allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::align_val_t) noexcept {
+  pika::alloc::deallocate_aligned(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, const std::align_val_t) noexcept {
+  pika::alloc::deallocate_aligned(ptr);
+}
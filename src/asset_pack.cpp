@@ -0,0 +1,400 @@
+#include <pikaball/asset_pack.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define PIKA_POSIX_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pika {
+
+namespace {
+
+// Identifies the pack files ("PIKP") and the version of their layout
+constexpr std::uint32_t pack_magic = 0x504B4950;
+constexpr std::uint32_t pack_version = 1;
+constexpr std::size_t header_size = 3 * sizeof(std::uint32_t);
+// hash, name offset, name size, data offset, packed size, size, flags
+constexpr std::size_t index_entry_size = 8 + 4 + 4 + 8 + 8 + 8 + 4;
+constexpr std::uint32_t flag_compressed = 1;
+
+// Compression: a match needs at least 4 bytes, the last 5 bytes are always literals
+// and no match starts in the last 12 bytes (same limits as the LZ4 block format)
+constexpr std::size_t min_match = 4;
+constexpr std::size_t last_literals = 5;
+constexpr std::size_t match_start_margin = 12;
+constexpr std::size_t max_offset = 0xFFFF;
+constexpr unsigned int hash_bits = 16;
+
+template <typename T>
+T read_le(const std::byte* data) {
+  T value = 0;
+  for (std::size_t i = 0; i < sizeof(T); i++) {
+    value |= static_cast<T>(std::to_integer<std::uint8_t>(data[i])) << (8 * i);
+  }
+  return value;
+}
+
+template <typename T>
+void write_le(std::vector<std::byte>& out, T value) {
+  for (std::size_t i = 0; i < sizeof(T); i++) {
+    out.push_back(static_cast<std::byte>(value & 0xFF));
+    value >>= 8;
+  }
+}
+
+/** Extra length bytes (255 means that another byte follows) */
+void write_length(std::vector<std::byte>& out, std::size_t length) {
+  while (length >= 255) {
+    out.push_back(std::byte {255});
+    length -= 255;
+  }
+  out.push_back(static_cast<std::byte>(length));
+}
+
+/** Read the extra length bytes. False if the block ends before the length */
+bool read_length(std::span<const std::byte> input, std::size_t& position, std::size_t& length) {
+  std::uint8_t value = 0;
+  do {
+    if (position >= input.size()) {
+      return false;
+    }
+    value = std::to_integer<std::uint8_t>(input[position++]);
+    length += value;
+  } while (value == 255);
+  return true;
+}
+
+void write_sequence(
+  std::vector<std::byte>& out,
+  std::span<const std::byte> literals,
+  const std::size_t offset,
+  const std::size_t match_length)
+{
+  const std::size_t extra_match = match_length - min_match;
+  const auto token = static_cast<std::uint8_t>(
+    (std::min<std::size_t>(literals.size(), 15) << 4) | std::min<std::size_t>(extra_match, 15));
+  out.push_back(static_cast<std::byte>(token));
+  if (literals.size() >= 15) {
+    write_length(out, literals.size() - 15);
+  }
+  out.insert(out.end(), literals.begin(), literals.end());
+  write_le(out, static_cast<std::uint16_t>(offset));
+  if (extra_match >= 15) {
+    write_length(out, extra_match - 15);
+  }
+}
+
+void write_last_literals(std::vector<std::byte>& out, std::span<const std::byte> literals) {
+  out.push_back(static_cast<std::byte>(std::min<std::size_t>(literals.size(), 15) << 4));
+  if (literals.size() >= 15) {
+    write_length(out, literals.size() - 15);
+  }
+  out.insert(out.end(), literals.begin(), literals.end());
+}
+
+std::uint32_t sequence_hash(const std::uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - hash_bits);
+}
+
+} // namespace
+
+namespace lz {
+
+std::vector<std::byte> compress(std::span<const std::byte> input) {
+  std::vector<std::byte> out;
+  out.reserve(input.size() + input.size() / 255 + 16);
+  const std::size_t size = input.size();
+  if (size <= match_start_margin) {
+    write_last_literals(out, input);
+    return out;
+  }
+
+  // Last position of each 4-byte sequence (+1, so 0 is empty). Greedy matching
+  std::vector<std::uint32_t> table(std::size_t {1} << hash_bits, 0);
+  const std::size_t match_limit = size - last_literals;
+  const std::size_t start_limit = size - match_start_margin;
+  std::size_t anchor = 0;
+  std::size_t position = 0;
+  while (position < start_limit) {
+    const auto sequence = read_le<std::uint32_t>(&input[position]);
+    const std::uint32_t hash = sequence_hash(sequence);
+    const std::size_t candidate = table[hash];
+    table[hash] = static_cast<std::uint32_t>(position + 1);
+    if (candidate == 0 || position - (candidate - 1) > max_offset ||
+        read_le<std::uint32_t>(&input[candidate - 1]) != sequence) {
+      position++;
+      continue;
+    }
+    const std::size_t match = candidate - 1;
+    std::size_t length = min_match;
+    while (position + length < match_limit && input[match + length] == input[position + length]) {
+      length++;
+    }
+    write_sequence(out, input.subspan(anchor, position - anchor), position - match, length);
+    position += length;
+    anchor = position;
+  }
+  write_last_literals(out, input.subspan(anchor));
+  return out;
+}
+
+bool decompress(std::span<const std::byte> input, std::span<std::byte> output) {
+  std::size_t in = 0;
+  std::size_t out = 0;
+  while (in < input.size()) {
+    const auto token = std::to_integer<std::uint8_t>(input[in++]);
+    std::size_t literals = token >> 4;
+    if (literals == 15 && !read_length(input, in, literals)) {
+      return false;
+    }
+    if (literals > input.size() - in || literals > output.size() - out) {
+      return false;
+    }
+    // An empty output (or input) may have a null data pointer
+    if (literals > 0) {
+      std::memcpy(output.data() + out, input.data() + in, literals);
+    }
+    in += literals;
+    out += literals;
+    // The last sequence only has literals
+    if (in == input.size()) {
+      break;
+    }
+
+    if (input.size() - in < 2) {
+      return false;
+    }
+    const auto offset = read_le<std::uint16_t>(&input[in]);
+    in += 2;
+    std::size_t length = token & 0x0F;
+    if (length == 15 && !read_length(input, in, length)) {
+      return false;
+    }
+    length += min_match;
+    if (offset == 0 || offset > out || length > output.size() - out) {
+      return false;
+    }
+    // The match may overlap the output being written (repeated patterns), so copy byte by byte
+    const std::byte* match = output.data() + out - offset;
+    for (std::size_t i = 0; i < length; i++) {
+      output[out + i] = match[i];
+    }
+    out += length;
+  }
+  return out == output.size();
+}
+
+} // namespace pika::lz
+
+AssetPack::AssetPack(std::span<const std::byte> data) {
+  parse(data);
+}
+
+AssetPack::~AssetPack() {
+#if defined(_WIN32)
+  if (mapping_ != nullptr) {
+    UnmapViewOfFile(mapping_);
+  }
+#elif defined(PIKA_POSIX_MMAP)
+  if (mapping_ != nullptr) {
+    munmap(mapping_, mapping_size_);
+  }
+#endif
+}
+
+std::unique_ptr<AssetPack> AssetPack::map_file(const std::string& path) {
+  std::unique_ptr<AssetPack> pack {new AssetPack()};
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return nullptr;
+  }
+  LARGE_INTEGER file_size {};
+  HANDLE mapping = nullptr;
+  if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  }
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    return nullptr;
+  }
+  // The view keeps the mapping alive after closing its handle
+  pack->mapping_ = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (pack->mapping_ == nullptr) {
+    return nullptr;
+  }
+  pack->mapping_size_ = static_cast<std::size_t>(file_size.QuadPart);
+  pack->parse({static_cast<const std::byte*>(pack->mapping_), pack->mapping_size_});
+#elif defined(PIKA_POSIX_MMAP)
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat file_stat {};
+  void* mapping = MAP_FAILED;
+  if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+    mapping = mmap(nullptr, static_cast<std::size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return nullptr;
+  }
+  pack->mapping_ = mapping;
+  pack->mapping_size_ = static_cast<std::size_t>(file_stat.st_size);
+  pack->parse({static_cast<const std::byte*>(pack->mapping_), pack->mapping_size_});
+#else
+  // No memory mapping in this platform: read the whole file
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    return nullptr;
+  }
+  pack->file_data_.resize(static_cast<std::size_t>(file.tellg()));
+  file.seekg(0);
+  if (!file.read(reinterpret_cast<char*>(pack->file_data_.data()), static_cast<std::streamsize>(pack->file_data_.size()))) {
+    return nullptr;
+  }
+  pack->parse(pack->file_data_);
+#endif
+  if (!pack->is_valid()) {
+    return nullptr;
+  }
+  return pack;
+}
+
+std::vector<std::byte> AssetPack::build(const std::vector<Input>& assets) {
+  struct Packed {
+    const Input* input;
+    std::uint64_t hash;
+    std::vector<std::byte> compressed;
+  };
+  std::vector<Packed> packed;
+  packed.reserve(assets.size());
+  for (const auto& asset : assets) {
+    packed.push_back({&asset, fnv1a(asset.name), lz::compress(asset.data)});
+  }
+  std::ranges::sort(packed, {}, &Packed::hash);
+
+  std::vector<std::byte> out;
+  write_le(out, pack_magic);
+  write_le(out, pack_version);
+  write_le(out, static_cast<std::uint32_t>(packed.size()));
+  const std::size_t names_offset = header_size + packed.size() * index_entry_size;
+  std::size_t names_size = 0;
+  for (const auto& entry : packed) {
+    names_size += entry.input->name.size();
+  }
+
+  std::size_t name_offset = names_offset;
+  std::size_t data_offset = names_offset + names_size;
+  for (const auto& entry : packed) {
+    const bool compressed = entry.compressed.size() < entry.input->data.size();
+    const std::size_t packed_size = compressed ? entry.compressed.size() : entry.input->data.size();
+    write_le(out, entry.hash);
+    write_le(out, static_cast<std::uint32_t>(name_offset));
+    write_le(out, static_cast<std::uint32_t>(entry.input->name.size()));
+    write_le(out, static_cast<std::uint64_t>(data_offset));
+    write_le(out, static_cast<std::uint64_t>(packed_size));
+    write_le(out, static_cast<std::uint64_t>(entry.input->data.size()));
+    write_le(out, compressed ? flag_compressed : std::uint32_t {0});
+    name_offset += entry.input->name.size();
+    data_offset += packed_size;
+  }
+  for (const auto& entry : packed) {
+    const auto* name = reinterpret_cast<const std::byte*>(entry.input->name.data());
+    out.insert(out.end(), name, name + entry.input->name.size());
+  }
+  for (const auto& entry : packed) {
+    const auto& data = (entry.compressed.size() < entry.input->data.size()) ? entry.compressed : entry.input->data;
+    out.insert(out.end(), data.begin(), data.end());
+  }
+  return out;
+}
+
+std::optional<std::span<const std::byte>> AssetPack::find(const std::string_view name) const {
+  const std::uint64_t hash = fnv1a(name);
+  const auto [first, last] = std::ranges::equal_range(entries_, hash, {}, &Entry::hash);
+  for (auto entry = first; entry != last; ++entry) {
+    if (entry->name == name) {
+      const auto index = static_cast<std::size_t>(entry - entries_.begin());
+      std::call_once(load_once_[index], [this, index] { contents_[index] = load(index); });
+      return contents_[index];
+    }
+  }
+  return std::nullopt;
+}
+
+void AssetPack::parse(std::span<const std::byte> data) {
+  if (data.size() < header_size || read_le<std::uint32_t>(data.data()) != pack_magic ||
+      read_le<std::uint32_t>(data.data() + 4) != pack_version) {
+    return;
+  }
+  const auto count = read_le<std::uint32_t>(data.data() + 8);
+  if (count > (data.size() - header_size) / index_entry_size) {
+    return;
+  }
+
+  std::vector<Entry> entries;
+  entries.reserve(count);
+  for (std::size_t i = 0; i < count; i++) {
+    const std::byte* index = data.data() + header_size + i * index_entry_size;
+    const auto name_offset = read_le<std::uint32_t>(index + 8);
+    const auto name_size = read_le<std::uint32_t>(index + 12);
+    const auto data_offset = read_le<std::uint64_t>(index + 16);
+    const auto packed_size = read_le<std::uint64_t>(index + 24);
+    const auto size = read_le<std::uint64_t>(index + 32);
+    const auto flags = read_le<std::uint32_t>(index + 40);
+    if (name_offset > data.size() || name_size > data.size() - name_offset ||
+        data_offset > data.size() || packed_size > data.size() - data_offset ||
+        size > std::numeric_limits<std::size_t>::max()) {
+      return;
+    }
+    const bool compressed = (flags & flag_compressed) != 0;
+    if (!compressed && packed_size != size) {
+      return;
+    }
+    entries.push_back({
+      .hash = read_le<std::uint64_t>(index),
+      .name = {reinterpret_cast<const char*>(data.data() + name_offset), name_size},
+      .packed = data.subspan(static_cast<std::size_t>(data_offset), static_cast<std::size_t>(packed_size)),
+      .size = static_cast<std::size_t>(size),
+      .compressed = compressed,
+    });
+  }
+  if (!std::ranges::is_sorted(entries, {}, &Entry::hash)) {
+    return;
+  }
+
+  entries_ = std::move(entries);
+  load_once_ = std::make_unique<std::once_flag[]>(entries_.size());
+  decompressed_.resize(entries_.size());
+  contents_.resize(entries_.size());
+  valid_ = true;
+}
+
+std::optional<std::span<const std::byte>> AssetPack::load(const std::size_t index) const {
+  const Entry& entry = entries_[index];
+  if (!entry.compressed) {
+    return entry.packed;
+  }
+  auto buffer = std::make_unique_for_overwrite<std::byte[]>(entry.size);
+  if (!lz::decompress(entry.packed, {buffer.get(), entry.size})) {
+    return std::nullopt;
+  }
+  decompressed_[index] = std::move(buffer);
+  return std::span<const std::byte> {decompressed_[index].get(), entry.size};
+}
+
+} // namespace pika
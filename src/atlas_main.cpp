@@ -0,0 +1,482 @@
+/**
+ * Sprite atlas packer (build time host tool).
+ * Reads the sprites of the sprite sheet listed in the manifest (assets/images/sprites.txt), packs
+ * them into the atlas with the smallest area, and generates the header with their rects (sprites.hpp).
+ * The atlas sides can also be limited to powers of two (only needed by old GPUs, and usually larger).
+ * Sprites with the same pixels are packed once. The transparent borders of the sprites are
+ * reported, but not trimmed: the views place the sprites with their full size.
+ *
+ * Usage: pikaball_atlas [--power-of-two] sprites.txt sprite_sheet.png atlas.png sprites.hpp
+ *        pikaball_atlas sprites.txt sprites.hpp  (rects of the sprite sheet itself, no atlas)
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <pikaball/baked_assets.hpp>
+
+using namespace pika;
+
+namespace {
+
+// Empty pixels between sprites, so they never bleed into each other when scaled
+constexpr int sprite_padding = 1;
+// Largest atlas side (supported by any GPU)
+constexpr int max_atlas_size = 4096;
+
+/** Sprite of the manifest */
+struct Sprite {
+  std::string name;
+  // Rect in the sprite sheet
+  SDL_Rect src {};
+  // Rect in the atlas
+  SDL_Rect dst {};
+  // Index of an earlier sprite with the same pixels (packed only once), or -1
+  int same_as {-1};
+};
+
+/** Line of the manifest that goes to the header */
+struct Item {
+  enum class Type { Section, Comment, Sprite, Array };
+  Type type {Type::Comment};
+  // Section title, comment, or name of the sprite / array
+  std::string text;
+  // Index of the sprite, or indices of the sprites of the array
+  std::vector<std::size_t> sprites;
+};
+
+struct Manifest {
+  std::vector<Sprite> sprites;
+  std::vector<Item> items;
+};
+
+std::optional<Manifest> read_manifest(const char* filename) {
+  std::ifstream input(filename);
+  if (!input) {
+    SDL_Log("Unable to open the manifest %s", filename);
+    return std::nullopt;
+  }
+  Manifest manifest;
+  std::map<std::string, std::size_t> sprite_index;
+  std::string line;
+  int line_number = 0;
+  while (std::getline(input, line)) {
+    line_number++;
+    std::istringstream tokens(line);
+    std::string keyword;
+    if (!(tokens >> keyword) || keyword.starts_with('#')) {
+      continue;
+    }
+    Item item;
+    bool valid = true;
+    if (keyword.starts_with("//")) {
+      item.type = Item::Type::Comment;
+      item.text = line.substr(line.find("//"));
+    }
+    else if (keyword == "section") {
+      item.type = Item::Type::Section;
+      std::getline(tokens >> std::ws, item.text);
+      valid = !item.text.empty();
+    }
+    else if (keyword == "sprite") {
+      Sprite sprite;
+      item.type = Item::Type::Sprite;
+      valid = static_cast<bool>(tokens >> sprite.name >> sprite.src.x >> sprite.src.y >> sprite.src.w >> sprite.src.h) &&
+              sprite.src.w > 0 && sprite.src.h > 0 && !sprite_index.contains(sprite.name);
+      if (valid) {
+        item.text = sprite.name;
+        item.sprites.push_back(manifest.sprites.size());
+        sprite_index[sprite.name] = manifest.sprites.size();
+        manifest.sprites.push_back(std::move(sprite));
+      }
+    }
+    else if (keyword == "array") {
+      item.type = Item::Type::Array;
+      valid = static_cast<bool>(tokens >> item.text);
+      std::string name;
+      while (valid && tokens >> name) {
+        const auto it = sprite_index.find(name);
+        valid = it != sprite_index.end();
+        if (valid) {
+          item.sprites.push_back(it->second);
+        }
+      }
+      valid = valid && !item.sprites.empty();
+    }
+    else {
+      valid = false;
+    }
+    if (!valid) {
+      SDL_Log("%s:%d: invalid line: %s", filename, line_number, line.c_str());
+      return std::nullopt;
+    }
+    manifest.items.push_back(std::move(item));
+  }
+  return manifest;
+}
+
+/** Compare the pixels of two sprites of the same size */
+bool same_pixels(const SDL_Surface* sheet, const SDL_Rect& a, const SDL_Rect& b) {
+  const auto* pixels = static_cast<const Uint8*>(sheet->pixels);
+  const auto row_bytes = static_cast<std::size_t>(a.w) * 4;
+  for (int y = 0; y < a.h; y++) {
+    if (std::memcmp(pixels + (a.y + y) * sheet->pitch + a.x * 4,
+                    pixels + (b.y + y) * sheet->pitch + b.x * 4, row_bytes) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/** Find the sprites with the same pixels as an earlier one */
+void find_duplicates(const SDL_Surface* sheet, std::vector<Sprite>& sprites) {
+  for (std::size_t i = 0; i < sprites.size(); i++) {
+    for (std::size_t j = 0; j < i; j++) {
+      const SDL_Rect& a = sprites[i].src;
+      const SDL_Rect& b = sprites[j].src;
+      if (sprites[j].same_as < 0 && a.w == b.w && a.h == b.h && same_pixels(sheet, a, b)) {
+        sprites[i].same_as = static_cast<int>(j);
+        break;
+      }
+    }
+  }
+}
+
+/** Log the transparent borders that trimming the sprites would remove */
+void report_transparent_borders(const SDL_Surface* sheet, const std::vector<Sprite>& sprites) {
+  const auto* pixels = static_cast<const Uint8*>(sheet->pixels);
+  std::size_t total_pixels = 0;
+  std::size_t transparent_pixels = 0;
+  for (const Sprite& sprite : sprites) {
+    if (sprite.same_as >= 0) {
+      continue;
+    }
+    const SDL_Rect& src = sprite.src;
+    int min_x = src.w;
+    int min_y = src.h;
+    int max_x = -1;
+    int max_y = -1;
+    for (int y = 0; y < src.h; y++) {
+      for (int x = 0; x < src.w; x++) {
+        // Alpha of the RGBA32 pixel
+        if (pixels[(src.y + y) * sheet->pitch + (src.x + x) * 4 + 3] != 0) {
+          min_x = std::min(min_x, x);
+          min_y = std::min(min_y, y);
+          max_x = std::max(max_x, x);
+          max_y = std::max(max_y, y);
+        }
+      }
+    }
+    const int area = src.w * src.h;
+    const int trimmed_area = (max_x < 0) ? 0 : (max_x - min_x + 1) * (max_y - min_y + 1);
+    total_pixels += area;
+    transparent_pixels += area - trimmed_area;
+  }
+  SDL_Log("Transparent borders: %zu of %zu sprite pixels (%.1f%%), kept (the sprites are placed with their full size)",
+          transparent_pixels, total_pixels, 100.0 * static_cast<double>(transparent_pixels) / static_cast<double>(total_pixels));
+}
+
+/**
+ * Rectangle packer (MaxRects, best short side fit).
+ * Keeps the maximal free rectangles of the bin. Each sprite goes to the free rectangle where it
+ * leaves the shortest leftover side, and the free rectangles that overlap it are split.
+ */
+class MaxRectsPacker {
+public:
+  MaxRectsPacker(const int width, const int height) : free_ {{0, 0, width, height}} {}
+
+  /** Place a rectangle, or return nullopt if it does not fit */
+  std::optional<SDL_Point> insert(const int width, const int height) {
+    const SDL_Rect* best = nullptr;
+    int best_short_side = max_atlas_size + 1;
+    int best_long_side = max_atlas_size + 1;
+    for (const SDL_Rect& rect : free_) {
+      if (rect.w < width || rect.h < height) {
+        continue;
+      }
+      const int short_side = std::min(rect.w - width, rect.h - height);
+      const int long_side = std::max(rect.w - width, rect.h - height);
+      if (short_side < best_short_side || (short_side == best_short_side && long_side < best_long_side)) {
+        best = &rect;
+        best_short_side = short_side;
+        best_long_side = long_side;
+      }
+    }
+    if (best == nullptr) {
+      return std::nullopt;
+    }
+    const SDL_Rect placed {best->x, best->y, width, height};
+    split(placed);
+    return SDL_Point {placed.x, placed.y};
+  }
+
+private:
+  std::vector<SDL_Rect> free_;
+
+  void split(const SDL_Rect& placed) {
+    std::vector<SDL_Rect> next;
+    next.reserve(free_.size() + 4);
+    for (const SDL_Rect& rect : free_) {
+      if (!SDL_HasRectIntersection(&rect, &placed)) {
+        next.push_back(rect);
+        continue;
+      }
+      // The parts of the free rectangle around the placed one (they may overlap each other)
+      if (placed.x > rect.x) {
+        next.push_back({rect.x, rect.y, placed.x - rect.x, rect.h});
+      }
+      if (placed.x + placed.w < rect.x + rect.w) {
+        next.push_back({placed.x + placed.w, rect.y, rect.x + rect.w - placed.x - placed.w, rect.h});
+      }
+      if (placed.y > rect.y) {
+        next.push_back({rect.x, rect.y, rect.w, placed.y - rect.y});
+      }
+      if (placed.y + placed.h < rect.y + rect.h) {
+        next.push_back({rect.x, placed.y + placed.h, rect.w, rect.y + rect.h - placed.y - placed.h});
+      }
+    }
+    // Remove the free rectangles contained in others
+    free_.clear();
+    for (std::size_t i = 0; i < next.size(); i++) {
+      const bool contained = std::ranges::any_of(next, [&](const SDL_Rect& other) {
+        const SDL_Rect& rect = next[i];
+        const bool inside = rect.x >= other.x && rect.y >= other.y &&
+                            rect.x + rect.w <= other.x + other.w && rect.y + rect.h <= other.y + other.h;
+        // Of two equal rectangles, keep the first one
+        const bool equal = SDL_RectsEqual(&rect, &other);
+        return inside && (!equal || &other < &rect);
+      });
+      if (!contained) {
+        free_.push_back(next[i]);
+      }
+    }
+  }
+};
+
+/** Smallest power of two not less than the value */
+int next_power_of_two(const int value) {
+  int power = 1;
+  while (power < value) {
+    power *= 2;
+  }
+  return power;
+}
+
+/**
+ * Pack the sprites into the atlas with the smallest area
+ * @param power_of_two Only atlas sizes with power-of-two sides
+ * @return The atlas size, or nullopt if they do not fit in the largest atlas
+ */
+std::optional<SDL_Point> pack(std::vector<Sprite>& sprites, const bool power_of_two) {
+  // Largest sprites first
+  std::vector<Sprite*> order;
+  for (Sprite& sprite : sprites) {
+    if (sprite.same_as < 0) {
+      order.push_back(&sprite);
+    }
+  }
+  std::ranges::stable_sort(order, [](const Sprite* a, const Sprite* b) {
+    const int side_a = std::max(a->src.w, a->src.h);
+    const int side_b = std::max(b->src.w, b->src.h);
+    return side_a > side_b || (side_a == side_b && a->src.w * a->src.h > b->src.w * b->src.h);
+  });
+
+  // Try every atlas width, with the height the sprites need
+  std::optional<SDL_Point> best_size;
+  std::vector<SDL_Rect> best_rects;
+  std::vector<SDL_Rect> rects(order.size());
+  for (int width = 64; width <= max_atlas_size; width = power_of_two ? width * 2 : width + 16) {
+    // The padding is added to the right and bottom of each sprite: the bin is extended by it
+    MaxRectsPacker packer(width + sprite_padding, max_atlas_size + sprite_padding);
+    int height = 0;
+    bool fits = true;
+    for (std::size_t i = 0; i < order.size() && fits; i++) {
+      const SDL_Rect& src = order[i]->src;
+      const std::optional<SDL_Point> position = packer.insert(src.w + sprite_padding, src.h + sprite_padding);
+      fits = position.has_value();
+      if (fits) {
+        rects[i] = {position->x, position->y, src.w, src.h};
+        height = std::max(height, position->y + src.h);
+      }
+    }
+    if (!fits) {
+      continue;
+    }
+    if (power_of_two) {
+      height = next_power_of_two(height);
+    }
+    // Smallest area, and the squarest of the same area
+    const auto area = static_cast<long>(width) * height;
+    if (!best_size || area < static_cast<long>(best_size->x) * best_size->y ||
+        (area == static_cast<long>(best_size->x) * best_size->y && std::abs(width - height) < std::abs(best_size->x - best_size->y))) {
+      best_size = SDL_Point {width, height};
+      best_rects = rects;
+    }
+  }
+  if (!best_size) {
+    return std::nullopt;
+  }
+
+  for (std::size_t i = 0; i < order.size(); i++) {
+    order[i]->dst = best_rects[i];
+  }
+  for (Sprite& sprite : sprites) {
+    if (sprite.same_as >= 0) {
+      sprite.dst = sprites[sprite.same_as].dst;
+    }
+  }
+  return best_size;
+}
+
+bool write_atlas(SDL_Surface* sheet, const std::vector<Sprite>& sprites, const SDL_Point& size, const char* output_filename) {
+  const baked::SDL_Surface_ptr atlas {SDL_CreateSurface(size.x, size.y, SDL_PIXELFORMAT_RGBA32), SDL_DestroySurface};
+  if (!atlas) {
+    SDL_Log("Unable to create the sprite atlas! SDL Error: %s\n", SDL_GetError());
+    return false;
+  }
+  SDL_ClearSurface(atlas.get(), 0.0f, 0.0f, 0.0f, 0.0f);
+  SDL_SetSurfaceBlendMode(sheet, SDL_BLENDMODE_NONE);
+  for (const Sprite& sprite : sprites) {
+    SDL_Rect dst = sprite.dst;
+    SDL_BlitSurface(sheet, &sprite.src, atlas.get(), &dst);
+  }
+  if (!SDL_SavePNG(atlas.get(), output_filename)) {
+    SDL_Log("Unable to write %s! SDL Error: %s\n", output_filename, SDL_GetError());
+    return false;
+  }
+  return true;
+}
+
+bool write_header(const Manifest& manifest, const std::string& description, const char* output_filename) {
+  std::string header = std::format(R"(#ifndef PIKA_SPRITES_HPP
+#define PIKA_SPRITES_HPP
+
+#include "SDL3/SDL_rect.h"
+#include <array>
+
+/**
+ * Pixel locations and sizes of the sprites in the {}.
+ * Generated by pikaball_atlas from assets/images/sprites.txt: do not edit.
+ */
+
+namespace pika::sprite {{
+)", description);
+
+  for (const Item& item : manifest.items) {
+    switch (item.type) {
+    case Item::Type::Section:
+      header += std::format("\n/** {} **/\n", item.text);
+      break;
+    case Item::Type::Comment:
+      header += std::format("\n{}", item.text);
+      break;
+    case Item::Type::Sprite: {
+      const SDL_Rect& rect = manifest.sprites[item.sprites.front()].dst;
+      header += std::format("\nconstexpr SDL_FRect {} {{\n  .x = {},\n  .y = {},\n  .w = {},\n  .h = {}\n}};\n",
+                            item.text, rect.x, rect.y, rect.w, rect.h);
+      break;
+    }
+    case Item::Type::Array:
+      header += std::format("\nconstexpr std::array {} {{\n", item.text);
+      for (const std::size_t sprite : item.sprites) {
+        header += std::format("  {},\n", manifest.sprites[sprite].name);
+      }
+      header += "};\n";
+      break;
+    }
+  }
+  header += "\n} // end namespace pika::sprite\n\n#endif //PIKA_SPRITES_HPP\n";
+
+  std::ofstream output(output_filename, std::ios::binary);
+  output << header;
+  if (!output) {
+    SDL_Log("Unable to write %s", output_filename);
+    return false;
+  }
+  return true;
+}
+
+/** Generate the header with the rects of the sprite sheet, without packing an atlas */
+bool generate_sheet_header(const char* manifest_filename, const char* header_filename) {
+  std::optional<Manifest> manifest = read_manifest(manifest_filename);
+  if (!manifest) {
+    return false;
+  }
+  for (Sprite& sprite : manifest->sprites) {
+    sprite.dst = sprite.src;
+  }
+  return write_header(*manifest, "sprite sheet", header_filename);
+}
+
+bool generate_atlas(const char* manifest_filename, const char* sheet_filename,
+                    const char* atlas_filename, const char* header_filename, const bool power_of_two) {
+  std::optional<Manifest> manifest = read_manifest(manifest_filename);
+  if (!manifest) {
+    return false;
+  }
+  const baked::SDL_Surface_ptr loaded {SDL_LoadPNG_IO(SDL_IOFromFile(sheet_filename, "rb"), true), SDL_DestroySurface};
+  if (!loaded) {
+    SDL_Log("Unable to load image %s! SDL Error: %s\n", sheet_filename, SDL_GetError());
+    return false;
+  }
+  const baked::SDL_Surface_ptr sheet {SDL_ConvertSurface(loaded.get(), SDL_PIXELFORMAT_RGBA32), SDL_DestroySurface};
+  if (!sheet) {
+    SDL_Log("Unable to convert the sprite sheet! SDL Error: %s\n", SDL_GetError());
+    return false;
+  }
+  for (const Sprite& sprite : manifest->sprites) {
+    if (sprite.src.x < 0 || sprite.src.y < 0 ||
+        sprite.src.x + sprite.src.w > sheet->w || sprite.src.y + sprite.src.h > sheet->h) {
+      SDL_Log("The sprite %s is out of the sprite sheet", sprite.name.c_str());
+      return false;
+    }
+  }
+
+  find_duplicates(sheet.get(), manifest->sprites);
+  report_transparent_borders(sheet.get(), manifest->sprites);
+  const std::optional<SDL_Point> size = pack(manifest->sprites, power_of_two);
+  if (!size) {
+    SDL_Log("The sprites do not fit in a %dx%d atlas", max_atlas_size, max_atlas_size);
+    return false;
+  }
+  const auto unique_sprites = std::ranges::count_if(manifest->sprites, [](const Sprite& sprite) {
+    return sprite.same_as < 0;
+  });
+  SDL_Log("Sprite atlas: %zu sprites (%td unique) in %dx%d (sprite sheet: %dx%d)",
+          manifest->sprites.size(), unique_sprites, size->x, size->y, sheet->w, sheet->h);
+  return write_atlas(sheet.get(), manifest->sprites, *size, atlas_filename) &&
+         write_header(*manifest, std::format("sprite atlas ({}x{})", size->x, size->y), header_filename);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const bool power_of_two = argc > 1 && std::strcmp(argv[1], "--power-of-two") == 0;
+  if (power_of_two) {
+    argc--;
+    argv++;
+  }
+  if ((argc != 3 || power_of_two) && argc != 5) {
+    SDL_Log("Usage: %s [--power-of-two] sprites.txt sprite_sheet.png atlas.png sprites.hpp", argv[0]);
+    SDL_Log("       %s sprites.txt sprites.hpp", argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (argc == 3) {
+    return generate_sheet_header(argv[1], argv[2]) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  if (!SDL_Init(0)) {
+    SDL_Log("Failed to init SDL! SDL Error: %s\n", SDL_GetError());
+    return EXIT_FAILURE;
+  }
+  const bool success = generate_atlas(argv[1], argv[2], argv[3], argv[4], power_of_two);
+  SDL_Quit();
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,145 @@
+/**
+ * Asset baker (build time host tool).
+ * Converts the sprite sheet to raw pixels in the texture format, and rasterizes the text font
+ * into a glyph atlas, so the game can upload them without decoding (see baked_assets.hpp).
+ *
+ * Usage: pikaball_bake sprite_sheet.png font.ttf sprite_sheet.bin font.bin
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <SDL3_ttf/SDL_ttf.h>
+#include <pikaball/baked_assets.hpp>
+#include <pikaball/common.hpp>
+
+using namespace pika;
+
+namespace {
+
+// Width of the font atlas. The glyphs are placed in rows (all of them have the same height)
+constexpr int atlas_width = 512;
+// Empty pixels between glyphs, so they never bleed into each other when scaled
+constexpr int glyph_padding = 1;
+
+bool bake_sprite_sheet(const char* input_filename, const char* output_filename) {
+  const baked::SDL_Surface_ptr sprites {SDL_LoadPNG_IO(SDL_IOFromFile(input_filename, "rb"), true), SDL_DestroySurface};
+  if (!sprites) {
+    SDL_Log("Unable to load image %s! SDL Error: %s\n", input_filename, SDL_GetError());
+    return false;
+  }
+  SDL_IOStream* output = SDL_IOFromFile(output_filename, "wb");
+  const bool written = output != nullptr && baked::write_image(output, sprites.get());
+  if (output != nullptr && !SDL_CloseIO(output)) {
+    return false;
+  }
+  if (!written) {
+    SDL_Log("Unable to write %s! SDL Error: %s\n", output_filename, SDL_GetError());
+  }
+  return written;
+}
+
+bool bake_font(const char* input_filename, const char* output_filename) {
+  TTF_Font* ttf = TTF_OpenFontIO(SDL_IOFromFile(input_filename, "rb"), true, text_font_size);
+  if (ttf == nullptr) {
+    SDL_Log("Could not load TTF font %s! SDL_ttf error: %s\n", input_filename, SDL_GetError());
+    return false;
+  }
+
+  // Rasterize every glyph in white (the game tints them) and place them in rows
+  baked::Font font;
+  font.height = TTF_GetFontHeight(ttf);
+  std::vector<baked::SDL_Surface_ptr> surfaces;
+  surfaces.reserve(baked::num_glyphs);
+  int x = 0;
+  int y = 0;
+  int row_height = 0;
+  for (std::size_t i = 0; i < baked::num_glyphs; i++) {
+    const auto c = static_cast<Uint32>(baked::first_glyph + i);
+    int advance = 0;
+    TTF_GetGlyphMetrics(ttf, c, nullptr, nullptr, nullptr, nullptr, &advance);
+    baked::Glyph& glyph = font.glyphs[i];
+    glyph.advance = static_cast<Uint16>(advance);
+    surfaces.emplace_back(nullptr, SDL_DestroySurface);
+
+    // Glyphs without pixels (space) only have an advance
+    SDL_Surface* surface = TTF_RenderGlyph_Solid(ttf, c, {255, 255, 255, 255});
+    if (surface == nullptr || surface->w == 0) {
+      SDL_DestroySurface(surface);
+      continue;
+    }
+    surfaces[i].reset(SDL_ConvertSurface(surface, baked::pixel_format));
+    SDL_DestroySurface(surface);
+    if (!surfaces[i]) {
+      SDL_Log("Unable to convert glyph %c! SDL Error: %s\n", static_cast<char>(c), SDL_GetError());
+      TTF_CloseFont(ttf);
+      return false;
+    }
+    if (x + surfaces[i]->w > atlas_width) {
+      x = 0;
+      y += row_height + glyph_padding;
+      row_height = 0;
+    }
+    glyph.x = static_cast<Uint16>(x);
+    glyph.y = static_cast<Uint16>(y);
+    glyph.w = static_cast<Uint16>(surfaces[i]->w);
+    glyph.h = static_cast<Uint16>(surfaces[i]->h);
+    x += surfaces[i]->w + glyph_padding;
+    row_height = std::max(row_height, surfaces[i]->h);
+  }
+  // Kerning of every pair of characters, applied by TTF_RenderText_Solid() between their glyphs
+  for (char left = baked::first_glyph; left <= baked::last_glyph; left++) {
+    for (char right = baked::first_glyph; right <= baked::last_glyph; right++) {
+      int kerning = 0;
+      if (TTF_GetGlyphKerning(ttf, static_cast<Uint32>(left), static_cast<Uint32>(right), &kerning) && kerning != 0) {
+        font.kerning_pairs.push_back({left, right, static_cast<Sint16>(kerning)});
+      }
+    }
+  }
+  TTF_CloseFont(ttf);
+
+  // Copy the glyphs to a transparent atlas
+  font.atlas.reset(SDL_CreateSurface(atlas_width, y + row_height, baked::pixel_format));
+  if (!font.atlas) {
+    SDL_Log("Unable to create the font atlas! SDL Error: %s\n", SDL_GetError());
+    return false;
+  }
+  SDL_ClearSurface(font.atlas.get(), 0.0f, 0.0f, 0.0f, 0.0f);
+  for (std::size_t i = 0; i < baked::num_glyphs; i++) {
+    if (!surfaces[i]) {
+      continue;
+    }
+    const baked::Glyph& glyph = font.glyphs[i];
+    SDL_Rect dst {glyph.x, glyph.y, glyph.w, glyph.h};
+    SDL_SetSurfaceBlendMode(surfaces[i].get(), SDL_BLENDMODE_NONE);
+    SDL_BlitSurface(surfaces[i].get(), nullptr, font.atlas.get(), &dst);
+  }
+
+  SDL_IOStream* output = SDL_IOFromFile(output_filename, "wb");
+  const bool written = output != nullptr && baked::write_font(output, font);
+  if (output != nullptr && !SDL_CloseIO(output)) {
+    return false;
+  }
+  if (!written) {
+    SDL_Log("Unable to write %s! SDL Error: %s\n", output_filename, SDL_GetError());
+  }
+  return written;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 5) {
+    SDL_Log("Usage: %s sprite_sheet.png font.ttf sprite_sheet.bin font.bin", argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (!SDL_Init(0) || !TTF_Init()) {
+    SDL_Log("Failed to init SDL! SDL Error: %s\n", SDL_GetError());
+    return EXIT_FAILURE;
+  }
+  const bool success = bake_sprite_sheet(argv[1], argv[3]) && bake_font(argv[2], argv[4]);
+  TTF_Quit();
+  SDL_Quit();
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,610 @@
+/**
+ * Benchmark suite for the hot paths of the game.
+ * Micro benchmarks of the physics and the AI, full headless matches, and the rendering of the
+ * volley field with both renderers, all offscreen (no window).
+ *
+ * Each benchmark is calibrated so a sample takes at least --min-time, warmed up, and then
+ * sampled --repetitions times. The results are the median and the median absolute deviation
+ * (MAD) of the time per operation, which are stable against outliers (e.g. preemption).
+ *
+ * With --counters, each benchmark runs one more sample with the hardware performance counters
+ * (Linux only, see perf_counters.hpp), and reports the cycles, IPC, branch misses and cache misses
+ * per operation (e.g. per simulated frame).
+ *
+ * Usage: pikaball_bench [options]
+ *   --filter text        Only run the benchmarks whose name contains the text
+ *   --repetitions n      Number of samples of each benchmark (default: 15)
+ *   --min-time ms        Minimum duration of each sample (default: 20 ms)
+ *   --json file          Write the results as JSON
+ *   --baseline file      Compare against the JSON results of a previous run.
+ *                        Exits with an error if any benchmark is slower than the baseline
+ *   --threshold percent  Slowdown tolerated before reporting a regression (default: 5)
+ *   --counters           Also measure the hardware performance counters
+ */
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <pikaball/controller/computer_controller.hpp>
+#include <pikaball/perf_counters.hpp>
+#include <pikaball/physics/physics.hpp>
+#include <pikaball/physics/trajectory_batch.hpp>
+#include <pikaball/resources.hpp>
+
+#include "view/render_resources.hpp"
+#include "view/software_volley_view.hpp"
+#include "view/volley_view.hpp"
+
+using namespace pika;
+
+namespace {
+
+/** Keep the compiler from optimizing away a value that is never used */
+template <typename T>
+void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+/** A benchmark runs its operation a given number of times */
+struct Benchmark {
+  std::string name;
+  // Name of one operation (for the report)
+  std::string unit;
+  std::function<void(std::size_t)> run;
+};
+
+struct Result {
+  std::string name;
+  std::string unit;
+  std::size_t iterations {0};
+  std::size_t samples {0};
+  // Time per operation
+  double median_ns {0.0};
+  double mad_ns {0.0};
+  double min_ns {0.0};
+  // Hardware counters per operation (if measured)
+  std::optional<PerfCounts> counters;
+};
+
+struct Options {
+  std::string filter;
+  std::size_t repetitions {15};
+  Uint64 min_sample_ns {20'000'000};
+  std::string json_filename;
+  std::string baseline_filename;
+  double threshold {0.05};
+  bool counters {false};
+};
+
+double median(std::vector<double> values) {
+  std::ranges::sort(values);
+  const std::size_t middle = values.size() / 2;
+  return (values.size() % 2 == 1) ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+}
+
+/** Time per operation of a single sample */
+double sample(const Benchmark& benchmark, const std::size_t iterations) {
+  const Uint64 start_time = SDL_GetTicksNS();
+  benchmark.run(iterations);
+  return static_cast<double>(SDL_GetTicksNS() - start_time) / static_cast<double>(iterations);
+}
+
+Result measure(const Benchmark& benchmark, const Options& options, PerfCounters* counters) {
+  // Calibration: double the iterations until a sample is long enough. This is also the warmup
+  std::size_t iterations = 1;
+  while (true) {
+    const Uint64 start_time = SDL_GetTicksNS();
+    benchmark.run(iterations);
+    const Uint64 elapsed_time = SDL_GetTicksNS() - start_time;
+    if (elapsed_time >= options.min_sample_ns) {
+      break;
+    }
+    // Jump close to the target if the sample is not too short to be trusted
+    iterations = (elapsed_time > options.min_sample_ns / 10)
+      ? static_cast<std::size_t>(static_cast<double>(iterations) * 1.2 * static_cast<double>(options.min_sample_ns) / static_cast<double>(elapsed_time))
+      : iterations * 2;
+  }
+
+  std::vector<double> times;
+  times.reserve(options.repetitions);
+  for (std::size_t i = 0; i < options.repetitions; i++) {
+    times.push_back(sample(benchmark, iterations));
+  }
+
+  Result result {
+    .name = benchmark.name,
+    .unit = benchmark.unit,
+    .iterations = iterations,
+    .samples = times.size(),
+    .median_ns = median(times),
+    .min_ns = std::ranges::min(times),
+  };
+  std::vector<double> deviations;
+  deviations.reserve(times.size());
+  for (const double time : times) {
+    deviations.push_back(std::abs(time - result.median_ns));
+  }
+  result.mad_ns = median(deviations);
+
+  // The counters are read in a separate sample, so their overhead does not affect the timings
+  if (counters != nullptr) {
+    counters->start();
+    benchmark.run(iterations);
+    result.counters = counters->stop().per(static_cast<double>(iterations));
+  }
+  return result;
+}
+
+/* Benchmarks */
+
+/** Input of a player that moves and jumps around (same sequence in every run) */
+PlayerInput scripted_input(const std::size_t frame) {
+  const auto direction_x = static_cast<DirX>(static_cast<int>(frame / 20 % 3) - 1);
+  const DirY direction_y = (frame % 37 == 0) ? DirY::Up : DirY::None;
+  return {direction_x, direction_y, frame % 53 == 0};
+}
+
+/**
+ * Play a computer vs computer match until one of the players wins
+ * @return The number of frames of the match
+ */
+template <PhysicsRules Rules>
+std::size_t play_match(Physics<Rules>& physics, ComputerController& left, ComputerController& right) {
+  constexpr int win_score = 15;
+  int score_left = 0;
+  int score_right = 0;
+  std::size_t frames = 0;
+  physics.restart();
+  physics.init_round(FieldSide::Left);
+  left.on_round_start(PhysicsView(physics));
+  right.on_round_start(PhysicsView(physics));
+  while (score_left < win_score && score_right < win_score) {
+    const PlayerInput input_left = left.on_update(PhysicsView(physics));
+    const PlayerInput input_right = right.on_update(PhysicsView(physics));
+    frames++;
+    if (physics.update(input_left, input_right)) {
+      // Same scoring as Game::update_score()
+      const FieldSide serve_side = physics.ball().punch_effect_x() < ground_h_width ? FieldSide::Right : FieldSide::Left;
+      (serve_side == FieldSide::Left ? score_left : score_right)++;
+      physics.init_round(serve_side);
+      left.on_round_start(PhysicsView(physics));
+      right.on_round_start(PhysicsView(physics));
+    }
+  }
+  return frames;
+}
+
+/** States of a computer vs computer rally, to feed the AI and the views with real game situations */
+std::vector<PhysicsView> record_rally(const std::size_t frames) {
+  Physics<> physics;
+  ComputerController left {FieldSide::Left};
+  ComputerController right {FieldSide::Right};
+  std::vector<PhysicsView> states;
+  states.reserve(frames);
+  physics.init_round(FieldSide::Left);
+  while (states.size() < frames) {
+    states.emplace_back(physics);
+    const PlayerInput input_left = left.on_update(states.back());
+    const PlayerInput input_right = right.on_update(states.back());
+    if (physics.update(input_left, input_right)) {
+      physics.init_round(FieldSide::Left);
+    }
+  }
+  return states;
+}
+
+std::vector<Benchmark> physics_benchmarks() {
+  std::vector<Benchmark> benchmarks;
+
+  benchmarks.push_back({"ball_update", "frame", [](const std::size_t iterations) {
+    Ball ball;
+    PhysicsEventQueue events;
+    ball.initialize(FieldSide::Left);
+    for (std::size_t i = 0; i < iterations; i++) {
+      events.clear();
+      if (ball.update(events)) {
+        ball.initialize(i % 2 == 0 ? FieldSide::Left : FieldSide::Right);
+      }
+      do_not_optimize(ball.state());
+    }
+  }});
+
+  benchmarks.push_back({"ball_calculate_landing_point", "prediction", [](const std::size_t iterations) {
+    Ball ball;
+    ball.initialize(FieldSide::Left);
+    for (std::size_t i = 0; i < iterations; i++) {
+      // A different fast shot each time, so the prediction bounces on the walls and the net
+      ball.set_velocity_x(static_cast<int>(i % 41) - 20);
+      ball.set_velocity_y(-static_cast<int>(i % 17));
+      ball.calculate_landing_point();
+      do_not_optimize(ball.expected_landing_x());
+    }
+  }});
+
+  // The six power hit candidates of the computer, one by one and with the multi-lane kernel.
+  // The computer checks them one by one and stops at the first good one (2.9 on average):
+  // predict_landings() only pays off if it is faster than about half of the serial loop.
+  const auto power_hit_candidates = [](const std::size_t i) {
+    BallState ball;
+    ball.x = 40 + static_cast<int>(i * 7 % 150);
+    ball.y = 80 + static_cast<int>(i * 13 % 150);
+    std::array<BallState, 6> candidates {};
+    for (std::size_t c = 0; c < candidates.size(); c++) {
+      candidates[c] = ball;
+      candidates[c].velocity_x = c < 3 ? 20 : 10;
+      candidates[c].velocity_y = 2 * static_cast<int>(i % 17) * (static_cast<int>(c % 3) - 1);
+    }
+    return candidates;
+  };
+
+  benchmarks.push_back({"power_hit_candidates_serial", "6 predictions", [power_hit_candidates](const std::size_t iterations) {
+    for (std::size_t i = 0; i < iterations; i++) {
+      for (const BallState& candidate : power_hit_candidates(i)) {
+        do_not_optimize(predict_landing(candidate));
+      }
+    }
+  }});
+
+  benchmarks.push_back({"power_hit_candidates_batch", "6 predictions", [power_hit_candidates](const std::size_t iterations) {
+    for (std::size_t i = 0; i < iterations; i++) {
+      do_not_optimize(predict_landings(power_hit_candidates(i)));
+    }
+  }});
+
+  benchmarks.push_back({"player_update", "frame", [](const std::size_t iterations) {
+    Player player {FieldSide::Left};
+    PhysicsEventQueue events;
+    player.initialize_game();
+    for (std::size_t i = 0; i < iterations; i++) {
+      events.clear();
+      player.update(scripted_input(i), events);
+      do_not_optimize(player);
+    }
+  }});
+
+  benchmarks.push_back({"physics_update", "frame", [](const std::size_t iterations) {
+    Physics<> physics;
+    physics.init_round(FieldSide::Left);
+    for (std::size_t i = 0; i < iterations; i++) {
+      if (physics.update(scripted_input(i), scripted_input(i + 29))) {
+        physics.init_round(FieldSide::Left);
+      }
+      do_not_optimize(physics.ball().state());
+    }
+  }});
+
+  benchmarks.push_back({"computer_controller_on_update", "frame",
+    [states = record_rally(2000)](const std::size_t iterations) {
+      ComputerController left {FieldSide::Left};
+      ComputerController right {FieldSide::Right};
+      for (std::size_t i = 0; i < iterations; i++) {
+        const PhysicsView& state = states[i % states.size()];
+        do_not_optimize(left.on_update(state));
+        do_not_optimize(right.on_update(state));
+      }
+    }});
+
+  benchmarks.push_back({"match", "match", [](const std::size_t iterations) {
+    Physics<> physics;
+    ComputerController left {FieldSide::Left};
+    ComputerController right {FieldSide::Right};
+    for (std::size_t i = 0; i < iterations; i++) {
+      do_not_optimize(play_match(physics, left, right));
+    }
+  }});
+
+  // Same match without the cosmetic state (nothing is rendered)
+  benchmarks.push_back({"headless_match", "match", [](const std::size_t iterations) {
+    Physics<HeadlessRules> physics;
+    ComputerController left {FieldSide::Left};
+    ComputerController right {FieldSide::Right};
+    for (std::size_t i = 0; i < iterations; i++) {
+      do_not_optimize(play_match(physics, left, right));
+    }
+  }});
+
+  return benchmarks;
+}
+
+/** Offscreen renderers and views (created once, shared by the render benchmarks) */
+struct RenderContext {
+  SDL_Surface* surface {nullptr};
+  SDL_Renderer* renderer {nullptr};
+  SDL_Texture* frame_target {nullptr};
+  SDL_Texture* sprite_sheet {nullptr};
+  std::unique_ptr<view::RenderResources> resources;
+  std::unique_ptr<view::SoftwareRenderer> software_renderer;
+
+  RenderContext() = default;
+  ~RenderContext() {
+    software_renderer.reset();
+    resources.reset();
+    SDL_DestroyTexture(sprite_sheet);
+    SDL_DestroyTexture(frame_target);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroySurface(surface);
+  }
+  RenderContext(RenderContext const&) = delete;
+  RenderContext(RenderContext &&) = delete;
+  RenderContext &operator=(RenderContext const&) = delete;
+  RenderContext &operator=(RenderContext &&) = delete;
+
+  bool init() {
+    SDL_IOStream* sprites_data = find_resource(sprite_sheet_filename);
+    SDL_Surface* sprites_surface = (sprites_data != nullptr) ? SDL_LoadPNG_IO(sprites_data, true) : nullptr;
+    if (sprites_surface == nullptr) {
+      SDL_Log("Unable to load image %s! SDL Error: %s\n", sprite_sheet_filename, SDL_GetError());
+      return false;
+    }
+    software_renderer = std::make_unique<view::SoftwareRenderer>(sprites_surface);
+
+    // SDL renderer drawing into a surface, with the same frame target as SDLSystem
+    surface = SDL_CreateSurface(screen_width, screen_height, SDL_PIXELFORMAT_ARGB8888);
+    renderer = (surface != nullptr) ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+    if (renderer != nullptr) {
+      sprite_sheet = SDL_CreateTextureFromSurface(renderer, sprites_surface);
+      frame_target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                       screen_width, screen_height);
+    }
+    SDL_DestroySurface(sprites_surface);
+    if (sprite_sheet == nullptr || frame_target == nullptr) {
+      SDL_Log("Unable to create the offscreen renderer! SDL Error: %s\n", SDL_GetError());
+      return false;
+    }
+    SDL_SetTextureScaleMode(sprite_sheet, SDL_SCALEMODE_NEAREST);
+    SDL_SetTextureScaleMode(frame_target, SDL_SCALEMODE_NEAREST);
+    SDL_SetRenderTarget(renderer, frame_target);
+    resources = std::make_unique<view::RenderResources>(renderer);
+    return true;
+  }
+};
+
+std::vector<Benchmark> render_benchmarks(RenderContext& context) {
+  std::vector<Benchmark> benchmarks;
+  const auto states = std::make_shared<std::vector<PhysicsView>>(record_rally(500));
+
+  benchmarks.push_back({"volley_view_render", "frame", [&context, states](const std::size_t iterations) {
+    view::VolleyView view(context.renderer, context.sprite_sheet, context.resources.get());
+    view.start();
+    view.set_state(VolleyGameState::PlayRound);
+    view.set_score(7, 12);
+    for (std::size_t i = 0; i < iterations; i++) {
+      view.render(static_cast<unsigned int>(i), (*states)[i % states->size()]);
+      // The renderer batches the draw calls: draw them now
+      SDL_FlushRenderer(context.renderer);
+    }
+  }});
+
+  benchmarks.push_back({"software_volley_view_render", "frame", [&context, states](const std::size_t iterations) {
+    view::SoftwareVolleyView view(*context.software_renderer);
+    view.start();
+    view.set_state(VolleyGameState::PlayRound);
+    view.set_score(7, 12);
+    for (std::size_t i = 0; i < iterations; i++) {
+      view.render(static_cast<unsigned int>(i), (*states)[i % states->size()]);
+      do_not_optimize(context.software_renderer->pixels());
+    }
+  }});
+
+  return benchmarks;
+}
+
+/* Reports */
+
+void write_json(const std::string& filename, const std::vector<Result>& results) {
+  std::FILE* file = std::fopen(filename.c_str(), "w");
+  if (file == nullptr) {
+    SDL_Log("Unable to write %s", filename.c_str());
+    return;
+  }
+  std::fprintf(file, "{\n  \"benchmarks\": [\n");
+  for (std::size_t i = 0; i < results.size(); i++) {
+    const Result& result = results[i];
+    std::fprintf(file,
+      "    {\"name\": \"%s\", \"unit\": \"%s\", \"iterations\": %zu, \"samples\": %zu, "
+      "\"median_ns\": %.3f, \"mad_ns\": %.3f, \"min_ns\": %.3f%s",
+      result.name.c_str(), result.unit.c_str(), result.iterations, result.samples,
+      result.median_ns, result.mad_ns, result.min_ns, result.counters ? ",\n" : "");
+    if (result.counters) {
+      std::fprintf(file, "     \"counters\": {");
+      for (std::size_t event = 0; event < num_perf_events; event++) {
+        if (result.counters->available[event]) {
+          std::fprintf(file, "\"%s\": %.3f, ", perf_event_names[event], result.counters->values[event]);
+        }
+      }
+      std::fprintf(file, "\"ipc\": %.3f}", result.counters->ipc());
+    }
+    std::fprintf(file, "}%s\n", (i + 1 < results.size()) ? "," : "");
+  }
+  std::fprintf(file, "  ]\n}\n");
+  std::fclose(file);
+}
+
+/**
+ * Read the results of a previous run (the JSON written by write_json)
+ * @return Median and MAD of each benchmark, by name, or nullopt if the file cannot be read or has no results
+ */
+std::optional<std::map<std::string, std::pair<double, double>>> read_baseline(const std::string& filename) {
+  std::map<std::string, std::pair<double, double>> baseline;
+  std::ifstream file(filename);
+  if (!file) {
+    SDL_Log("Unable to open the baseline %s", filename.c_str());
+    return std::nullopt;
+  }
+  const std::string json {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  const auto number_after = [&json](const std::string& key, const std::size_t from) {
+    const std::size_t position = json.find(key, from);
+    return (position == std::string::npos) ? 0.0 : std::strtod(json.c_str() + position + key.size(), nullptr);
+  };
+  constexpr std::string_view name_key = "\"name\": \"";
+  for (std::size_t position = json.find(name_key); position != std::string::npos; position = json.find(name_key, position)) {
+    position += name_key.size();
+    const std::size_t end = json.find('"', position);
+    if (end == std::string::npos) {
+      break;
+    }
+    baseline[json.substr(position, end - position)] = {number_after("\"median_ns\": ", end), number_after("\"mad_ns\": ", end)};
+  }
+  if (baseline.empty()) {
+    SDL_Log("The baseline %s has no benchmark results", filename.c_str());
+    return std::nullopt;
+  }
+  return baseline;
+}
+
+/** Human-readable time (ns, us or ms) */
+std::string format_time(const double ns) {
+  char buffer[32];
+  if (ns >= 1e6) {
+    std::snprintf(buffer, sizeof(buffer), "%.3f ms", ns / 1e6);
+  } else if (ns >= 1e3) {
+    std::snprintf(buffer, sizeof(buffer), "%.3f us", ns / 1e3);
+  } else {
+    std::snprintf(buffer, sizeof(buffer), "%.1f ns", ns);
+  }
+  return buffer;
+}
+
+/** Print the counters per operation (n/a if the event is not available) */
+void print_counters(const PerfCounts& counts, const std::string& unit) {
+  std::printf("%32s", "");
+  for (std::size_t event = 0; event < num_perf_events; event++) {
+    if (counts.available[event]) {
+      std::printf(" %s %.1f", perf_event_names[event], counts.values[event]);
+    } else {
+      std::printf(" %s n/a", perf_event_names[event]);
+    }
+  }
+  std::printf(" | IPC %.2f (per %s)\n", counts.ipc(), unit.c_str());
+}
+
+bool parse_options(const int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    const std::string option = argv[i];
+    if (option == "--counters") {
+      options.counters = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      return false;
+    }
+    const char* value = argv[++i];
+    if (option == "--filter") {
+      options.filter = value;
+    } else if (option == "--repetitions") {
+      options.repetitions = std::max(std::strtoul(value, nullptr, 10), 1ul);
+    } else if (option == "--min-time") {
+      options.min_sample_ns = std::max<Uint64>(std::strtoull(value, nullptr, 10), 1) * 1'000'000;
+    } else if (option == "--json") {
+      options.json_filename = value;
+    } else if (option == "--baseline") {
+      options.baseline_filename = value;
+    } else if (option == "--threshold") {
+      options.threshold = std::strtod(value, nullptr) / 100.0;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parse_options(argc, argv, options)) {
+    SDL_Log("Usage: %s [--filter text] [--repetitions n] [--min-time ms] [--json file] "
+            "[--baseline file] [--threshold percent] [--counters]", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  RenderContext render_context;
+  std::vector<Benchmark> benchmarks = physics_benchmarks();
+  if (render_context.init()) {
+    std::ranges::move(render_benchmarks(render_context), std::back_inserter(benchmarks));
+  } else {
+    SDL_Log("Skipping the render benchmarks");
+  }
+
+  std::unique_ptr<PerfCounters> counters;
+  if (options.counters) {
+    counters = std::make_unique<PerfCounters>();
+    if (!counters->is_available()) {
+      SDL_Log("The hardware performance counters are not available (Linux only, check perf_event_paranoid)");
+      counters.reset();
+    }
+  }
+
+  // Read the baseline first: without it, the regressions would not be detected
+  std::map<std::string, std::pair<double, double>> baseline;
+  if (!options.baseline_filename.empty()) {
+    auto baseline_results = read_baseline(options.baseline_filename);
+    if (!baseline_results) {
+      return EXIT_FAILURE;
+    }
+    baseline = std::move(*baseline_results);
+  }
+
+  std::vector<Result> results;
+  std::printf("%-32s %14s %12s %8s\n", "Benchmark", "Median", "MAD", "Samples");
+  for (const auto& benchmark : benchmarks) {
+    if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+    const Result& result = results.emplace_back(measure(benchmark, options, counters.get()));
+    std::printf("%-32s %14s %12s %8zu  (per %s, %.0f/s)\n",
+      result.name.c_str(), format_time(result.median_ns).c_str(), format_time(result.mad_ns).c_str(),
+      result.samples, result.unit.c_str(), 1e9 / result.median_ns);
+    if (result.counters) {
+      print_counters(*result.counters, result.unit);
+    }
+  }
+
+  if (!options.json_filename.empty()) {
+    write_json(options.json_filename, results);
+  }
+
+  if (options.baseline_filename.empty()) {
+    return EXIT_SUCCESS;
+  }
+  // A regression is a slowdown over the threshold that is also larger than the noise of both runs
+  int regressions = 0;
+  std::printf("\nComparison with %s\n", options.baseline_filename.c_str());
+  for (const auto& result : results) {
+    const auto entry = baseline.find(result.name);
+    if (entry == baseline.end() || entry->second.first <= 0.0) {
+      std::printf("%-32s %14s\n", result.name.c_str(), "new");
+      continue;
+    }
+    const auto [base_median, base_mad] = entry->second;
+    const double change = result.median_ns / base_median - 1.0;
+    const double noise = 3.0 * std::max(result.mad_ns, base_mad);
+    const bool regression = change > options.threshold && result.median_ns - base_median > noise;
+    regressions += regression ? 1 : 0;
+    std::printf("%-32s %+13.1f%%%s\n", result.name.c_str(), change * 100.0, regression ? "  REGRESSION" : "");
+  }
+  if (regressions > 0) {
+    SDL_Log("%d benchmarks are slower than the baseline", regressions);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -1,5 +1,6 @@
 #include "pikaball/controller/computer_controller.hpp"
 #include <pikaball/random.hpp>
+#include <pikaball/trace.hpp>
 
 namespace pika {
 
@@ -26,21 +27,20 @@ int estimate_ball_hit_landing(const PlayerInput& input, const Ball& ball) {
   // First, estimate the velocity after the power hit.
   // This code is the same from the Ball physics
   // Base velocity is halved if no direction is pressed when power hitting
-  int velocity_x = input.direction_x == DirX::None ? 10 : 20;
+  constexpr int hit_velocity_x = OriginalRules::power_hit_velocity_x;
+  int velocity_x = input.direction_x == DirX::None ? hit_velocity_x / 2 : hit_velocity_x;
   if (ball.x() >= ground_h_width) {
     velocity_x = - velocity_x;
   }
   const int velocity_y = 2 * std::abs(ball.velocity_y()) * static_cast<int>(input.direction_y);
 
-  // Clone the ball object
-  Ball ball_clone = ball;
+  // Clone only the ball simulation state
+  BallState hit_state = ball.state();
   // Set the velocities after the power hit
-  ball_clone.set_velocity_x(velocity_x);
-  ball_clone.set_velocity_y(velocity_y);
+  hit_state.velocity_x = velocity_x;
+  hit_state.velocity_y = velocity_y;
   // Estimate the new landing point
-  ball_clone.calculate_landing_point();
-
-  return ball_clone.expected_landing_x();
+  return predict_landing(hit_state).x;
 }
 
 bool ComputerController::decide_input_power_hit(const PhysicsView& physics_view, PlayerInput& input) const {
@@ -49,6 +49,8 @@ bool ComputerController::decide_input_power_hit(const PhysicsView& physics_view,
    * 2. Check the Y direction Up -> Middle -> Down (flip_dir_y)
    * The X direction is always checked in this order: Front -> None
    * The first combination of X/Y directions that finds a good hit will be returned.
+   * The candidates are checked one by one: most decisions stop at the first ones, which is
+   * faster than predicting all of them with predict_landings() (see the benchmarks).
    */
   const bool flip_dir_y = rand_int() % 2 == 0;
   for (int dir_x = 1; dir_x > -1; dir_x--) {
@@ -78,6 +80,7 @@ bool ComputerController::decide_input_power_hit(const PhysicsView& physics_view,
 }
 
 PlayerInput ComputerController::on_update(const PhysicsView &physics_view) {
+  PIKA_TRACE_ZONE("ComputerController::on_update");
   PlayerInput input {};
 
   // Initialize some values for later
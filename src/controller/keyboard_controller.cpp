@@ -1,4 +1,5 @@
 #include "pikaball/controller/keyboard_controller.hpp"
+#include "pikaball/trace.hpp"
 
 namespace pika {
 
@@ -10,6 +11,7 @@ void KeyboardController::set_input(const PlayerInput &input) {
 }
 
 PlayerInput KeyboardController::on_update(const PhysicsView &) {
+  PIKA_TRACE_ZONE("KeyboardController::on_update");
   return input_;
 }
 
@@ -0,0 +1,281 @@
+/**
+ * Headless video export.
+ * Plays a game recorded by the game (saved with F8) again, with the same simulation, and renders
+ * every frame with the software renderer, without creating a window or an SDL renderer.
+ * The pauses and the instant replays of the recorded game are not exported.
+ *
+ * Usage: pikaball_export match.pikr [output.rgba] [output.wav]
+ *   match.pikr   Recording of the game to export
+ *   output.rgba  Optional file for the raw frames (432x304 RGBA, 8 bits per channel). Use "-" to skip the video.
+ *   output.wav   Optional file for the audio (sounds and music mixed offline, 16-bit stereo at 44.1 kHz)
+ *                Convert with: ffmpeg -f rawvideo -pixel_format rgba -video_size 432x304 -framerate 25 -i output.rgba -i output.wav out.mp4
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <pikaball/physics/physics.hpp>
+#include <pikaball/resources.hpp>
+#include <pikaball/volley_match.hpp>
+
+#include "match_recording.hpp"
+#include "pika_sound.hpp"
+#include "view/software_volley_view.hpp"
+
+using namespace pika;
+
+namespace {
+
+/** Frame rate of the exported game */
+constexpr unsigned int export_fps = 25;
+
+/** Plays a recorded game again (the same VolleyMatch as the game) and renders it */
+class ExportGame {
+public:
+  /**
+   * @param view The view to render the game
+   * @param sound Optional offline sound system that receives the physics events and the music
+   * @param recording The recorded game
+   */
+  ExportGame(view::SoftwareVolleyView& view, PikaSound* sound, const MatchRecording& recording) :
+    view_(view),
+    sound_(sound),
+    recording_(recording)
+  {
+    if (sound_ != nullptr) {
+      physics_.subscribe(sound_);
+      sound_->start_music();
+    }
+    match_.start(recording_.seed());
+    view_.start();
+    view_.set_state(match_.state());
+  }
+
+  /** Number of frames of the game */
+  [[nodiscard]] std::size_t frames() const { return recording_.size(); }
+
+  /** Render the current frame */
+  void render() {
+    view_.render(match_.frame_counter(), PhysicsView(physics_));
+  }
+
+  /** Play the next recorded frame */
+  void step() {
+    const auto transition = match_.step(recording_[next_frame_++], [this](const PlayerInput& input_left, const PlayerInput& input_right) {
+      return physics_.update(input_left, input_right);
+    });
+    switch (transition) {
+      case VolleyMatch::Transition::FirstRound:
+      case VolleyMatch::Transition::RoundStarted:
+        view_.set_state(match_.state());
+      break;
+      case VolleyMatch::Transition::PointScored:
+        view_.set_score(match_.score_left(), match_.score_right());
+        view_.set_state(match_.state());
+      break;
+      case VolleyMatch::Transition::GameEnded:
+        view_.set_score(match_.score_left(), match_.score_right());
+        view_.set_state(match_.state());
+        if (sound_ != nullptr) {
+          sound_->stop_music();
+        }
+      break;
+      case VolleyMatch::Transition::NextRound:
+        view_.set_fade_alpha(1.0f);
+        view_.set_state(match_.state());
+      break;
+      case VolleyMatch::Transition::GameOver:
+        // The last frame of the recording
+      case VolleyMatch::Transition::None:
+      break;
+    }
+  }
+
+private:
+  view::SoftwareVolleyView& view_;
+  PikaSound* sound_ {nullptr};
+  const MatchRecording& recording_;
+  std::size_t next_frame_ {0};
+  Physics<> physics_;
+  VolleyMatch match_ {physics_};
+};
+
+/**
+ * Writes 16-bit PCM WAV files.
+ * The header is written with empty sizes, which are filled when the file is closed.
+ */
+class WavWriter {
+public:
+  WavWriter(const char* filename, const SDL_AudioSpec& spec) :
+    output_(SDL_IOFromFile(filename, "wb")),
+    channels_(spec.channels),
+    freq_(spec.freq)
+  {
+    if (output_ != nullptr) {
+      write_header(0);
+    }
+  }
+  ~WavWriter() { close(); }
+  WavWriter(WavWriter const&) = delete;
+  WavWriter(WavWriter &&) = delete;
+  WavWriter &operator=(WavWriter const&) = delete;
+  WavWriter &operator=(WavWriter &&) = delete;
+
+  [[nodiscard]] bool is_open() const { return output_ != nullptr; }
+
+  /**
+   * Convert and append float samples
+   * @param samples Interleaved samples in the range [-1.0, 1.0]
+   * @return True if the samples were written
+   */
+  bool write(const std::span<const float> samples) {
+    pcm_.resize(samples.size());
+    std::ranges::transform(samples, pcm_.begin(), [](const float sample) {
+      return static_cast<Sint16>(std::clamp(sample, -1.0f, 1.0f) * 32767.0f);
+    });
+    const std::size_t bytes = pcm_.size() * sizeof(Sint16);
+    data_size_ += static_cast<Uint32>(bytes);
+    return SDL_WriteIO(output_, pcm_.data(), bytes) == bytes;
+  }
+
+  /** Write the final sizes in the header and close the file */
+  void close() {
+    if (output_ == nullptr) {
+      return;
+    }
+    SDL_SeekIO(output_, 0, SDL_IO_SEEK_SET);
+    write_header(data_size_);
+    SDL_CloseIO(output_);
+    output_ = nullptr;
+  }
+
+private:
+  SDL_IOStream* output_ {nullptr};
+  int channels_ {2};
+  int freq_ {44100};
+  Uint32 data_size_ {0};
+  std::vector<Sint16> pcm_;
+
+  void write_header(const Uint32 data_size) {
+    const auto block_align = static_cast<Uint16>(channels_ * sizeof(Sint16));
+    SDL_WriteIO(output_, "RIFF", 4);
+    SDL_WriteU32LE(output_, 36 + data_size);
+    SDL_WriteIO(output_, "WAVEfmt ", 8);
+    SDL_WriteU32LE(output_, 16);  // Size of the fmt chunk
+    SDL_WriteU16LE(output_, 1);   // PCM
+    SDL_WriteU16LE(output_, static_cast<Uint16>(channels_));
+    SDL_WriteU32LE(output_, static_cast<Uint32>(freq_));
+    SDL_WriteU32LE(output_, static_cast<Uint32>(freq_) * block_align);
+    SDL_WriteU16LE(output_, block_align);
+    SDL_WriteU16LE(output_, 16);  // Bits per sample
+    SDL_WriteIO(output_, "data", 4);
+    SDL_WriteU32LE(output_, data_size);
+  }
+};
+
+/**
+ * Play and render a recorded game.
+ * The outputs are closed (and the WAV header finalized) when it returns, even after an error.
+ * @param recording The recorded game
+ * @param output_filename File for the raw frames, or nullptr to skip the video
+ * @param audio_filename File for the audio, or nullptr to skip the audio
+ * @return True if all the frames were rendered and written
+ */
+bool export_game(const MatchRecording& recording, const char* output_filename, const char* audio_filename) {
+  SDL_Surface* sprites_surface = SDL_LoadPNG_IO(load_resource(sprite_sheet_filename), true);
+  if (sprites_surface == nullptr) {
+    SDL_Log("Unable to load image %s! SDL Error: %s\n", sprite_sheet_filename, SDL_GetError());
+    return false;
+  }
+  view::SoftwareRenderer renderer(sprites_surface);
+  SDL_DestroySurface(sprites_surface);
+
+  std::unique_ptr<SDL_IOStream, decltype(&SDL_CloseIO)> output {nullptr, SDL_CloseIO};
+  if (output_filename != nullptr) {
+    output.reset(SDL_IOFromFile(output_filename, "wb"));
+    if (!output) {
+      SDL_Log("Unable to open %s! SDL Error: %s\n", output_filename, SDL_GetError());
+      return false;
+    }
+  }
+
+  // The audio is mixed offline, frame by frame, from the events of the recorded game, so the sounds
+  // start at the frame of their events
+  std::unique_ptr<PikaSound> sound;
+  std::unique_ptr<WavWriter> audio_output;
+  std::vector<float> audio_samples;
+  if (audio_filename != nullptr) {
+    try {
+      sound = std::make_unique<PikaSound>(PikaSound::Output::Offline);
+    }
+    catch (const std::runtime_error&) {
+      // The error is logged by PikaSound
+      return false;
+    }
+    audio_output = std::make_unique<WavWriter>(audio_filename, PikaSound::audio_spec());
+    if (!audio_output->is_open()) {
+      SDL_Log("Unable to open %s! SDL Error: %s\n", audio_filename, SDL_GetError());
+      return false;
+    }
+  }
+
+  view::SoftwareVolleyView view(renderer);
+  ExportGame game(view, sound.get(), recording);
+
+  const std::size_t frames = game.frames();
+  const Uint64 start_time = SDL_GetTicksNS();
+  for (std::size_t i = 0; i < frames; i++) {
+    // The frame shows the state after the previous steps, and its audio plays the events of those
+    // steps. The next step is played after both, or the sounds would lead the video by one frame
+    game.render();
+    if (sound) {
+      // Audio frames of this video frame (rounded per frame, so the audio never drifts)
+      const SDL_AudioSpec& spec = PikaSound::audio_spec();
+      const auto audio_frames = static_cast<long>((i + 1) * spec.freq / export_fps - i * spec.freq / export_fps);
+      audio_samples.resize(static_cast<std::size_t>(audio_frames * spec.channels));
+      if (!sound->generate(audio_samples) || !audio_output->write(audio_samples)) {
+        SDL_Log("Error generating the audio of frame %zu! SDL Error: %s\n", i, SDL_GetError());
+        return false;
+      }
+    }
+    if (output) {
+      const auto pixels = std::as_bytes(renderer.pixels());
+      if (SDL_WriteIO(output.get(), pixels.data(), pixels.size()) != pixels.size()) {
+        SDL_Log("Error writing frame %zu! SDL Error: %s\n", i, SDL_GetError());
+        return false;
+      }
+    }
+    game.step();
+  }
+  const Uint64 elapsed_time = SDL_GetTicksNS() - start_time;
+
+  const double seconds = static_cast<double>(elapsed_time) / ns_per_second;
+  SDL_Log("Rendered %zu frames in %.3f s (%.0f frames/s)", frames, seconds, static_cast<double>(frames) / seconds);
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    SDL_Log("Usage: %s match.pikr [output.rgba] [output.wav]", argv[0]);
+    return EXIT_FAILURE;
+  }
+  const char* output_filename = (argc > 2 && std::strcmp(argv[2], "-") != 0) ? argv[2] : nullptr;
+  const char* audio_filename = argc > 3 ? argv[3] : nullptr;
+
+  // No video subsystem: the frames are rendered in software. The audio subsystem is needed by the mixer
+  if (!SDL_Init(audio_filename != nullptr ? SDL_INIT_AUDIO : 0)) {
+    SDL_Log("Failed to init SDL! SDL Error: %s\n", SDL_GetError());
+    return EXIT_FAILURE;
+  }
+  MatchRecording recording;
+  const bool success = recording.load(argv[1]) && export_game(recording, output_filename, audio_filename);
+  SDL_Quit();
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,68 @@
+#include "frame_pacer.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace pika {
+
+void FramePacer::wait(const std::uint64_t frame_time) {
+  const std::uint64_t now = SDL_GetTicksNS();
+  if (deadline_ == 0) {
+    // First frame: the schedule starts now
+    deadline_ = now;
+  }
+  std::uint64_t jitter = 0;
+  if (now > deadline_) {
+    stats_.missed++;
+    jitter = now - deadline_;
+    if (jitter > frame_time) {
+      // Too far behind (slow frame, or the loop was stopped): restart the schedule
+      deadline_ = now;
+    }
+  }
+  else {
+    sleep_until(deadline_);
+    jitter = SDL_GetTicksNS() - deadline_;
+  }
+  stats_.frames++;
+  stats_.total_jitter += jitter;
+  stats_.max_jitter = std::max(stats_.max_jitter, jitter);
+  if (stats_.frames >= report_frames_) {
+    report();
+  }
+
+  // The next frame ends one frame time after this deadline, no matter when this one ended
+  deadline_ += frame_time;
+}
+
+void FramePacer::sleep_until(const std::uint64_t time) {
+  const std::uint64_t now = SDL_GetTicksNS();
+  if (time > now + spin_margin_) {
+    const std::uint64_t wake_time = time - spin_margin_;
+    SDL_DelayNS(wake_time - now);
+    // Adapt the margin to the oversleep: twice its average, so most sleeps wake up before the deadline
+    const std::uint64_t woke = SDL_GetTicksNS();
+    const std::uint64_t oversleep = (woke > wake_time) ? woke - wake_time : 0;
+    average_oversleep_ = (average_oversleep_ * 7 + oversleep) / 8;
+    spin_margin_ = std::clamp(2 * average_oversleep_, min_spin_margin_, max_spin_margin_);
+  }
+  while (SDL_GetTicksNS() < time) {
+    std::this_thread::yield();
+  }
+}
+
+void FramePacer::report() {
+  const double mean_jitter = static_cast<double>(stats_.total_jitter) / stats_.frames / 1e6;
+  const double max_jitter = static_cast<double>(stats_.max_jitter) / 1e6;
+  if (stats_.missed > 0) {
+    SDL_Log("Frame pacing: %u of %u frames missed their deadline (jitter: %.3f ms mean, %.3f ms max)",
+            stats_.missed, stats_.frames, mean_jitter, max_jitter);
+  }
+  else {
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Frame pacing: %u frames (jitter: %.3f ms mean, %.3f ms max, spin %.2f ms)",
+                 stats_.frames, mean_jitter, max_jitter, static_cast<double>(spin_margin_) / 1e6);
+  }
+  stats_ = {};
+}
+
+} // namespace pika
@@ -0,0 +1,64 @@
+#ifndef PIKA_FRAME_PACER_HPP
+#define PIKA_FRAME_PACER_HPP
+
+#include <cstdint>
+
+#include "SDL3/SDL.h"
+
+namespace pika {
+
+/**
+ * Paces the game loop against absolute frame deadlines.
+ *
+ * Each deadline is the previous one plus the frame time, so the errors of one frame do not
+ * accumulate in the next ones. The pacer sleeps until shortly before the deadline and spins for
+ * the rest: the spin margin adapts to how late the sleeps wake up on this system.
+ * A frame that ends after its deadline is a missed deadline. If the loop falls more than a
+ * frame behind, the schedule restarts from the current time instead of rushing to catch up.
+ */
+class FramePacer {
+public:
+  /** Statistics of the frames since the last report */
+  struct Stats {
+    unsigned int frames {0};
+    unsigned int missed {0};
+    // Time between the deadlines and the end of the wait (ns)
+    std::uint64_t total_jitter {0};
+    std::uint64_t max_jitter {0};
+  };
+
+  /**
+   * Wait until the deadline of the frame that just finished, and schedule the next one
+   * @param frame_time Time of the frame in nanoseconds (it may change from frame to frame)
+   */
+  void wait(std::uint64_t frame_time);
+
+  /** Restart the schedule from the current time (e.g. after a long pause of the loop) */
+  void reset() { deadline_ = 0; }
+
+  [[nodiscard]] const Stats& stats() const { return stats_; }
+
+private:
+  // Frames between reports of the statistics (10 seconds at 25 FPS)
+  constexpr static unsigned int report_frames_ {250};
+  // Bounds of the time spent spinning before a deadline
+  constexpr static std::uint64_t min_spin_margin_ {250'000};
+  constexpr static std::uint64_t max_spin_margin_ {4'000'000};
+
+  // Deadline of the current frame (0 if the schedule has not started)
+  std::uint64_t deadline_ {0};
+  // Time spent spinning before a deadline (it covers the usual oversleep of SDL_DelayNS)
+  std::uint64_t spin_margin_ {1'000'000};
+  // Moving average of the oversleep of SDL_DelayNS
+  std::uint64_t average_oversleep_ {0};
+  Stats stats_ {};
+
+  /** Sleep until the given time, spinning for the last part */
+  void sleep_until(std::uint64_t time);
+  /** Log the statistics and reset them */
+  void report();
+};
+
+} // namespace pika
+
+#endif // PIKA_FRAME_PACER_HPP
@@ -0,0 +1,322 @@
+#include "frame_recorder.hpp"
+
+#include <algorithm>
+#include <ctime>
+#include <format>
+
+#include <pikaball/common.hpp>
+#include <pikaball/trace.hpp>
+
+namespace pika {
+
+namespace {
+
+constexpr SDL_PixelFormat frame_format = SDL_PIXELFORMAT_RGBA32;
+constexpr int frame_pitch = screen_width * 4;
+constexpr std::size_t frame_size = static_cast<std::size_t>(frame_pitch) * screen_height;
+constexpr std::size_t luma_size = static_cast<std::size_t>(screen_width) * screen_height;
+constexpr std::size_t chroma_size = luma_size / 4;
+
+/** Output name based on the local date and time (e.g. "pikaball_20250131_235959") */
+std::string recording_name() {
+  const std::time_t now = std::time(nullptr);
+  char date[32] {};
+  std::strftime(date, sizeof(date), "%Y%m%d_%H%M%S", std::localtime(&now));
+  return std::string("pikaball_") + date;
+}
+
+} // namespace
+
+FrameRecorder::~FrameRecorder() {
+  stop();
+}
+
+bool FrameRecorder::start(SDL_Renderer* renderer, const Format format, const unsigned int fps) {
+  if (recording_ || renderer == nullptr) {
+    return false;
+  }
+  renderer_ = renderer;
+  format_ = format;
+
+  for (auto& staging : staging_) {
+    staging.reset(SDL_CreateTexture(
+      renderer_,
+      SDL_PIXELFORMAT_ARGB8888,
+      SDL_TEXTUREACCESS_TARGET,
+      screen_width,
+      screen_height
+    ));
+    if (!staging) {
+      SDL_Log("Unable to create the recording staging textures! SDL Error: %s\n", SDL_GetError());
+      staging_[0].reset();
+      staging_[1].reset();
+      return false;
+    }
+    SDL_SetTextureBlendMode(staging.get(), SDL_BLENDMODE_NONE);
+  }
+  staging_index_ = 0;
+  staging_pending_ = {};
+  readback_time_ = 0;
+  max_readback_time_ = 0;
+  frames_read_ = 0;
+
+  // Open the output
+  output_name_ = recording_name();
+  switch (format_) {
+    case Format::Y4M:
+      output_name_ += ".y4m";
+      output_ = SDL_IOFromFile(output_name_.c_str(), "wb");
+      if (output_ != nullptr) {
+        // Progressive 4:2:0 video with square pixels
+        const std::string header = std::format("YUV4MPEG2 W{} H{} F{}:1 Ip A1:1 C420jpeg\n",
+                                               screen_width, screen_height, fps);
+        SDL_WriteIO(output_, header.data(), header.size());
+      }
+      break;
+    case Format::RawRGBA:
+      output_name_ += ".rgba";
+      output_ = SDL_IOFromFile(output_name_.c_str(), "wb");
+      break;
+    case Format::PNGSequence:
+      break;
+  }
+  const bool output_ready = (format_ == Format::PNGSequence) ?
+    SDL_CreateDirectory(output_name_.c_str()) : output_ != nullptr;
+  if (!output_ready) {
+    SDL_Log("Unable to create the recording output %s! SDL Error: %s\n", output_name_.c_str(), SDL_GetError());
+    staging_[0].reset();
+    staging_[1].reset();
+    return false;
+  }
+
+  // Allocate all the frames now, so capturing never allocates pool memory
+  frames_.assign(frame_pool_size, FramePixels(frame_size));
+  free_frames_.clear();
+  for (auto& frame : frames_) {
+    free_frames_.push_back(&frame);
+  }
+  queued_frames_.clear();
+  if (format_ == Format::Y4M) {
+    yuv_buffer_.resize(luma_size + 2 * chroma_size);
+  }
+  frames_written_ = 0;
+  frames_dropped_ = 0;
+  stop_requested_ = false;
+
+  writer_ = std::thread(&FrameRecorder::write_frames, this);
+  recording_ = true;
+  SDL_Log("Recording to %s", output_name_.c_str());
+  return true;
+}
+
+void FrameRecorder::stop() {
+  if (!recording_) {
+    return;
+  }
+  // The last captured frames are still in the staging textures (the oldest one first)
+  SDL_Texture* target = SDL_GetRenderTarget(renderer_);
+  for (const std::size_t index : {staging_index_, 1 - staging_index_}) {
+    if (staging_pending_[index]) {
+      read_back(index);
+    }
+  }
+  SDL_SetRenderTarget(renderer_, target);
+
+  {
+    std::lock_guard lock(queue_mutex_);
+    stop_requested_ = true;
+  }
+  queue_cv_.notify_one();
+  writer_.join();
+  recording_ = false;
+
+  if (output_ != nullptr) {
+    SDL_CloseIO(output_);
+    output_ = nullptr;
+  }
+  SDL_Log("Recording saved to %s: %lu frames (%lu dropped)",
+          output_name_.c_str(), frames_written_, frames_dropped_);
+  if (frames_read_ > 0) {
+    SDL_Log("Recording readback time: %.3f ms per frame (max %.3f ms)",
+            static_cast<double>(readback_time_) / static_cast<double>(frames_read_) / 1e6,
+            static_cast<double>(max_readback_time_) / 1e6);
+  }
+
+  // Release the recording resources
+  staging_[0].reset();
+  staging_[1].reset();
+  free_frames_.clear();
+  frames_.clear();
+  frames_.shrink_to_fit();
+  yuv_buffer_.clear();
+  yuv_buffer_.shrink_to_fit();
+}
+
+void FrameRecorder::capture(SDL_Texture* frame) {
+  if (!recording_ || frame == nullptr) {
+    return;
+  }
+  // read_back() was not called since this staging texture was filled: its frame is lost
+  if (staging_pending_[staging_index_]) {
+    frames_dropped_++;
+  }
+  SDL_Texture* target = SDL_GetRenderTarget(renderer_);
+
+  // Copy the frame on the GPU. This does not wait for the frame to be rendered
+  SDL_SetRenderTarget(renderer_, staging_[staging_index_].get());
+  SDL_RenderTexture(renderer_, frame, nullptr, nullptr);
+  staging_pending_[staging_index_] = true;
+  staging_index_ = 1 - staging_index_;
+
+  SDL_SetRenderTarget(renderer_, target);
+}
+
+void FrameRecorder::read_back() {
+  // Only the frame before the last one: the last one may still be rendering on the GPU
+  if (!recording_ || !staging_pending_[staging_index_]) {
+    return;
+  }
+  PIKA_TRACE_ZONE("FrameRecorder::read_back");
+  SDL_Texture* target = SDL_GetRenderTarget(renderer_);
+  read_back(staging_index_);
+  SDL_SetRenderTarget(renderer_, target);
+}
+
+void FrameRecorder::read_back(const std::size_t index) {
+  staging_pending_[index] = false;
+  FramePixels* frame = nullptr;
+  {
+    std::lock_guard lock(queue_mutex_);
+    if (!free_frames_.empty()) {
+      frame = free_frames_.back();
+      free_frames_.pop_back();
+    }
+  }
+  if (frame == nullptr) {
+    // The writer is behind: drop the frame instead of blocking the game loop
+    frames_dropped_++;
+    return;
+  }
+
+  // Waits until the GPU finishes the queued commands, and allocates the surface with the pixels
+  const unsigned long readback_start = SDL_GetTicksNS();
+  SDL_SetRenderTarget(renderer_, staging_[index].get());
+  SDL_Surface* surface = SDL_RenderReadPixels(renderer_, nullptr);
+  const unsigned long readback_time = SDL_GetTicksNS() - readback_start;
+  readback_time_ += readback_time;
+  max_readback_time_ = std::max(max_readback_time_, readback_time);
+  frames_read_++;
+  const bool converted = surface != nullptr && SDL_ConvertPixels(
+    screen_width, screen_height,
+    surface->format, surface->pixels, surface->pitch,
+    frame_format, frame->data(), frame_pitch);
+  SDL_DestroySurface(surface);
+
+  std::lock_guard lock(queue_mutex_);
+  if (!converted) {
+    SDL_Log("Unable to read back the recorded frame! SDL Error: %s\n", SDL_GetError());
+    free_frames_.push_back(frame);
+    frames_dropped_++;
+    return;
+  }
+  queued_frames_.push_back(frame);
+  queue_cv_.notify_one();
+}
+
+void FrameRecorder::write_frames() {
+  bool output_error = false;
+  while (true) {
+    FramePixels* frame = nullptr;
+    {
+      std::unique_lock lock(queue_mutex_);
+      queue_cv_.wait(lock, [this] { return !queued_frames_.empty() || stop_requested_; });
+      if (queued_frames_.empty()) {
+        // Stop requested and all the frames are written
+        break;
+      }
+      frame = queued_frames_.front();
+      queued_frames_.pop_front();
+    }
+
+    // After an error, the frames are discarded (the recording is stopped by the user)
+    if (!output_error) {
+      output_error = !write_frame(*frame);
+      if (output_error) {
+        SDL_Log("Error writing the recording %s! SDL Error: %s\n", output_name_.c_str(), SDL_GetError());
+      }
+    }
+
+    std::lock_guard lock(queue_mutex_);
+    free_frames_.push_back(frame);
+  }
+}
+
+bool FrameRecorder::write_frame(const FramePixels& frame) {
+  switch (format_) {
+    case Format::Y4M: {
+      convert_to_yuv(frame);
+      constexpr char frame_header[] = "FRAME\n";
+      if (SDL_WriteIO(output_, frame_header, sizeof(frame_header) - 1) != sizeof(frame_header) - 1 ||
+          SDL_WriteIO(output_, yuv_buffer_.data(), yuv_buffer_.size()) != yuv_buffer_.size()) {
+        return false;
+      }
+      break;
+    }
+    case Format::RawRGBA:
+      if (SDL_WriteIO(output_, frame.data(), frame.size()) != frame.size()) {
+        return false;
+      }
+      break;
+    case Format::PNGSequence: {
+      const std::string filename = std::format("{}/frame_{:06}.png", output_name_, frames_written_);
+      SDL_Surface* surface = SDL_CreateSurfaceFrom(
+        screen_width, screen_height, frame_format, const_cast<std::uint8_t*>(frame.data()), frame_pitch);
+      const bool saved = surface != nullptr && SDL_SavePNG(surface, filename.c_str());
+      SDL_DestroySurface(surface);
+      if (!saved) {
+        return false;
+      }
+      break;
+    }
+  }
+  frames_written_++;
+  return true;
+}
+
+void FrameRecorder::convert_to_yuv(const FramePixels& frame) {
+  std::uint8_t* y_plane = yuv_buffer_.data();
+  std::uint8_t* u_plane = y_plane + luma_size;
+  std::uint8_t* v_plane = u_plane + chroma_size;
+
+  // Integer BT.601 limited range coefficients (8 bit fixed point)
+  const auto luma = [](const int r, const int g, const int b) {
+    return static_cast<std::uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+  };
+  for (std::size_t i = 0; i < luma_size; i++) {
+    const std::uint8_t* p = &frame[4 * i];
+    y_plane[i] = luma(p[0], p[1], p[2]);
+  }
+
+  // Chroma of each 2x2 block from its average color
+  for (int y = 0; y < screen_height; y += 2) {
+    for (int x = 0; x < screen_width; x += 2) {
+      int r = 0;
+      int g = 0;
+      int b = 0;
+      for (const int offset : {0, 4, frame_pitch, frame_pitch + 4}) {
+        const std::uint8_t* p = &frame[static_cast<std::size_t>(y) * frame_pitch + 4 * x + offset];
+        r += p[0];
+        g += p[1];
+        b += p[2];
+      }
+      r = (r + 2) / 4;
+      g = (g + 2) / 4;
+      b = (b + 2) / 4;
+      const std::size_t i = static_cast<std::size_t>(y / 2) * (screen_width / 2) + x / 2;
+      u_plane[i] = static_cast<std::uint8_t>(std::clamp(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128, 0, 255));
+      v_plane[i] = static_cast<std::uint8_t>(std::clamp(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128, 0, 255));
+    }
+  }
+}
+
+} // namespace pika
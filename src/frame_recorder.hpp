@@ -0,0 +1,130 @@
+#ifndef PIKA_FRAME_RECORDER_HPP
+#define PIKA_FRAME_RECORDER_HPP
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SDL3/SDL.h"
+
+namespace pika {
+
+/**
+ * Records the presented frames of the game.
+ *
+ * Every captured frame is copied on the GPU to one of two staging textures before it is presented.
+ * SDL has no asynchronous readback: SDL_RenderReadPixels flushes the renderer and waits for the
+ * GPU, and allocates a new surface for the pixels. To keep that wait out of the rendering of the
+ * frame, read_back() is called after the frame is presented, in the time left until its deadline,
+ * and it reads the staging texture of the previous frame, which had a whole frame to finish.
+ * The time spent in the readback is measured and logged when the recording stops.
+ * The pixels are copied to a preallocated pool of frames and handed to a writer thread
+ * that encodes and writes them to disk. If the writer falls behind and the pool is empty,
+ * new frames are dropped (and counted) instead of blocking the game.
+ */
+class FrameRecorder {
+public:
+  /** Output formats */
+  enum class Format {
+    Y4M,          // Single YUV4MPEG2 video file (4:2:0), readable by ffmpeg and most players
+    RawRGBA,      // Single file with the raw RGBA frames, one after the other
+    PNGSequence,  // One PNG file per frame in a new directory
+  };
+
+  /** Number of frames preallocated for the writer queue (~4 MB) */
+  constexpr static std::size_t frame_pool_size = 8;
+
+  FrameRecorder() = default;
+  ~FrameRecorder();
+  FrameRecorder(FrameRecorder const&) = delete;
+  FrameRecorder(FrameRecorder &&) = delete;
+  FrameRecorder &operator=(FrameRecorder const&) = delete;
+  FrameRecorder &operator=(FrameRecorder &&) = delete;
+
+  /**
+   * Start a new recording. The output file (or directory) is named after the current date and time.
+   * @param renderer The renderer used to capture the frames
+   * @param format The output format
+   * @param fps Frame rate written in the video header (Y4M only)
+   * @return True if the recording started
+   */
+  bool start(SDL_Renderer* renderer, Format format, unsigned int fps);
+
+  /** Stop the recording. Waits until all the queued frames are written */
+  void stop();
+
+  [[nodiscard]] bool is_recording() const { return recording_; }
+
+  /**
+   * Capture a frame (GPU copy only). Must be called before the frame is presented.
+   * The render target is restored afterwards.
+   * @param frame Texture with the frame to record (screen_width x screen_height)
+   */
+  void capture(SDL_Texture* frame);
+
+  /**
+   * Read back the frame captured before the last one and queue it for the writer.
+   * Waits for the GPU: call it after the frame is presented, before waiting for the next frame.
+   * The render target is restored afterwards.
+   */
+  void read_back();
+
+private:
+  // A frame of the pool (RGBA32 pixels, screen_width x screen_height)
+  using FramePixels = std::vector<std::uint8_t>;
+  using SDL_Texture_ptr = std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)>;
+
+  SDL_Renderer* renderer_ {nullptr};
+  Format format_ {Format::Y4M};
+  bool recording_ {false};
+
+  // Double-buffered GPU copies of the captured frames
+  std::array<SDL_Texture_ptr, 2> staging_ {
+    SDL_Texture_ptr {nullptr, SDL_DestroyTexture},
+    SDL_Texture_ptr {nullptr, SDL_DestroyTexture}
+  };
+  // Staging texture that receives the next frame (the other one has the last captured frame)
+  std::size_t staging_index_ {0};
+  // True if the staging texture holds a frame that was not read back yet
+  std::array<bool, 2> staging_pending_ {};
+
+  // Time spent reading back the frames (ns)
+  unsigned long readback_time_ {0};
+  unsigned long max_readback_time_ {0};
+  unsigned long frames_read_ {0};
+
+  // Frame pool: all the frames are allocated when the recording starts
+  std::vector<FramePixels> frames_;
+  std::vector<FramePixels*> free_frames_;
+  std::deque<FramePixels*> queued_frames_;
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cv_;
+  bool stop_requested_ {false};
+
+  // Writer thread state (only accessed by the writer thread while recording)
+  std::thread writer_;
+  SDL_IOStream* output_ {nullptr};
+  std::string output_name_;
+  std::vector<std::uint8_t> yuv_buffer_;
+  unsigned long frames_written_ {0};
+  unsigned long frames_dropped_ {0};
+
+  /** Read back a pending staging texture and queue the frame for the writer */
+  void read_back(std::size_t index);
+  /** Writer thread loop */
+  void write_frames();
+  /** Encode and write one frame to the output */
+  bool write_frame(const FramePixels& frame);
+  /** Convert an RGBA frame to planar YUV 4:2:0 (BT.601, limited range) in yuv_buffer_ */
+  void convert_to_yuv(const FramePixels& frame);
+};
+
+} // namespace pika
+
+#endif // PIKA_FRAME_RECORDER_HPP
@@ -1,8 +1,11 @@
 #include "game.hpp"
 #include "SDL3/SDL.h"
 
-#include <pikaball/controller/computer_controller.hpp>
-#include <pikaball/controller/keyboard_controller.hpp>
+#include <pikaball/random.hpp>
+#include <pikaball/trace.hpp>
+
+#include <algorithm>
+#include <ctime>
 
 namespace pika {
 
@@ -30,46 +33,139 @@ constexpr int p2_down = SDL_SCANCODE_DOWN;
 
 constexpr int menu_toggle = SDL_SCANCODE_ESCAPE;
 constexpr int fps_toggle = SDL_SCANCODE_F3;
+constexpr int replay = SDL_SCANCODE_F4;
+constexpr int letterbox_toggle = SDL_SCANCODE_F5;
+constexpr int record_toggle = SDL_SCANCODE_F6;
+constexpr int trace_toggle = SDL_SCANCODE_F7;
+constexpr int save_match = SDL_SCANCODE_F8;
 
 } // namespace pika::keys
 
+namespace {
+
+/** Local date and time for the names of the saved files (e.g. "20250131_235959") */
+std::string file_date() {
+  const std::time_t now = std::time(nullptr);
+  char date[32] {};
+  std::strftime(date, sizeof(date), "%Y%m%d_%H%M%S", std::localtime(&now));
+  return date;
+}
+
+} // namespace
 
 Game::Game() {
-  physics_ = std::make_unique<Physics>(),
+  replay_physics_ = std::make_unique<Physics<>>();
+  // Only the views that use the sprite sheet are created here. The views that need the font,
+  // and the sounds, are set up when the intro ends (they are loaded in the background)
   intro_view_ = std::make_unique<view::IntroView>(
     sdl_sys_.get_renderer(), sdl_sys_.get_sprite_sheet());
   menu_view_ = std::make_unique<view::MenuView>(
-    sdl_sys_.get_renderer(), sdl_sys_.get_sprite_sheet());
+    sdl_sys_.get_renderer(), sdl_sys_.get_sprite_sheet(), sdl_sys_.get_render_resources());
   volley_view_ = std::make_unique<view::VolleyView>(
-    sdl_sys_.get_renderer(), sdl_sys_.get_sprite_sheet());
+    sdl_sys_.get_renderer(), sdl_sys_.get_sprite_sheet(), sdl_sys_.get_render_resources());
+
+  // Room for the events of many frames, so queueing them does not allocate
+  events_queue_.reserve(256);
+
+  // Create the texture that keeps the paused scene
+  frame_cache_.reset(SDL_CreateTexture(
+    sdl_sys_.get_renderer(),
+    SDL_PIXELFORMAT_ARGB8888,
+    SDL_TEXTUREACCESS_TARGET,
+    screen_width,
+    screen_height
+  ));
+  if (frame_cache_ == nullptr) {
+    // Not critical: the paused scene is rendered every time it is presented
+    SDL_Log("Error creating frame cache texture: %s", SDL_GetError());
+  }
+  else {
+    SDL_SetTextureScaleMode(frame_cache_.get(), SDL_SCALEMODE_NEAREST);
+    SDL_SetTextureBlendMode(frame_cache_.get(), SDL_BLENDMODE_NONE);
+  }
+
+  // Opt-in hardware counters of the physics and AI hot paths
+  if (SDL_getenv("PIKA_PERF_COUNTERS") != nullptr) {
+    physics_counters_ = std::make_unique<PerfCounters>();
+    ai_counters_ = std::make_unique<PerfCounters>();
+    // The reports are logged with SDL_Log: show them also in release builds
+    SDL_SetLogPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+    if (!physics_counters_->is_available()) {
+      SDL_Log("The hardware performance counters are not available (Linux only, check perf_event_paranoid)");
+      physics_counters_.reset();
+      ai_counters_.reset();
+    }
+  }
+
+  // Opt-in trace of the whole session, written when the game exits
+  trace::Tracer::instance().set_thread_name("main");
+  if (const char* trace_output = SDL_getenv("PIKA_TRACE"); trace_output != nullptr && *trace_output != '\0') {
+    trace_output_ = trace_output;
+    trace::Tracer::instance().start();
+  }
+
+  // Initialize frame time and FPS
+  last_frame_timestamp_ = SDL_GetTicksNS();
+}
+
+Game::~Game() {
+  if (!trace_output_.empty() && trace::Tracer::instance().is_running()) {
+    trace::Tracer::instance().stop();
+    dump_trace(trace_output_);
+  }
+}
+
+void Game::finish_loading() {
+  if (options_view_) {
+    return;
+  }
+  // Waits for the assets that are still loading in the background
+  sdl_sys_.finish_loading();
+  // The sounds of the game are played when the physics emit events (if they could be loaded)
+  if (PikaSound* sound = sdl_sys_.get_sound(); sound != nullptr) {
+    physics_->subscribe(sound);
+  }
   options_view_ = std::make_unique<view::OptionsView>(
     sdl_sys_.get_renderer(),
     sdl_sys_.get_sprite_sheet(),
-    sdl_sys_.get_font()
+    sdl_sys_.get_render_resources(),
+    sdl_sys_.get_text_renderer()
   );
   fps_view_ = std::make_unique<view::FPSView>(
     sdl_sys_.get_renderer(),
     sdl_sys_.get_sprite_sheet(),
-    sdl_sys_.get_font()
+    sdl_sys_.get_render_resources(),
+    sdl_sys_.get_text_renderer()
   );
+  // All the views are created: report the textures they share
+  sdl_sys_.get_render_resources()->report();
   // Initialize default option values
   options_view_->select_option(option_menu_select_);
   options_view_->select_speed(speed_opt_select_);
   options_view_->select_points(points_opt_select_);
   options_view_->select_music(music_opt_select_);
-
-  // By default, both players are controlled by the keyboard
-  controller_right_ = std::make_unique<KeyboardController>(FieldSide::Right);
-  controller_left_ = std::make_unique<KeyboardController>(FieldSide::Left);
-
-  // Initialize frame time and FPS
-  last_frame_timestamp_ = SDL_GetTicksNS();
 }
 
 void Game::step() {
+  PIKA_TRACE_ZONE("Game::step");
+  check_frame_allocations();
+  PIKA_ALLOC_SCOPE(Game);
   // First, compile and process events
   compile_events();
 
+  // The game is suspended (no updates, no rendering) while the window is not visible
+  if (window_hidden_) {
+    return;
+  }
+
+  // The pause / options screen is static: it is only drawn again when something changes
+  if (pause_ && state_ != GameState::Intro) {
+    paused_step();
+    return;
+  }
+
+  // States may skip rendering when the frame would not change
+  frame_rendered_ = true;
   switch (state_) {
   case GameState::Intro:
     intro_state();
@@ -80,27 +176,81 @@ void Game::step() {
   case GameState::VolleyGame:
     // Send the current input state to the view
     // TODO: Decide where to get input from controllers. Here or after render?
-    // TODO: If game is paused, controllers should not be queried
-    input_left_ = controller_left_->on_update(PhysicsView(*physics_));
-    input_right_ = controller_right_->on_update(PhysicsView(*physics_));
+    update_controllers();
     volley_state();
 
-    // Check physics state and play sounds accordingly
-    handle_sound();
-
-    // Check if the view needs slow motion and change the FPS
-    const unsigned int fps = slow_motion_ ? slow_motion_fps_ : target_fps_;
+    // Check if the view needs slow motion (or a replay is shown) and change the FPS
+    unsigned int fps = target_fps_;
+    if (slow_motion_) {
+      fps = slow_motion_fps_;
+    }
+    else if (replaying_) {
+      fps = replay_fps_;
+    }
     target_time_per_frame_ = ns_per_second / fps;
     break;
   }
 
-  // Always enter the menu state. If the game is not paused, it will return immediately.
-  menu_options_state();
-
   // Estimate and display FPS
   display_fps();
 
-  SDL_RenderPresent(sdl_sys_.get_renderer());
+  if (frame_rendered_) {
+    present_frame();
+    redraw_ = false;
+    if (state_ == GameState::VolleyGame) {
+      update_render_quality();
+    }
+  }
+  render_time_ = 0;
+}
+
+void Game::paused_step() {
+  const bool options_changed = menu_options_input();
+
+  SDL_Renderer* renderer = sdl_sys_.get_renderer();
+  if (!frame_cache_valid_ && frame_cache_) {
+    // Compose the paused scene once. The views are not updated while paused.
+    SDL_Texture* frame_target = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, frame_cache_.get());
+    render_paused_scene();
+    SDL_SetRenderTarget(renderer, frame_target);
+    frame_cache_valid_ = true;
+    redraw_ = true;
+  }
+
+  // Keep the last presented frame if nothing changed (the FPS text changes every frame)
+  if (!redraw_ && !options_changed && !enable_fps_) {
+    return;
+  }
+
+  {
+    PIKA_ALLOC_SCOPE(Render);
+    if (frame_cache_) {
+      SDL_RenderTexture(renderer, frame_cache_.get(), nullptr, nullptr);
+    }
+    else {
+      // Fallback if the cache texture could not be created
+      render_paused_scene();
+    }
+    options_view_->render();
+  }
+  display_fps();
+  present_frame();
+  redraw_ = false;
+}
+
+void Game::render_paused_scene() {
+  PIKA_ALLOC_SCOPE(Render);
+  switch (state_) {
+  case GameState::Menu:
+    menu_view_->render(frame_counter_);
+    break;
+  case GameState::VolleyGame:
+    volley_view_->render(volley_frame_counter(), PhysicsView(shown_physics()));
+    break;
+  default:
+    break;
+  }
 }
 
 void Game::run() {
@@ -112,15 +262,11 @@ void Game::run() {
   intro_view_->start();
 
   while (running_) {
-    const unsigned long start_time = SDL_GetTicksNS();
     // Get current input state from keyboard
     handle_input();
     // Execute game update step and draw
     step();
-    const unsigned long end_time = SDL_GetTicksNS();
-
-    const unsigned long sleep_time = target_time_per_frame_ - (end_time - start_time);
-    SDL_DelayPrecise(sleep_time);
+    wait_next_frame();
   }
 }
 
@@ -137,36 +283,62 @@ void Game::handle_input() {
 void Game::handle_event(const SDL_Event * event) {
   if (event->type == SDL_EVENT_QUIT) {
     running_ = false;
-  } else if (event->type == SDL_EVENT_KEY_DOWN && !event->key.repeat) {
+  } else if ((event->type == SDL_EVENT_KEY_DOWN && !event->key.repeat) ||
+             is_visibility_event(event->type)) {
     // Possibly meaningful event. Store it and process it later
+    PIKA_ALLOC_SCOPE(Events);
     std::lock_guard lock(events_mutex_);
     events_queue_.push_back(*event);
   }
 }
 
 void Game::compile_events() {
+  PIKA_TRACE_ZONE("Game::compile_events");
+  PIKA_ALLOC_SCOPE(Events);
   // Enter / power-hit keys are handled by events to avoid repetitions
   PlayerInput player_input_left {};
   PlayerInput player_input_right {};
   // Same applies to menu input
   menu_input_ = {};
+  replay_requested_ = false;
 
   // Process all events in the queue
   {
     std::lock_guard lock(events_mutex_);
     for (const auto& event : events_queue_) {
-      // Redundant check. Left in case more event types are added in the future (e.g. joystick)
-      if (event.type == SDL_EVENT_KEY_DOWN && !event.key.repeat) {
+      if (is_visibility_event(event.type)) {
+        handle_visibility_event(event);
+      }
+      else if (event.type == SDL_EVENT_KEY_DOWN && !event.key.repeat) {
+        // Any input may change a static screen
+        redraw_ = true;
         switch (event.key.scancode) {
           case keys::menu_toggle:
             // When ESC is pressed, the game is paused / unpaused
             if (state_ != GameState::Intro) {
               pause_ = !pause_;
+              // The paused scene is composed again the next time the game is paused
+              frame_cache_valid_ = false;
             }
             break;
           case keys::fps_toggle:
             enable_fps_ = !enable_fps_;
             break;
+          case keys::replay:
+            replay_requested_ = true;
+            break;
+          case keys::letterbox_toggle:
+            sdl_sys_.toggle_letterbox();
+            break;
+          case keys::record_toggle:
+            toggle_recording();
+            break;
+          case keys::trace_toggle:
+            toggle_trace();
+            break;
+          case keys::save_match:
+            save_match_recording();
+            break;
           case keys::p1_hit:
           case keys::p1_hit_alt:
             player_input_left.power_hit = true;
@@ -215,58 +387,41 @@ void Game::compile_events() {
   player_input_right.direction_y =
     get_input_direction_y(key_state[keys::p2_up], key_state[keys::p2_down]);
 
-  // Pass keyboard inputs to the keyboard controllers (if controllers are keyboards)
-  if (const auto kb_left = dynamic_cast<KeyboardController*>(controller_left_.get())) {
-    kb_left->set_input(player_input_left);
-  }
-  if (const auto kb_right = dynamic_cast<KeyboardController*>(controller_right_.get())) {
-    kb_right->set_input(player_input_right);
-  }
+  // Pass keyboard inputs to the keyboard controllers (ignored if the players are not controlled by them)
+  keyboard_left_.set_input(player_input_left);
+  keyboard_right_.set_input(player_input_right);
 
   menu_input_.enter = menu_input_.enter_left | menu_input_.enter_right;
 }
 
-void Game::handle_player_sound(const FieldSide side) const {
-  switch (physics_->player(side).sound()) {
-  case PlayerSound::Pika:
-    sdl_sys_.get_sound()->pika(side);
-    break;
-  case PlayerSound::Chu:
-    sdl_sys_.get_sound()->chu(side);
-    break;
-  case PlayerSound::Pipikachu:
-    sdl_sys_.get_sound()->pipikachu();
-    break;
-  default:
-    break;
-  }
-}
-
-void Game::handle_sound() const {
-  // Handle Player sounds
-  handle_player_sound(FieldSide::Left);
-  handle_player_sound(FieldSide::Right);
-  // Handle Ball sound
-  switch (physics_->ball().sound()) {
-  case BallSound::Hit:
-    sdl_sys_.get_sound()->ball_hit();
-    break;
-  case BallSound::Ground:
-    sdl_sys_.get_sound()->ball_ground();
+void Game::handle_visibility_event(const SDL_Event& event) {
+  switch (event.type) {
+  case SDL_EVENT_WINDOW_MINIMIZED:
+  case SDL_EVENT_WINDOW_HIDDEN:
+  case SDL_EVENT_WINDOW_OCCLUDED:
+    window_hidden_ = true;
     break;
   default:
+    // Restored, shown, exposed or resized: the window contents must be drawn again
+    window_hidden_ = false;
+    redraw_ = true;
     break;
   }
-  physics_->reset_sound();
 }
 
 void Game::intro_state() {
+  // Between the fade effects the intro does not change: keep the last presented frame
+  frame_rendered_ = !view::IntroView::is_static_frame(frame_counter_) || redraw_ || enable_fps_;
   // Render the view and update frame counter
-  intro_view_->render(frame_counter_);
+  if (frame_rendered_) {
+    PIKA_ALLOC_SCOPE(Render);
+    intro_view_->render(frame_counter_);
+  }
   frame_counter_++;
   // Check if the state must change
   if (frame_counter_ >= view::IntroView::max_frames || menu_input_.enter) {
     // Setup stuff for next state
+    finish_loading();
     state_ = GameState::Menu;
     menu_state_ = MenuState::Menu;
     player_selection_ = MenuPlayerSelection::SinglePlayer;
@@ -277,7 +432,10 @@ void Game::intro_state() {
 
 void Game::menu_state() {
   // Render the view
-  menu_view_->render(frame_counter_);
+  {
+    PIKA_ALLOC_SCOPE(Render);
+    menu_view_->render(frame_counter_);
+  }
 
   // If the game is paused (options are on the screen) just render and exit without an update
   if (pause_) {
@@ -304,36 +462,42 @@ void Game::menu_state() {
     if (player_selection_ == MenuPlayerSelection::SinglePlayer && menu_input_.down) {
       player_selection_ = MenuPlayerSelection::MultiPlayer;
       menu_view_->change_selection(player_selection_);
-      sdl_sys_.get_sound()->pi();
+      if (PikaSound* sound = sdl_sys_.get_sound(); sound != nullptr) {
+        sound->pi();
+      }
     }
     else if (player_selection_ == MenuPlayerSelection::MultiPlayer && menu_input_.up) {
       player_selection_ = MenuPlayerSelection::SinglePlayer;
       menu_view_->change_selection(player_selection_);
-      sdl_sys_.get_sound()->pi();
+      if (PikaSound* sound = sdl_sys_.get_sound(); sound != nullptr) {
+        sound->pi();
+      }
     }
 
     // Process input to check if the game must start
     if (menu_input_.enter) {
-      // Create the proper player controllers according to menu selection
+      // Select the proper player controllers according to menu selection
       if (player_selection_ == MenuPlayerSelection::MultiPlayer) {
-        controller_left_ = std::make_unique<KeyboardController>(FieldSide::Left);
-        controller_right_ = std::make_unique<KeyboardController>(FieldSide::Right);
+        controller_left_ = &keyboard_left_;
+        controller_right_ = &keyboard_right_;
       } else if (player_selection_ == MenuPlayerSelection::SinglePlayer) {
         if (menu_input_.enter_left) {
-          controller_left_ = std::make_unique<KeyboardController>(FieldSide::Left);
-          controller_right_ = std::make_unique<ComputerController>(FieldSide::Right);
+          controller_left_ = &keyboard_left_;
+          controller_right_ = &computer_right_;
         } else if (menu_input_.enter_right) {
-          controller_left_ = std::make_unique<ComputerController>(FieldSide::Left);
-          controller_right_ = std::make_unique<KeyboardController>(FieldSide::Right);
+          controller_left_ = &computer_left_;
+          controller_right_ = &keyboard_right_;
         } else {
           // This should never happen!!!!
-          controller_left_ = std::make_unique<ComputerController>(FieldSide::Left);
-          controller_right_ = std::make_unique<ComputerController>(FieldSide::Right);
+          controller_left_ = &computer_left_;
+          controller_right_ = &computer_right_;
         }
       }
       menu_state_ = MenuState::FadeOut;
       menu_view_->set_state(menu_state_);
-      sdl_sys_.get_sound()->pikachu();
+      if (PikaSound* sound = sdl_sys_.get_sound(); sound != nullptr) {
+        sound->pikachu();
+      }
     }
     break;
   case MenuState::FadeOut:
@@ -342,23 +506,38 @@ void Game::menu_state() {
       // Trigger transition to VolleyGame state
       state_ = GameState::VolleyGame;
       frame_counter_ = 0;
-      // Initialize controllers
-      controller_left_->on_game_start(PhysicsView(*physics_));
-      controller_right_->on_game_start(PhysicsView(*physics_));
-      volley_view_->start();
-      // Start the music (if enabled)
-      if (music_opt_select_ == OnOffSelection::On) {
-        sdl_sys_.get_sound()->start_music();
-      }
+      start_volley_game();
     }
     break;
   }
 }
 
-void Game::menu_options_state() {
-  if (!pause_ || state_ == GameState::Intro) {
-    return;
+void Game::start_volley_game() {
+  // Each game has its own seed, recorded with the frames so that the game can be played again
+  const std::uint32_t seed = static_cast<std::uint32_t>(rand_int()) << 16 | rand_int();
+  match_.start(seed);
+  match_recording_.start(seed);
+  replay_buffer_.clear();
+  replaying_ = false;
+  // Initialize controllers (and measure the new ones from scratch)
+  controller_left_->on_game_start(PhysicsView(*physics_));
+  controller_right_->on_game_start(PhysicsView(*physics_));
+  controller_time_left_ = 0.0;
+  controller_time_right_ = 0.0;
+  volley_view_->start();
+  // Start the music (if enabled)
+  if (music_opt_select_ == OnOffSelection::On) {
+    if (PikaSound* sound = sdl_sys_.get_sound(); sound != nullptr) {
+      sound->start_music();
+    }
   }
+}
+
+bool Game::menu_options_input() {
+  const auto previous_option = option_menu_select_;
+  const auto previous_speed = speed_opt_select_;
+  const auto previous_points = points_opt_select_;
+  const auto previous_music = music_opt_select_;
 
   switch (option_menu_select_) {
   case OptionMenuSelection::Speed:
@@ -437,96 +616,244 @@ void Game::menu_options_state() {
   options_view_->select_points(points_opt_select_);
   options_view_->select_music(music_opt_select_);
 
-  options_view_->render();
+  return option_menu_select_ != previous_option || speed_opt_select_ != previous_speed ||
+         points_opt_select_ != previous_points || music_opt_select_ != previous_music;
 }
 
 void Game::volley_state() {
   // Render the view
-  volley_view_->render(frame_counter_, PhysicsView(*physics_));
+  {
+    PIKA_ALLOC_SCOPE(Render);
+    const unsigned long render_start = SDL_GetTicksNS();
+    volley_view_->render(volley_frame_counter(), PhysicsView(shown_physics()));
+    render_time_ += SDL_GetTicksNS() - render_start;
+  }
 
   // If the game is paused (options are on the screen) just render and exit without an update
   if (pause_) {
     return;
   }
 
-  // Update frame counter
-  frame_counter_++;
+  if (replaying_) {
+    frame_counter_++;
+    replay_state();
+    return;
+  }
+  // The last rally can be replayed between the rounds
+  const VolleyGameState state = match_.state();
+  if (replay_requested_ && !replay_buffer_.empty() &&
+      (state == VolleyGameState::StartRound || state == VolleyGameState::EndRound)) {
+    start_replay();
+    return;
+  }
 
-  switch (volley_state_) {
-  case VolleyGameState::NewGame:
-      // TODO: Maybe check transitions after rendering and updating
-      if (frame_counter_ >= view::VolleyView::new_game_frames) {
-        volley_state_ = VolleyGameState::PlayRound;
-        volley_view_->set_state(volley_state_);
-      }
+  step_match({
+    .input_left = input_left_,
+    .input_right = input_right_,
+    .win_score = win_score,
+    // The end frames can be skipped
+    .skip_game_end = menu_input_.enter,
+  });
+}
+
+void Game::step_match(const MatchFrame& frame) {
+  if (!match_recording_.full()) {
+    match_recording_.push(frame);
+    if (match_recording_.full()) {
+      SDL_Log("The match recording is full: the rest of the game is not recorded");
+    }
+  }
+
+  const VolleyGameState state = match_.state();
+  const auto transition = match_.step(frame, [this, state](const PlayerInput& input_left, const PlayerInput& input_right) {
+    const bool ball_touches_ground = update_physics(input_left, input_right);
+    // The rally and the frames after the point are kept for the instant replay
+    if (state == VolleyGameState::PlayRound || state == VolleyGameState::EndRound) {
+      replay_buffer_.push(physics_->capture());
+    }
+    if (state == VolleyGameState::EndRound) {
+      replay_frames_after_point_++;
+    }
+    return ball_touches_ground;
+  });
+  slow_motion_ = match_.slow_motion();
+
+  switch (transition) {
+    case VolleyMatch::Transition::FirstRound:
+      replay_buffer_.clear();
+      volley_view_->set_state(match_.state());
     break;
-    case VolleyGameState::StartRound:
-      if (frame_counter_ >= view::VolleyView::start_round_frames) {
-        // Start the next round
-        // When a new round stars, update the controllers
-        controller_left_->on_round_start(PhysicsView(*physics_));
-        controller_right_->on_round_start(PhysicsView(*physics_));
-        volley_state_ = VolleyGameState::PlayRound;
-        volley_view_->set_state(volley_state_);
-      }
+    case VolleyMatch::Transition::RoundStarted:
+      // When a new round stars, update the controllers
+      controller_left_->on_round_start(PhysicsView(*physics_));
+      controller_right_->on_round_start(PhysicsView(*physics_));
+      // Start recording the new rally
+      replay_buffer_.clear();
+      volley_view_->set_state(match_.state());
     break;
-    case VolleyGameState::PlayRound:
-      // Update physics and check if the ball is touching the ground
-      if (physics_->update(input_left_, input_right_)) {
-        // End of the round
-        next_serve_side_ = update_score();
-        volley_view_->set_score(score_left_, score_right_);
-        if (score_left_ >= win_score || score_right_ >= win_score) {
-          // Game ended
-          physics_->end_game(next_serve_side_);
-          frame_counter_ = 0;
-          volley_state_ = VolleyGameState::GameEnd;
-          volley_view_->set_state(volley_state_);
-          // Stop music
-          sdl_sys_.get_sound()->stop_music();
-        }
-        else {
-          // Apply end-of-round effects and start next round
-          frame_counter_ = 0;
-          volley_state_ = VolleyGameState::EndRound;
-          volley_view_->set_state(volley_state_);
-        }
-      }
+    case VolleyMatch::Transition::PointScored:
+      replay_frames_after_point_ = 0;
+      volley_view_->set_score(match_.score_left(), match_.score_right());
+      volley_view_->set_state(match_.state());
     break;
-    case VolleyGameState::EndRound:
-      // Apply and manage slow motion and fading effects
-      // Slow motion will be active for the first 6 frames after the point
-      slow_motion_ = frame_counter_ <= 6;
-      // We keep updating the physics, but without checking the ball
-      physics_->update(input_left_, input_right_);
-      if (frame_counter_ >= view::VolleyView::end_round_frames) {
-        // Start the next round
-        frame_counter_ = 0;
-        volley_view_->fade_out(1.0);
-        physics_->init_round(next_serve_side_);
-        volley_state_ = VolleyGameState::StartRound;
-        volley_view_->set_state(volley_state_);
+    case VolleyMatch::Transition::GameEnded:
+      replay_frames_after_point_ = 0;
+      volley_view_->set_score(match_.score_left(), match_.score_right());
+      volley_view_->set_state(match_.state());
+      // Stop music
+      if (PikaSound* sound = sdl_sys_.get_sound(); sound != nullptr) {
+        sound->stop_music();
       }
     break;
-    case VolleyGameState::GameEnd:
-      // Check if the user wants to skip the end frames
-      const bool skip =
-        frame_counter_ > view::VolleyView::game_end_skip_frames && menu_input_.enter;
-      // Or, end the game after the total animation frames
-      if (skip || frame_counter_ > view::VolleyView::game_end_frames) {
-        reset_volley_game_state();
-        frame_counter_ = 0;
-        state_ = GameState::Intro;
-        intro_view_->start();
-        return;
-      }
-      // Keep updating physics in the end state, without checking the ball touching ground.
-      physics_->update(input_left_, input_right_);
+    case VolleyMatch::Transition::NextRound:
+      volley_view_->fade_out(1.0);
+      volley_view_->set_state(match_.state());
+    break;
+    case VolleyMatch::Transition::GameOver:
+      // Back to the intro. The recording of the game is kept until the next one starts
+      replay_buffer_.clear();
+      frame_counter_ = 0;
+      state_ = GameState::Intro;
+      intro_view_->start();
+    break;
+    case VolleyMatch::Transition::None:
     break;
   }
 }
 
+void Game::update_controllers() {
+  PIKA_ALLOC_SCOPE(Controllers);
+  // Both controllers decide from the same snapshot of the physics
+  const PhysicsView physics_view(*physics_);
+  if (ai_counters_) {
+    // The hardware counters only count the main thread: run the controllers on it
+    ai_counters_->enable();
+    input_left_ = controller_left_->on_update(physics_view);
+    input_right_ = controller_right_->on_update(physics_view);
+    ai_counters_->disable();
+  }
+  else if (parallel_controllers_ &&
+           std::min(controller_time_left_, controller_time_right_) >= parallel_controller_time_) {
+    // Both controllers are slow: the right one decides in the worker while the left one decides here
+    controller_view_ = &physics_view;
+    controller_worker_.start();
+    input_left_ = run_controller(*controller_left_, physics_view, controller_time_left_);
+    controller_worker_.wait();
+    controller_view_ = nullptr;
+  }
+  else {
+    input_left_ = run_controller(*controller_left_, physics_view, controller_time_left_);
+    input_right_ = run_controller(*controller_right_, physics_view, controller_time_right_);
+  }
+}
+
+PlayerInput Game::run_controller(PlayerController& controller, const PhysicsView& physics_view, double& average_time) {
+  const Uint64 start_time = SDL_GetTicksNS();
+  const PlayerInput input = controller.on_update(physics_view);
+  average_time += (static_cast<double>(SDL_GetTicksNS() - start_time) - average_time) * 0.1;
+  return input;
+}
+
+bool Game::update_physics(const PlayerInput& input_left, const PlayerInput& input_right) {
+  PIKA_ALLOC_SCOPE(Physics);
+  if (!physics_counters_) {
+    return physics_->update(input_left, input_right);
+  }
+  physics_counters_->enable();
+  const bool ball_touches_ground = physics_->update(input_left, input_right);
+  physics_counters_->disable();
+  if (++counted_frames_ >= counters_report_frames_) {
+    report_perf_counters();
+  }
+  return ball_touches_ground;
+}
+
+void Game::check_frame_allocations() {
+  if constexpr (!alloc::tracking_enabled) {
+    return;
+  }
+  const alloc::Counts now = alloc::counts();
+  const alloc::Counts frame = now - frame_start_allocs_;
+  frame_start_allocs_ = now;
+  if (steady_frame_ && frame.frame_allocations() > 0) {
+    for (std::size_t i = static_cast<std::size_t>(alloc::Subsystem::Game); i < alloc::num_subsystems; i++) {
+      if (frame.allocations[i] > 0) {
+        SDL_Log("Allocations in a rally frame: %llu in %s (%llu bytes)", static_cast<unsigned long long>(frame.allocations[i]),
+                alloc::subsystem_names[i], static_cast<unsigned long long>(frame.bytes[i]));
+      }
+    }
+  }
+  SDL_assert(!steady_frame_ || frame.frame_allocations() == 0);
+  // The next frame is a frame of a rally if it starts in the PlayRound state.
+  // Recorded frames allocate: SDL_RenderReadPixels returns a new surface for every readback.
+  steady_frame_ = state_ == GameState::VolleyGame && !replaying_ && match_.state() == VolleyGameState::PlayRound &&
+                  !pause_ && !window_hidden_ && !recorder_.is_recording();
+
+  if (++alloc_frames_ < counters_report_frames_) {
+    return;
+  }
+  const alloc::Counts reported = now - reported_allocs_;
+  const auto frames = static_cast<double>(alloc_frames_);
+  for (std::size_t i = 0; i < alloc::num_subsystems; i++) {
+    if (reported.allocations[i] > 0) {
+      SDL_Log("Allocations per frame in %s: %.2f (%.0f bytes)", alloc::subsystem_names[i],
+              static_cast<double>(reported.allocations[i]) / frames, static_cast<double>(reported.bytes[i]) / frames);
+    }
+  }
+  reported_allocs_ = now;
+  alloc_frames_ = 0;
+}
+
+void Game::report_perf_counters() {
+  const auto frames = static_cast<double>(counted_frames_);
+  // The controllers are also updated in frames without physics (e.g. start of a round)
+  const std::pair<const char*, PerfCounts> reports[] = {
+    {"Physics", physics_counters_->read().per(frames)},
+    {"AI", ai_counters_->read().per(frames)},
+  };
+  for (const auto& [name, counts] : reports) {
+    SDL_Log("%s per frame: %.0f cycles, %.0f instructions (IPC %.2f), %.1f branch misses, "
+            "%.1f L1D misses, %.1f LLC misses", name,
+            counts[PerfEvent::Cycles], counts[PerfEvent::Instructions], counts.ipc(),
+            counts[PerfEvent::BranchMisses], counts[PerfEvent::L1DMisses], counts[PerfEvent::LLCMisses]);
+  }
+  physics_counters_->reset();
+  ai_counters_->reset();
+  counted_frames_ = 0;
+}
+
+void Game::start_replay() {
+  // Show the first recorded frame. The live physics are not touched
+  replay_frame_ = 0;
+  replay_physics_->restore(replay_buffer_[replay_frame_]);
+  slow_motion_ = false;
+  frame_counter_ = 0;
+  replaying_ = true;
+  volley_view_->set_state(VolleyGameState::Replay);
+}
+
+void Game::replay_state() {
+  // Frames before the point that are also replayed in slow motion
+  constexpr std::size_t slow_motion_lead_frames = 10;
+
+  replay_frame_++;
+  // The replay can be skipped with enter or the replay key
+  if (replay_frame_ >= replay_buffer_.size() || menu_input_.enter || replay_requested_) {
+    // Continue with the next round (the rest of the current one is skipped)
+    replaying_ = false;
+    step_match({.win_score = win_score, .next_round = true});
+    return;
+  }
+  replay_physics_->restore(replay_buffer_[replay_frame_]);
+
+  // Slow motion around the point, like in the live game
+  const std::size_t point_frame = replay_buffer_.size() - 1 - replay_frames_after_point_;
+  slow_motion_ = replay_frame_ + slow_motion_lead_frames >= point_frame &&
+                 replay_frame_ <= point_frame + 6;
+}
+
 void Game::display_fps() {
+  PIKA_ALLOC_SCOPE(Render);
   // First, estimate the current FPS
   const unsigned long cur_frame_timestamp = SDL_GetTicksNS();
   const unsigned long frame_time = cur_frame_timestamp - last_frame_timestamp_;
@@ -536,17 +863,83 @@ void Game::display_fps() {
 
   // Only display if enabled
   if (enable_fps_) {
+    finish_loading();
     fps_view_->render(current_fps_);
   }
 }
 
-FieldSide Game::update_score() {
-  if (physics_->ball().punch_effect_x() < ground_h_width) {
-    score_right_++;
-    return FieldSide::Right;
+void Game::toggle_recording() {
+  // Starting and stopping the recording (re)allocates its buffers
+  steady_frame_ = false;
+  if (recorder_.is_recording()) {
+    recorder_.stop();
+    return;
+  }
+  if (sdl_sys_.get_frame_target() == nullptr) {
+    SDL_Log("Recording is not available without the native resolution frame target");
+    return;
+  }
+  recorder_.start(sdl_sys_.get_renderer(), FrameRecorder::Format::Y4M, target_fps_);
+}
+
+void Game::toggle_trace() {
+  trace::Tracer& tracer = trace::Tracer::instance();
+  if (!tracer.is_running()) {
+    tracer.start();
+    SDL_Log("Tracing started");
+    return;
+  }
+  tracer.stop();
+  // Output name based on the local date and time (e.g. "pikaball_trace_20250131_235959.json")
+  dump_trace("pikaball_trace_" + file_date() + ".json");
+  // A trace requested with the env variable is not written again at exit
+  trace_output_.clear();
+}
+
+void Game::dump_trace(const std::string& filename) {
+  const long events = trace::Tracer::instance().dump(filename);
+  if (events < 0) {
+    SDL_Log("Unable to write the trace to %s", filename.c_str());
+    return;
+  }
+  SDL_Log("Trace written to %s (%ld events)", filename.c_str(), events);
+}
+
+void Game::save_match_recording() {
+  // Writing the file allocates
+  steady_frame_ = false;
+  if (match_recording_.empty()) {
+    SDL_Log("There is no game to save");
+    return;
+  }
+  // Play it again with: pikaball_export pikaball_match_20250131_235959.pikr
+  const std::string filename = "pikaball_match_" + file_date() + ".pikr";
+  if (match_recording_.save(filename.c_str())) {
+    SDL_Log("Game saved to %s (%zu frames)", filename.c_str(), match_recording_.size());
+  }
+}
+
+void Game::present_frame() {
+  PIKA_ALLOC_SCOPE(Present);
+  // The draw calls are batched: most of the rendering work is done when the frame is presented
+  const unsigned long present_start = SDL_GetTicksNS();
+  if (recorder_.is_recording()) {
+    recorder_.capture(sdl_sys_.get_frame_target());
   }
-  score_left_++;
-  return FieldSide::Left;
+  sdl_sys_.present();
+  render_time_ += SDL_GetTicksNS() - present_start;
+}
+
+void Game::update_render_quality() {
+  // Rendering may use most of the frame: the rest is for the game logic, physics and AI
+  const unsigned long render_budget = target_time_per_frame_ * 3 / 4;
+  if (!quality_governor_.update(render_time_, render_budget)) {
+    return;
+  }
+  const int level = quality_governor_.level();
+  volley_view_->set_quality(static_cast<view::RenderQuality>(level));
+  SDL_Log("Render quality: %s (render time %.2f ms, budget %.2f ms)", view::render_quality_names[level],
+          quality_governor_.average_render_time() / 1e6, static_cast<double>(render_budget) / 1e6);
 }
 
 void Game::change_game_speed(const SpeedOptionSelection speed) {
@@ -583,21 +976,17 @@ void Game::toggle_music() {
   if (music_opt_select_ == OnOffSelection::Off) {
     // Only start the music if inside a game
     if (state_ == GameState::VolleyGame) {
-      sdl_sys_.get_sound()->start_music();
+      if (PikaSound* sound = sdl_sys_.get_sound(); sound != nullptr) {
+        sound->start_music();
+      }
     }
     music_opt_select_ = OnOffSelection::On;
   } else {
-    sdl_sys_.get_sound()->stop_music();
+    if (PikaSound* sound = sdl_sys_.get_sound(); sound != nullptr) {
+      sound->stop_music();
+    }
     music_opt_select_ = OnOffSelection::Off;
   }
 }
 
-void Game::reset_volley_game_state() {
-  score_left_ = 0;
-  score_right_ = 0;
-  next_serve_side_ = FieldSide::Left;
-  volley_state_ = VolleyGameState::NewGame;
-  physics_->restart();
-}
-
 } // namespace pika
@@ -9,16 +9,27 @@
 #include "view/options_view.hpp"
 #include "view/fps_view.hpp"
 #include "sdl_system.hpp"
+#include "frame_pacer.hpp"
+#include "frame_recorder.hpp"
+#include "match_recording.hpp"
 
+#include <pikaball/alloc_tracking.hpp>
+#include <pikaball/controller/computer_controller.hpp>
+#include <pikaball/controller/keyboard_controller.hpp>
 #include <pikaball/controller/player_controller.hpp>
+#include <pikaball/perf_counters.hpp>
 #include <pikaball/physics/physics.hpp>
+#include <pikaball/quality_governor.hpp>
+#include <pikaball/ring_buffer.hpp>
+#include <pikaball/volley_match.hpp>
+#include <pikaball/worker_pool.hpp>
 
 namespace pika {
 
 class Game {
 public:
   Game();
-  ~Game() = default;
+  ~Game();
 
   Game(Game const&) = delete;
   Game(Game &&) = delete;
@@ -44,17 +55,37 @@ public:
    */
   void handle_event(const SDL_Event * event);
 
-  [[nodiscard]] unsigned long get_frame_time() const {return target_time_per_frame_;}
+  /** Time in nanoseconds per frame (longer while the window is not visible) */
+  [[nodiscard]] unsigned long get_frame_time() const {
+    return window_hidden_ ? hidden_frame_time_ : target_time_per_frame_;
+  }
+
+  /** Wait until the deadline of the current frame (called after each step) */
+  void wait_next_frame() {
+    if (recorder_.is_recording()) {
+      // The readback waits for the GPU: do it after the frame was presented, in the time left of the frame
+      PIKA_ALLOC_SCOPE(Present);
+      recorder_.read_back();
+    }
+    pacer_.wait(get_frame_time());
+  }
 private:
   SDLSystem sdl_sys_;
+  // Records the presented frames to a video file (toggled with a key)
+  FrameRecorder recorder_;
+  // Keeps the frame rate of the game loop
+  FramePacer pacer_;
 
   // Main (and only) physics object to update the state of ball and players
-  Physics::Ptr physics_ {nullptr};
+  Physics<>::Ptr physics_ {std::make_unique<Physics<>>()};
+  // Render-only physics object, restored from the snapshots during the instant replay
+  Physics<>::Ptr replay_physics_ {nullptr};
 
   // Views
   std::unique_ptr<view::IntroView> intro_view_ {nullptr};
   std::unique_ptr<view::MenuView> menu_view_ {nullptr};
   std::unique_ptr<view::VolleyView> volley_view_ {nullptr};
+  // Created by finish_loading() (they need the font)
   std::unique_ptr<view::OptionsView> options_view_ {nullptr};
   std::unique_ptr<view::FPSView> fps_view_ {nullptr};
 
@@ -68,6 +99,19 @@ private:
   unsigned long last_frame_timestamp_ {0};
   // FPS estimation
   float current_fps_ {0.0};
+  // Time per frame while the window is minimized or occluded (only events are processed)
+  constexpr static unsigned long hidden_frame_time_ {ns_per_second / 10};
+
+  // Render-on-change
+  // Last composed paused scene (without the options menu). Redrawn only when the game is paused
+  view::View::SDL_Texture_ptr frame_cache_ {nullptr, SDL_DestroyTexture};
+  bool frame_cache_valid_ {false};
+  // Set when a static screen must be presented again (input, window exposed...)
+  bool redraw_ {true};
+  // False if the current state skipped rendering in this step (the last frame is kept)
+  bool frame_rendered_ {true};
+  // The game is suspended while the window is minimized, hidden or occluded
+  bool window_hidden_ {false};
 
   // Game state
   bool running_ {false};
@@ -84,15 +128,30 @@ private:
   OnOffSelection music_opt_select_ {OnOffSelection::On};
 
   // VolleyGame state data
-  VolleyGameState volley_state_ {VolleyGameState::NewGame};
-  int score_left_ {0};
-  int score_right_ {0};
+  // Rounds and scores of the current game (shared with the export tool)
+  VolleyMatch match_ {*physics_};
+  // Frames of the current game, to play it again (saved with a key, e.g. to export it to video)
+  MatchRecording match_recording_;
   int win_score = 15;
 
-  FieldSide next_serve_side_ {FieldSide::Left};
   // Slow Motion state. The Game object must manually check this to adjust the FPS
   bool slow_motion_ {false};
 
+  // Instant replay (shown between rounds, outside of the match)
+  bool replaying_ {false};
+  // Number of frames stored for the replay (about 40 seconds of rally at 25 FPS, ~36 KB)
+  constexpr static std::size_t replay_frames_ {1024};
+  // Speed of the replay (the last frames of the rally are replayed at slow_motion_fps_)
+  constexpr static unsigned int replay_fps_ {15};
+  // History of the current rally. Preallocated, so recording never allocates
+  RingBuffer<PhysicsSnapshot, replay_frames_> replay_buffer_;
+  // Number of frames recorded after the ball touched the ground
+  std::size_t replay_frames_after_point_ {0};
+  // Next frame to show from the replay buffer
+  std::size_t replay_frame_ {0};
+  // Set when the replay key is pressed
+  bool replay_requested_ {false};
+
   // A mutex to block the event handler while compiling / processing events
   std::mutex events_mutex_;
   std::vector<SDL_Event> events_queue_;
@@ -101,9 +160,53 @@ private:
   MenuInput menu_input_ {};
   PlayerInput input_left_ {};
   PlayerInput input_right_ {};
-  // Player controllers
-  std::unique_ptr<PlayerController> controller_left_ {nullptr};
-  std::unique_ptr<PlayerController> controller_right_ {nullptr};
+  // Player controllers of both kinds, created once (the game does not allocate when they change)
+  KeyboardController keyboard_left_ {FieldSide::Left};
+  KeyboardController keyboard_right_ {FieldSide::Right};
+  ComputerController computer_left_ {FieldSide::Left};
+  ComputerController computer_right_ {FieldSide::Right};
+  // Controllers of the current game (by default, both players are controlled by the keyboard)
+  PlayerController* controller_left_ {&keyboard_left_};
+  PlayerController* controller_right_ {&keyboard_right_};
+  // Moving average of the time each controller takes to decide (ns)
+  double controller_time_left_ {0.0};
+  double controller_time_right_ {0.0};
+  // Waking the worker takes tens of microseconds: the controllers only run in parallel
+  // when both take longer than this to decide (ns)
+  constexpr static double parallel_controller_time_ {100'000.0};
+  // There must be a core for each controller
+  const bool parallel_controllers_ {std::thread::hardware_concurrency() > 1};
+  // Physics snapshot of the frame, read by the controllers while they run in parallel
+  const PhysicsView* controller_view_ {nullptr};
+  // Runs the right controller while the main thread runs the left one
+  FrameWorker controller_worker_ {"controllers", [this] {
+    PIKA_ALLOC_SCOPE(Controllers);
+    input_right_ = run_controller(*controller_right_, *controller_view_, controller_time_right_);
+  }};
+
+  // Hardware counters of the physics and AI updates (opt-in with the PIKA_PERF_COUNTERS env variable)
+  std::unique_ptr<PerfCounters> physics_counters_ {nullptr};
+  std::unique_ptr<PerfCounters> ai_counters_ {nullptr};
+  // Physics updates measured since the last report
+  unsigned int counted_frames_ {0};
+  // Physics updates between reports of the counters (10 seconds at 25 FPS)
+  constexpr static unsigned int counters_report_frames_ {250};
+
+  // Allocations counted at the start of the last frame (PIKA_ALLOC_TRACKING builds)
+  alloc::Counts frame_start_allocs_ {};
+  // Allocations of the frames since the last report
+  alloc::Counts reported_allocs_ {};
+  unsigned int alloc_frames_ {0};
+  // The last frame was a frame of a rally, which must not allocate
+  bool steady_frame_ {false};
+
+  // Lowers the render quality of the volley view when rendering takes too long (and restores it)
+  QualityGovernor quality_governor_ {view::max_render_quality_level};
+  // Time spent rendering and presenting the current frame (ns)
+  unsigned long render_time_ {0};
+
+  // Output of the trace started with the PIKA_TRACE env variable (written when the game exits)
+  std::string trace_output_;
 
   /** Handle keyboard input */
   void handle_input();
@@ -113,29 +216,96 @@ private:
    * Afterwards, resets the event queue.
    */
   void compile_events();
+  /** Update the window visibility after a window event */
+  void handle_visibility_event(const SDL_Event& event);
+  /** Check if an event type changes the visibility of the window */
+  [[nodiscard]] static bool is_visibility_event(Uint32 type) {
+    return type == SDL_EVENT_WINDOW_MINIMIZED || type == SDL_EVENT_WINDOW_HIDDEN ||
+           type == SDL_EVENT_WINDOW_OCCLUDED || type == SDL_EVENT_WINDOW_RESTORED ||
+           type == SDL_EVENT_WINDOW_SHOWN || type == SDL_EVENT_WINDOW_EXPOSED ||
+           type == SDL_EVENT_WINDOW_MAXIMIZED || type == SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED;
+  }
 
-  /** Handle player and ball sounds */
-  void handle_sound() const;
-  void handle_player_sound(FieldSide side) const;
-
-  /** Cleans up all the variables after ending a volley game */
-  void reset_volley_game_state();
+  /**
+   * Wait for the assets loaded in the background and create the views that use them.
+   * Called when the intro ends (or when they are needed earlier)
+   */
+  void finish_loading();
+  /** Start a new volley game (the match, its recording and the controllers) */
+  void start_volley_game();
   /** Control the game's logic for the Intro state */
   void intro_state();
   /** Control the game's logic for the main Menu state */
   void menu_state();
-  /** Control the game's logic for the Options Menu state */
-  void menu_options_state();
+  /**
+   * Process the input of the Options Menu (shown while the game is paused)
+   * @return True if any option or the selected entry changed
+   */
+  bool menu_options_input();
+  /**
+   * Step while the game is paused. The paused scene is composed once into frame_cache_,
+   * and the frame is only presented again when the options or the window change.
+   */
+  void paused_step();
+  /** Render the scene behind the options menu, without updating it */
+  void render_paused_scene();
   /** Control the game's logic for the VolleyGame state */
   void volley_state();
-  /** Display the FPS */
-  void display_fps();
+  /**
+   * Advance the match one frame, record the frame and update the view with the transition
+   * @param frame The input and commands of the frame
+   */
+  void step_match(const MatchFrame& frame);
+  /** Get the input of both players from their controllers */
+  void update_controllers();
 
-  /** Update the score based on the position of the ball punch effect.
-   *
-   * @return The side that won the point
+  /**
+   * Get the input of a player from its controller, and measure the time it takes
+   * @param controller The controller of the player
+   * @param physics_view Snapshot of the physics of the frame
+   * @param average_time Moving average of the controller time (ns), updated with this one
    */
-  FieldSide update_score();
+  static PlayerInput run_controller(PlayerController& controller, const PhysicsView& physics_view, double& average_time);
+  /**
+   * Update the physics with the input of both players
+   * @param input_left Input of the left player
+   * @param input_right Input of the right player
+   * @return True if the ball touches the ground
+   */
+  bool update_physics(const PlayerInput& input_left, const PlayerInput& input_right);
+  /**
+   * Count the allocations of the last frame (PIKA_ALLOC_TRACKING builds) and log them periodically.
+   * Frames of a rally must not allocate: their allocations are reported, and asserted in debug builds
+   */
+  void check_frame_allocations();
+  /** Log the hardware counters per physics update and reset them */
+  void report_perf_counters();
+  /** Start the instant replay of the last rally (if it was recorded) */
+  void start_replay();
+  /** Show the next frame of the instant replay and go to the next round when it ends */
+  void replay_state();
+  /** Physics object shown by the volley view (the replay is rendered from its own physics object) */
+  [[nodiscard]] const Physics<>& shown_physics() const {
+    return replaying_ ? *replay_physics_ : *physics_;
+  }
+  /** Frame counter of the state shown by the volley view */
+  [[nodiscard]] unsigned int volley_frame_counter() const {
+    return replaying_ ? frame_counter_ : match_.frame_counter();
+  }
+  /** Adapt the render quality of the volley view to the render time of the last frame */
+  void update_render_quality();
+  /** Start or stop recording the game */
+  void toggle_recording();
+  /** Start tracing, or stop it and write the trace to a file */
+  void toggle_trace();
+  /** Write the recorded trace to a file */
+  void dump_trace(const std::string& filename);
+  /** Write the recording of the current (or last) game to a file */
+  void save_match_recording();
+  /** Capture the frame if the game is being recorded and present it */
+  void present_frame();
+  /** Display the FPS */
+  void display_fps();
 
   void change_game_speed(SpeedOptionSelection speed);
   void change_win_score(PointsOptionSelection win_points);
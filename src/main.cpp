@@ -6,28 +6,29 @@
 
 
 SDL_AppResult SDL_AppInit(void **appstate, int argc, char **argv) {
+    // Count the allocations of SDL too (only in PIKA_ALLOC_TRACKING builds)
+    pika::alloc::install_sdl_hooks();
     // Setup logger verbosity
     #ifdef PIKA_DEBUG
     SDL_SetLogPriorities(SDL_LOG_PRIORITY_DEBUG);
     #else
     SDL_SetLogPriorities(SDL_LOG_PRIORITY_WARN);
     #endif
+    #ifdef PIKA_ALLOC_TRACKING
+    // The allocation reports are logged with SDL_Log: show them also in release builds
+    SDL_SetLogPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+    #endif
     // Create a Game object that will be passed back to each callback:
     *appstate = new pika::Game;
     return SDL_APP_CONTINUE;
 }
 
 SDL_AppResult SDL_AppIterate(void *appstate) {
-    const unsigned long start_time = SDL_GetTicksNS();
     pika::Game& game = *static_cast<pika::Game *>(appstate);
     // Execute game update step and draw
     game.step();
-    const unsigned long end_time = SDL_GetTicksNS();
-
-    const unsigned long sleep_time = game.get_frame_time() - (end_time - start_time);
-    if (sleep_time > 0) {
-        SDL_DelayPrecise(sleep_time);
-    }
+    // Wait until the deadline of the frame
+    game.wait_next_frame();
     return SDL_APP_CONTINUE;
 }
 
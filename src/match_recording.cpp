@@ -0,0 +1,144 @@
+#include "match_recording.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "SDL3/SDL.h"
+
+namespace pika {
+
+namespace {
+
+// File format: magic, version, seed, number of frames (little endian 32-bit values) and the packed frames
+constexpr char file_magic[4] {'P', 'I', 'K', 'R'};
+constexpr std::uint32_t file_version = 1;
+
+// Packed input: x direction (bits 0-1) and y direction (bits 2-3) plus one, power hit (bit 4)
+std::uint8_t pack_input(const PlayerInput& input) {
+  return static_cast<std::uint8_t>((static_cast<int>(input.direction_x) + 1) |
+                                   (static_cast<int>(input.direction_y) + 1) << 2 |
+                                   (input.power_hit ? 1 : 0) << 4);
+}
+
+PlayerInput unpack_input(const std::uint8_t packed) {
+  return {
+    .direction_x = static_cast<DirX>((packed & 0x3) - 1),
+    .direction_y = static_cast<DirY>((packed >> 2 & 0x3) - 1),
+    .power_hit = (packed & 0x10) != 0,
+  };
+}
+
+// Packed commands: win score (bits 0-4), skip game end (bit 5), next round (bit 6)
+constexpr std::uint8_t win_score_mask = 0x1F;
+constexpr std::uint8_t skip_game_end_bit = 0x20;
+constexpr std::uint8_t next_round_bit = 0x40;
+
+/** Check that the fields of a packed frame have valid values */
+bool is_valid_frame(const std::array<std::uint8_t, 3>& frame) {
+  const auto valid_input = [](const std::uint8_t input) {
+    return (input & 0x3) <= 2 && (input >> 2 & 0x3) <= 2 && (input & ~0x1F) == 0;
+  };
+  return valid_input(frame[0]) && valid_input(frame[1]) && (frame[2] & win_score_mask) > 0 && (frame[2] & 0x80) == 0;
+}
+
+using IOStream = std::unique_ptr<SDL_IOStream, decltype(&SDL_CloseIO)>;
+
+} // namespace
+
+void MatchRecording::start(const std::uint32_t seed) {
+  seed_ = seed;
+  frames_.clear();
+}
+
+bool MatchRecording::push(const MatchFrame& frame) {
+  if (full()) {
+    return false;
+  }
+  frames_.push_back({
+    pack_input(frame.input_left),
+    pack_input(frame.input_right),
+    static_cast<std::uint8_t>((frame.win_score & win_score_mask) |
+                              (frame.skip_game_end ? skip_game_end_bit : 0) |
+                              (frame.next_round ? next_round_bit : 0)),
+  });
+  return true;
+}
+
+MatchFrame MatchRecording::operator[](const std::size_t index) const {
+  const PackedFrame& packed = frames_[index];
+  return {
+    .input_left = unpack_input(packed[0]),
+    .input_right = unpack_input(packed[1]),
+    .win_score = packed[2] & win_score_mask,
+    .skip_game_end = (packed[2] & skip_game_end_bit) != 0,
+    .next_round = (packed[2] & next_round_bit) != 0,
+  };
+}
+
+bool MatchRecording::save(const char* filename) const {
+  IOStream output {SDL_IOFromFile(filename, "wb"), SDL_CloseIO};
+  if (!output) {
+    SDL_Log("Unable to open %s! SDL Error: %s\n", filename, SDL_GetError());
+    return false;
+  }
+  const std::size_t frames_bytes = frames_.size() * sizeof(PackedFrame);
+  const bool written = SDL_WriteIO(output.get(), file_magic, sizeof(file_magic)) == sizeof(file_magic) &&
+                       SDL_WriteU32LE(output.get(), file_version) &&
+                       SDL_WriteU32LE(output.get(), seed_) &&
+                       SDL_WriteU32LE(output.get(), static_cast<std::uint32_t>(frames_.size())) &&
+                       SDL_WriteIO(output.get(), frames_.data(), frames_bytes) == frames_bytes;
+  // The data may be written when the file is closed
+  if (!SDL_CloseIO(output.release()) || !written) {
+    SDL_Log("Error writing %s! SDL Error: %s\n", filename, SDL_GetError());
+    return false;
+  }
+  return true;
+}
+
+bool MatchRecording::load(const char* filename) {
+  const IOStream input {SDL_IOFromFile(filename, "rb"), SDL_CloseIO};
+  if (!input) {
+    SDL_Log("Unable to open %s! SDL Error: %s\n", filename, SDL_GetError());
+    return false;
+  }
+  char magic[4] {};
+  std::uint32_t version = 0;
+  std::uint32_t seed = 0;
+  std::uint32_t frames = 0;
+  if (SDL_ReadIO(input.get(), magic, sizeof(magic)) != sizeof(magic) ||
+      !SDL_ReadU32LE(input.get(), &version) || !SDL_ReadU32LE(input.get(), &seed) ||
+      !SDL_ReadU32LE(input.get(), &frames)) {
+    SDL_Log("%s is not a match recording (truncated header)", filename);
+    return false;
+  }
+  if (!std::equal(std::begin(magic), std::end(magic), std::begin(file_magic)) || version != file_version) {
+    SDL_Log("%s is not a match recording (or its version %u is not supported)", filename, version);
+    return false;
+  }
+  if (frames > max_frames) {
+    SDL_Log("%s has too many frames (%u)", filename, frames);
+    return false;
+  }
+
+  std::vector<PackedFrame> read_frames(frames);
+  const std::size_t frames_bytes = read_frames.size() * sizeof(PackedFrame);
+  if (SDL_ReadIO(input.get(), read_frames.data(), frames_bytes) != frames_bytes) {
+    SDL_Log("%s is truncated (%u frames expected)", filename, frames);
+    return false;
+  }
+  for (std::size_t i = 0; i < read_frames.size(); i++) {
+    if (!is_valid_frame(read_frames[i])) {
+      SDL_Log("%s has an invalid frame (%zu)", filename, i);
+      return false;
+    }
+  }
+
+  seed_ = seed;
+  frames_ = std::move(read_frames);
+  frames_.reserve(max_frames);
+  return true;
+}
+
+} // namespace pika
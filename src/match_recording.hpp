@@ -0,0 +1,67 @@
+#ifndef PIKA_MATCH_RECORDING_HPP
+#define PIKA_MATCH_RECORDING_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <pikaball/volley_match.hpp>
+
+namespace pika {
+
+/**
+ * Recording of a match: the seed of the physics and the frames of the VolleyMatch.
+ * It is enough to play the whole match again (e.g. to export it to video), including
+ * the physics events that drive the sounds.
+ *
+ * The frames are packed in 3 bytes, in a buffer preallocated for a long match, so recording
+ * never allocates. The frames of pauses and instant replays are not part of the match.
+ */
+class MatchRecording {
+public:
+  // Maximum number of frames (about 36 minutes of game at 30 FPS, 192 KB)
+  constexpr static std::size_t max_frames = 1 << 16;
+
+  MatchRecording() { frames_.reserve(max_frames); }
+
+  /**
+   * Start recording a new match (the previous frames are discarded)
+   * @param seed The seed the match was started with (see VolleyMatch::start())
+   */
+  void start(std::uint32_t seed);
+
+  /**
+   * Add the next frame of the match
+   * @return False if the recording is full (the frame is not recorded)
+   */
+  bool push(const MatchFrame& frame);
+
+  [[nodiscard]] std::uint32_t seed() const { return seed_; }
+  [[nodiscard]] std::size_t size() const { return frames_.size(); }
+  [[nodiscard]] bool empty() const { return frames_.empty(); }
+  [[nodiscard]] bool full() const { return frames_.size() >= max_frames; }
+  /** Frame at the given position (lower than size()) */
+  [[nodiscard]] MatchFrame operator[](std::size_t index) const;
+
+  /**
+   * Write the recording to a file
+   * @return True if it was written
+   */
+  [[nodiscard]] bool save(const char* filename) const;
+
+  /**
+   * Read a recording written by save()
+   * @return True if it was read (the errors are logged)
+   */
+  [[nodiscard]] bool load(const char* filename);
+
+private:
+  using PackedFrame = std::array<std::uint8_t, 3>;
+
+  std::uint32_t seed_ {0};
+  std::vector<PackedFrame> frames_;
+};
+
+} // namespace pika
+
+#endif // PIKA_MATCH_RECORDING_HPP
@@ -0,0 +1,71 @@
+/**
+ * Asset packer (build time host tool).
+ * Writes all the game assets into a single pack with a hashed index and compressed entries
+ * (see asset_pack.hpp). The pack is embedded in the game, and it can also be shipped next to
+ * the executable to override the embedded assets without relinking.
+ *
+ * Usage: pikaball_pack output.pack name=path [name=path ...]
+ *   name is the resource filename used by the game (e.g. assets/sounds/pi.wav)
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <pikaball/asset_pack.hpp>
+
+using namespace pika;
+
+namespace {
+
+bool read_file(const std::string& path, std::vector<std::byte>& data) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  const std::vector<char> contents {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  data.resize(contents.size());
+  std::ranges::transform(contents, data.begin(), [](const char c) { return static_cast<std::byte>(c); });
+  return !file.bad();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::fprintf(stderr, "Usage: %s output.pack name=path [name=path ...]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  std::vector<AssetPack::Input> assets;
+  std::size_t total_size = 0;
+  for (int i = 2; i < argc; i++) {
+    const std::string argument = argv[i];
+    const auto separator = argument.find('=');
+    if (separator == std::string::npos) {
+      std::fprintf(stderr, "Invalid asset %s (expected name=path)\n", argv[i]);
+      return EXIT_FAILURE;
+    }
+    AssetPack::Input& asset = assets.emplace_back();
+    asset.name = argument.substr(0, separator);
+    const std::string path = argument.substr(separator + 1);
+    if (!read_file(path, asset.data)) {
+      std::fprintf(stderr, "Unable to read %s\n", path.c_str());
+      return EXIT_FAILURE;
+    }
+    total_size += asset.data.size();
+  }
+
+  const std::vector<std::byte> pack = AssetPack::build(assets);
+  std::ofstream output(argv[1], std::ios::binary);
+  output.write(reinterpret_cast<const char*>(pack.data()), static_cast<std::streamsize>(pack.size()));
+  if (!output) {
+    std::fprintf(stderr, "Unable to write %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+  std::printf("Packed %zu assets | %zu -> %zu bytes\n", assets.size(), total_size, pack.size());
+  return EXIT_SUCCESS;
+}
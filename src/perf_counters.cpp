@@ -0,0 +1,154 @@
+#include <pikaball/perf_counters.hpp>
+
+#ifdef __linux__
+#include <cstdint>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace pika {
+
+#ifdef __linux__
+
+namespace {
+
+/** Type and config of each PerfEvent for perf_event_open */
+struct EventConfig {
+  std::uint32_t type;
+  std::uint64_t config;
+};
+
+constexpr std::array<EventConfig, num_perf_events> event_configs {{
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+  {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                       (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+}};
+
+/** Values read from the group leader (read_format with the group and the enabled and running times) */
+struct GroupValues {
+  std::uint64_t size;
+  std::uint64_t time_enabled;
+  std::uint64_t time_running;
+  std::array<std::uint64_t, num_perf_events> values;
+};
+
+/**
+ * Open a counter of the calling thread
+ * @param event The event to count
+ * @param group_fd File descriptor of the group leader, or -1 to open a new group leader
+ */
+int open_counter(const EventConfig& event, const int group_fd) {
+  perf_event_attr attr {};
+  attr.size = sizeof(attr);
+  attr.type = event.type;
+  attr.config = event.config;
+  // The leader starts disabled, and the members count whenever the leader does
+  attr.disabled = group_fd < 0 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  // This thread, any CPU
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+  fds_.fill(-1);
+  const auto cycles = static_cast<std::size_t>(PerfEvent::Cycles);
+  fds_[cycles] = open_counter(event_configs[cycles], -1);
+  if (leader() < 0) {
+    return;
+  }
+  group_events_[group_size_++] = PerfEvent::Cycles;
+  // The events that the CPU does not support are left out of the group
+  for (std::size_t i = 0; i < num_perf_events; i++) {
+    if (i == cycles) {
+      continue;
+    }
+    fds_[i] = open_counter(event_configs[i], leader());
+    if (fds_[i] >= 0) {
+      group_events_[group_size_++] = static_cast<PerfEvent>(i);
+    }
+  }
+}
+
+PerfCounters::~PerfCounters() {
+  // Close the members before the leader
+  for (std::size_t i = num_perf_events; i-- > 0;) {
+    if (fds_[i] >= 0 && fds_[i] != leader()) {
+      close(fds_[i]);
+    }
+  }
+  if (leader() >= 0) {
+    close(leader());
+  }
+}
+
+void PerfCounters::reset() {
+  if (leader() >= 0) {
+    ioctl(leader(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+void PerfCounters::enable() {
+  if (leader() >= 0) {
+    ioctl(leader(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+void PerfCounters::disable() {
+  if (leader() >= 0) {
+    ioctl(leader(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+PerfCounts PerfCounters::read() const {
+  PerfCounts counts;
+  GroupValues group {};
+  const auto expected_size = static_cast<ssize_t>(3 * sizeof(std::uint64_t) + group_size_ * sizeof(std::uint64_t));
+  if (leader() < 0 || ::read(leader(), &group, sizeof(group)) < expected_size || group.size != group_size_) {
+    return counts;
+  }
+  // If the group never got the hardware counters while enabled, the counts are unknown
+  if (group.time_running == 0 && group.time_enabled > 0) {
+    return counts;
+  }
+  // Scale the counts if the group was multiplexed with other programs (same factor for all the events)
+  const double scale = group.time_running == 0 ? 0.0 :
+    static_cast<double>(group.time_enabled) / static_cast<double>(group.time_running);
+  for (std::size_t i = 0; i < group_size_; i++) {
+    const auto event = static_cast<std::size_t>(group_events_[i]);
+    counts.values[event] = static_cast<double>(group.values[i]) * scale;
+    counts.available[event] = true;
+  }
+  return counts;
+}
+
+#else
+
+PerfCounters::PerfCounters() {
+  fds_.fill(-1);
+}
+
+PerfCounters::~PerfCounters() = default;
+
+void PerfCounters::reset() {}
+
+void PerfCounters::enable() {}
+
+void PerfCounters::disable() {}
+
+PerfCounts PerfCounters::read() const {
+  return {};
+}
+
+#endif
+
+} // namespace pika
@@ -1,17 +1,16 @@
 #include <pikaball/physics/ball.hpp>
 #include <cmath>
-#include <pikaball/random.hpp>
 
 namespace pika {
 
-void Ball::initialize(const FieldSide& field_side) {
-  x_ = (field_side == FieldSide::Left) ? 56 : ground_width - 56;
-  y_ = 0;
-  velocity_x_ = 0;
-  velocity_y_ = 1;
+template <PhysicsRules Rules>
+void BasicBall<Rules>::initialize(const FieldSide& field_side) {
+  state_.x = (field_side == FieldSide::Left) ? 56 : ground_width - 56;
+  state_.y = 0;
+  state_.velocity_x = 0;
+  state_.velocity_y = 1;
   punch_effect_radius_ = 0;
   power_hit_ = false;
-  sound_ = BallSound::None;
 
   // The reset of the variables below is not included in the original game not the js version
   rotation_ = 0;
@@ -21,42 +20,57 @@ void Ball::initialize(const FieldSide& field_side) {
   punch_effect_radius_ = 0;
   power_hit_ = false;
   expected_landing_x_ = 0;
+  frames_until_landing_ = 0;
+  landing_outdated_ = true;
   trailing_x_ = {};
   trailing_y_ = {};
 }
 
-bool Ball::update() {
-  // This is not part of this function in the original assembly code.
-  // In the original assembly code, it is processed in other function (FUN_00402ee0)
-  // But it is proper to process here.
-  trailing_x_[1] = trailing_x_[0];
-  trailing_y_[1] = trailing_y_[0];
-  trailing_x_[0] = x_;
-  trailing_y_[0] = y_;
-  // Update ball radius effect (it will decrease with every update call
-  decrease_punch_effect_radius();
-
-  int next_fine_rotation = fine_rotation_ + velocity_x_ / 2;
-  // If next_fine_rotation === 50, it skips next if statement finely.
-  // Then fine_rotation_ = 50, and then rotation_ = 5 (which designates hyper ball sprite!).
-  // In this way, hyper ball glitch occur!
-  // If this happens at the end of round,
-  // since velocity_x_ is 0-initialized at each start of round,
-  // hyper ball sprite is rendered continuously until a collision happens.
-  if (next_fine_rotation < 0) {
-    next_fine_rotation += 50;
-  }
-  if (next_fine_rotation > 50) {
-    next_fine_rotation += -50;
-  }
-  fine_rotation_ = next_fine_rotation;
-  rotation_ = fine_rotation_ / 10;
-
-  return update_position();
+template <PhysicsRules Rules>
+bool BasicBall<Rules>::update(PhysicsEventQueue& events) {
+  if constexpr (Rules::simulate_cosmetics) {
+    // This is not part of this function in the original assembly code.
+    // In the original assembly code, it is processed in other function (FUN_00402ee0)
+    // But it is proper to process here.
+    trailing_x_[1] = trailing_x_[0];
+    trailing_y_[1] = trailing_y_[0];
+    trailing_x_[0] = state_.x;
+    trailing_y_[0] = state_.y;
+    // Update ball radius effect (it will decrease with every update call
+    decrease_punch_effect_radius();
+
+    int next_fine_rotation = fine_rotation_ + state_.velocity_x / 2;
+    // If next_fine_rotation === 50, it skips next if statement finely.
+    // Then fine_rotation_ = 50, and then rotation_ = 5 (which designates hyper ball sprite!).
+    // In this way, hyper ball glitch occur!
+    // If this happens at the end of round,
+    // since velocity_x is 0-initialized at each start of round,
+    // hyper ball sprite is rendered continuously until a collision happens.
+    if (next_fine_rotation < 0) {
+      next_fine_rotation += 50;
+    }
+    if (next_fine_rotation > 50) {
+      next_fine_rotation += -50;
+    }
+    fine_rotation_ = next_fine_rotation;
+    rotation_ = fine_rotation_ / 10;
+  }
+
+  const bool ground_hit = update_position(events);
+  if (ground_hit) {
+    // The ball bounced, so the previous prediction does not apply anymore
+    landing_outdated_ = true;
+  }
+  else if (frames_until_landing_ > 0) {
+    // Still following the predicted trajectory, one frame closer to the ground
+    frames_until_landing_--;
+  }
+  return ground_hit;
 }
 
-bool Ball::update_position() {
-  const int next_x = x_ + velocity_x_;
+template <PhysicsRules Rules>
+bool step_trajectory(BallState& state, bool* net_bounce) {
+  const int next_x = state.x + state.velocity_x;
   /*
     If the center of ball would get out of left world bound or right world bound, bounce back.
 
@@ -68,43 +82,77 @@ bool Ball::update_position() {
     Or, was it set to this value to resolve infinite loop problem? (See comments on the constant INFINITE_LOOP_LIMIT.)
     If apply (next_x > (ground_width - ball_radius)), and if the maximum number of loop is not limited,
     it is observed that infinite loop in the function expectedLandingPointXWhenPowerHit does not terminate.
+
+    The bounds are taken from the rules policy: OriginalRules keeps the values of the original game,
+    SymmetricRules applies the former change.
   */
-  if (next_x < ball_radius || next_x > ground_width) {
-    velocity_x_ = - velocity_x_;
+  if (next_x < Rules::ball_min_x || next_x > Rules::ball_max_x) {
+    state.velocity_x = - state.velocity_x;
   }
 
-  int next_y = y_ + velocity_y_;
+  int next_y = state.y + state.velocity_y;
   // Check if the ball touches the ceiling
   if (next_y < 0) {
-    velocity_y_ = 1;
+    state.velocity_y = 1;
   }
 
   // Check if ball touches the net
-  const auto net_distance = (x_ > ground_h_width) ? x_ - ground_h_width
-                                                  : ground_h_width - x_;
-  if (net_distance < net_pillar_h_width && y_ > net_top_top_y) {
-    if (y_ <= net_top_bottom_y) {
+  if (touches_net(state)) {
+    const int velocity_x = state.velocity_x;
+    const int velocity_y = state.velocity_y;
+    if (state.y <= net_top_bottom_y) {
       // The ball collides with the top of the net and bounces back up
-      if (velocity_y_ > 0) {
-        velocity_y_ = - velocity_y_;
+      if (state.velocity_y > 0) {
+        state.velocity_y = - state.velocity_y;
       }
     }
     else {
       // The ball collides with the net and bounces back left/right
-      if (x_ < ground_h_width) {
+      if (state.x < ground_h_width) {
         // TODO: I think this conditional produces the glitch that makes the ball pierce the net!
-        velocity_x_ = - std::abs(velocity_x_);
+        state.velocity_x = - std::abs(state.velocity_x);
       }
       else {
-        velocity_x_ = std::abs(velocity_x_);
+        state.velocity_x = std::abs(state.velocity_x);
       }
     }
+    // Contacts that do not change the velocity (e.g. the ball still overlapping the net after a bounce) are not bounces
+    if (net_bounce != nullptr) {
+      *net_bounce = state.velocity_x != velocity_x || state.velocity_y != velocity_y;
+    }
   }
 
-  next_y = y_ + velocity_y_;
+  next_y = state.y + state.velocity_y;
   // Check if the ball touches the ground
-  bool ground_hit = false;
   if (next_y > ball_ground_y) {
+    state.velocity_y = - state.velocity_y;
+    state.y = ball_ground_y;
+    return true;
+  }
+  // Update position
+  state.y += state.velocity_y;
+  state.x += state.velocity_x;
+  // Gravity effect
+  state.velocity_y++;
+  return false;
+}
+
+template <PhysicsRules Rules>
+bool BasicBall<Rules>::update_position(PhysicsEventQueue& events) {
+  // The net bounce is emitted at the position where the ball touches the net (before the step)
+  const BallState contact = state_;
+  bool net_bounce = false;
+  const bool ground_hit = step_trajectory<Rules>(state_, &net_bounce);
+  if (net_bounce) {
+    events.push({
+      .type = PhysicsEventType::NetBounce,
+      .side = (contact.x < ground_h_width) ? FieldSide::Left : FieldSide::Right,
+      .x = contact.x,
+      .y = contact.y,
+      .power_hit = power_hit_,
+    });
+  }
+  if (ground_hit) {
     // FUN_00408470 omitted
     // the function omitted above receives 100 * (x_ - 216),
     // i.e. horizontal displacement from net maybe for stereo sound?
@@ -112,55 +160,52 @@ bool Ball::update_position() {
     // the omitted two functions maybe do a part of sound playback role.
 
     // ball.sound.ballTouchesGround = true;
-    // Play the "ball touches ground" sound
-    sound_ = BallSound::Ground;
+    emit(PhysicsEventType::BallGround, field_side(), events);
 
-    velocity_y_ = - velocity_y_;
-    punch_effect_x_ = x_;
-    y_ = ball_ground_y;
-    punch_effect_radius_ = ball_radius;
+    // The punch effect position is also used to decide who scored,
+    // so it is updated even if the cosmetic effects are disabled
+    punch_effect_x_ = state_.x;
     punch_effect_y_ = ball_ground_y + ball_radius;
-    ground_hit = true;
-  }
-  else {
-    // Update position
-    y_ += velocity_y_;
-    x_ += velocity_x_;
-    // Gravity effect
-    velocity_y_++;
+    if constexpr (Rules::simulate_cosmetics) {
+      punch_effect_radius_ = ball_radius;
+    }
   }
   return ground_hit;
 }
 
-bool Ball::collision_with_player(const Player& player) const {
-  const int diff_x = x_ - player.x();
-  const int diff_y = y_ - player.y();
+template <PhysicsRules Rules>
+bool BasicBall<Rules>::collision_with_player(const BasicPlayer<Rules>& player) const {
+  const int diff_x = state_.x - player.x();
+  const int diff_y = state_.y - player.y();
   return std::abs(diff_x) <= player_h_size && std::abs(diff_y) <= player_h_size;
 }
 
-void Ball::process_player_hit(const Player &player, const PlayerInput &input) {
+template <PhysicsRules Rules>
+void BasicBall<Rules>::process_player_hit(const BasicPlayer<Rules>& player, const PlayerInput& input,
+                                          PhysicsEventQueue& events, PhysicsRandom& random) {
 
   // Base y velocity is always updated when the ball hits the player
-  const int abs_velocity_y = std::abs(velocity_y_);
-  velocity_y_ = - abs_velocity_y;
+  const int abs_velocity_y = std::abs(state_.velocity_y);
+  state_.velocity_y = - abs_velocity_y;
 
   if (abs_velocity_y < 15) {
-    velocity_y_ = -15;
+    state_.velocity_y = -15;
   }
 
   if (player.state() == PlayerState::PowerHit) {
     // Player is jumping and power hitting
     // Base velocity is halved if no direction is pressed when power hitting
-    velocity_x_ = input.direction_x == DirX::None ? 10 : 20;
-    if (x_ >= ground_h_width) {
+    state_.velocity_x = input.direction_x == DirX::None ? Rules::power_hit_velocity_x / 2
+                                                        : Rules::power_hit_velocity_x;
+    if (state_.x >= ground_h_width) {
       // CAUTION: If the ball is exactly at the middle, it will also go to the left!!
-      velocity_x_ = - velocity_x_;
+      state_.velocity_x = - state_.velocity_x;
     }
 
-    punch_effect_x_ = x_;
-    punch_effect_y_ = y_;
+    punch_effect_x_ = state_.x;
+    punch_effect_y_ = state_.y;
 
-    velocity_y_ = 2 * std::abs(velocity_y_) * static_cast<int>(input.direction_y);
+    state_.velocity_y = 2 * std::abs(state_.velocity_y) * static_cast<int>(input.direction_y);
     punch_effect_radius_ = ball_radius;
 
     // maybe-stereo-sound function FUN_00408470 (0x90) omitted:
@@ -168,49 +213,68 @@ void Ball::process_player_hit(const Player &player, const PlayerInput &input) {
     // maybe-soundcode function (ballpointer + 0x24 + 0x10) omitted:
     // ball.sound.powerHit = true;
 
-    // Play the "Ball hit by player" sound
-    sound_ = BallSound::Hit;
-
     power_hit_ = true;
   }
   else {
     // Player is on the ground and ball hits the player
     // The x velocity depends on the distance to the center of the player
-    const int diff_x = x_ - player.x();
+    const int diff_x = state_.x - player.x();
     const int abs_distance = std::abs(diff_x);
-    if (x_ < player.x()) {
-      velocity_x_ = - (abs_distance / 3);
+    if (state_.x < player.x()) {
+      state_.velocity_x = - (abs_distance / 3);
     }
-    else if (x_ > player.x()) {
-      velocity_x_ = abs_distance / 3;
+    else if (state_.x > player.x()) {
+      state_.velocity_x = abs_distance / 3;
     }
 
-    if (velocity_x_ == 0) {
+    if (state_.velocity_x == 0) {
       // If ball velocity x is 0, randomly choose one of -1, 0, 1.
-      velocity_x_ = rand_int() % 3 - 1;
+      state_.velocity_x = static_cast<int>(random() % 3) - 1;
     }
 
     power_hit_ = false;
   }
 
+  emit(PhysicsEventType::BallHit, player.side(), events);
+
   // After updating the velocities, estimate next landing point
   calculate_landing_point();
 }
 
 
-void Ball::calculate_landing_point() {
-  Ball ball_clone = *this;
-  size_t loop_counter = 0;
+template <PhysicsRules Rules>
+LandingPrediction predict_landing(BallState state) {
+  LandingPrediction prediction {};
   while (true) {
-    loop_counter++;
-    if (ball_clone.update_position() || loop_counter >= infinite_loop_limit) {
+    prediction.frames++;
+    prediction.landed = step_trajectory<Rules>(state);
+    if (prediction.landed || prediction.frames >= static_cast<int>(Rules::infinite_loop_limit)) {
       break;
     }
   }
-  expected_landing_x_ = ball_clone.x_;
+  prediction.x = state.x;
+  return prediction;
+}
+
+template <PhysicsRules Rules>
+void BasicBall<Rules>::calculate_landing_point() {
+  const LandingPrediction prediction = predict_landing<Rules>(state_);
+  expected_landing_x_ = prediction.x;
+  frames_until_landing_ = prediction.frames;
+  // If the loop limit was reached, a prediction from a later frame would
+  // simulate further and give a different result. Keep recomputing it.
+  landing_outdated_ = !prediction.landed;
 }
 
-void Ball::decrease_punch_effect_radius() {
+template <PhysicsRules Rules>
+void BasicBall<Rules>::update_landing_point() {
+  if (landing_outdated_) {
+    calculate_landing_point();
+  }
+}
+
+template <PhysicsRules Rules>
+void BasicBall<Rules>::decrease_punch_effect_radius() {
   if (punch_effect_radius_ > 2) {
     punch_effect_radius_ -= 2;
   }
@@ -219,8 +283,52 @@ void Ball::decrease_punch_effect_radius() {
   }
 }
 
-void Ball::reset_sound() {
-  sound_ = BallSound::None;
+template <PhysicsRules Rules>
+void BasicBall<Rules>::emit(const PhysicsEventType type, const FieldSide side,
+                            PhysicsEventQueue& events) const {
+  events.push({
+    .type = type,
+    .side = side,
+    .x = state_.x,
+    .y = state_.y,
+    .power_hit = power_hit_,
+  });
+}
+
+template <PhysicsRules Rules>
+BallSnapshot BasicBall<Rules>::snapshot() const {
+  return {
+    .x = static_cast<std::int16_t>(state_.x),
+    .y = static_cast<std::int16_t>(state_.y),
+    .punch_effect_x = static_cast<std::int16_t>(punch_effect_x_),
+    .punch_effect_y = static_cast<std::int16_t>(punch_effect_y_),
+    .trailing_x = {static_cast<std::int16_t>(trailing_x_[0]), static_cast<std::int16_t>(trailing_x_[1])},
+    .trailing_y = {static_cast<std::int16_t>(trailing_y_[0]), static_cast<std::int16_t>(trailing_y_[1])},
+    .rotation = static_cast<std::uint8_t>(rotation_),
+    .punch_effect_radius = static_cast<std::uint8_t>(punch_effect_radius_),
+    .power_hit = power_hit_,
+  };
 }
 
+template <PhysicsRules Rules>
+void BasicBall<Rules>::restore(const BallSnapshot& snapshot) {
+  state_.x = snapshot.x;
+  state_.y = snapshot.y;
+  punch_effect_x_ = snapshot.punch_effect_x;
+  punch_effect_y_ = snapshot.punch_effect_y;
+  trailing_x_ = {snapshot.trailing_x[0], snapshot.trailing_x[1]};
+  trailing_y_ = {snapshot.trailing_y[0], snapshot.trailing_y[1]};
+  rotation_ = snapshot.rotation;
+  punch_effect_radius_ = snapshot.punch_effect_radius;
+  power_hit_ = snapshot.power_hit;
+}
+
+template bool step_trajectory<OriginalRules>(BallState&, bool*);
+template bool step_trajectory<SymmetricRules>(BallState&, bool*);
+template LandingPrediction predict_landing<OriginalRules>(BallState);
+template LandingPrediction predict_landing<SymmetricRules>(BallState);
+template class BasicBall<OriginalRules>;
+template class BasicBall<SymmetricRules>;
+template class BasicBall<HeadlessRules>;
+
 } // pika
\ No newline at end of file
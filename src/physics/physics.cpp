@@ -1,50 +1,82 @@
 #include <pikaball/physics/physics.hpp>
+#include <pikaball/trace.hpp>
+
+#include <algorithm>
 
 namespace pika {
 
-Physics::Physics() :
+template <PhysicsRules Rules>
+Physics<Rules>::Physics() :
   player_left_(FieldSide::Left),
-  player_right_(FieldSide::Right)
+  player_right_(FieldSide::Right),
+  random_(rand_int())
 {}
 
-void Physics::init_round(const FieldSide &field_side) {
+template <PhysicsRules Rules>
+void Physics<Rules>::seed(const std::uint32_t seed) {
+  random_.seed(seed);
+}
+
+template <PhysicsRules Rules>
+void Physics<Rules>::init_round(const FieldSide &field_side) {
+  round_active_ = true;
   ball_.initialize(field_side);
   player_left_.initialize_round();
   player_right_.initialize_round();
 }
 
-void Physics::restart() {
+template <PhysicsRules Rules>
+void Physics<Rules>::restart() {
+  round_active_ = true;
   ball_.initialize(FieldSide::Left);
   player_left_.initialize_game();
   player_right_.initialize_game();
 }
 
-bool Physics::update(const PlayerInput& input_left,
-                     const PlayerInput& input_right) {
-  // Update ball position and calculate the estimated landing point
-  const bool ball_touching_ground = ball_.update();
-  ball_.calculate_landing_point();
+template <PhysicsRules Rules>
+bool Physics<Rules>::update(const PlayerInput& input_left,
+                            const PlayerInput& input_right) {
+  PIKA_TRACE_ZONE("Physics::update");
+  events_.clear();
+
+  // Update ball position and refresh the estimated landing point (only if the trajectory changed)
+  const bool ball_touching_ground = ball_.update(events_);
+  ball_.update_landing_point();
+
+  if (ball_touching_ground && round_active_) {
+    // The first time the ball touches the ground, the point goes to the other side
+    round_active_ = false;
+    events_.push({
+      .type = PhysicsEventType::Score,
+      .side = (ball_.punch_effect_x() < ground_h_width) ? FieldSide::Right : FieldSide::Left,
+      .x = ball_.punch_effect_x(),
+      .y = ball_.punch_effect_y(),
+    });
+  }
 
   // Update player positions
-  player_left_.update(input_left);
-  player_right_.update(input_right);
+  player_left_.update(input_left, events_);
+  player_right_.update(input_right, events_);
 
   // Check collision between ball and players and process it
   collision_ball_player(player_left_, input_left);
   collision_ball_player(player_right_, input_right);
 
+  dispatch_events();
   return ball_touching_ground;
 }
 
-void Physics::end_game(const FieldSide& field_side) {
+template <PhysicsRules Rules>
+void Physics<Rules>::end_game(const FieldSide& field_side) {
   player_left_.end_game(field_side == FieldSide::Left);
   player_right_.end_game(field_side == FieldSide::Right);
 }
 
-void Physics::collision_ball_player(Player& player, const PlayerInput& input) {
+template <PhysicsRules Rules>
+void Physics<Rules>::collision_ball_player(BasicPlayer<Rules>& player, const PlayerInput& input) {
   if (ball_.collision_with_player(player)) {
     if (!player.collision_with_ball) {
-      ball_.process_player_hit(player, input);
+      ball_.process_player_hit(player, input, events_, random_);
       player.collision_with_ball = true;
     }
   }
@@ -53,14 +85,63 @@ void Physics::collision_ball_player(Player& player, const PlayerInput& input) {
   }
 }
 
-const Player& Physics::player(const FieldSide& side) const {
+template <PhysicsRules Rules>
+const BasicPlayer<Rules>& Physics<Rules>::player(const FieldSide& side) const {
   return (side == FieldSide::Left) ? player_left_ : player_right_;
 }
 
-void Physics::reset_sound() {
-  player_left_.reset_sound();
-  player_right_.reset_sound();
-  ball_.reset_sound();
+template <PhysicsRules Rules>
+bool Physics<Rules>::subscribe(PhysicsEventListener* listener) {
+  if (std::ranges::find(listeners_, listener) != listeners_.end()) {
+    // Already subscribed
+    return true;
+  }
+  const auto free_slot = std::ranges::find(listeners_, nullptr);
+  if (free_slot == listeners_.end()) {
+    return false;
+  }
+  *free_slot = listener;
+  return true;
 }
 
+template <PhysicsRules Rules>
+void Physics<Rules>::unsubscribe(const PhysicsEventListener* listener) {
+  for (auto& slot : listeners_) {
+    if (slot == listener) {
+      slot = nullptr;
+    }
+  }
+}
+
+template <PhysicsRules Rules>
+void Physics<Rules>::dispatch_events() const {
+  for (std::size_t i = 0; i < events_.size(); i++) {
+    for (PhysicsEventListener* listener : listeners_) {
+      if (listener != nullptr) {
+        listener->on_physics_event(events_[i]);
+      }
+    }
+  }
+}
+
+template <PhysicsRules Rules>
+PhysicsSnapshot Physics<Rules>::capture() const {
+  return {
+    .ball = ball_.snapshot(),
+    .player_left = player_left_.snapshot(),
+    .player_right = player_right_.snapshot(),
+  };
+}
+
+template <PhysicsRules Rules>
+void Physics<Rules>::restore(const PhysicsSnapshot& snapshot) {
+  ball_.restore(snapshot.ball);
+  player_left_.restore(snapshot.player_left);
+  player_right_.restore(snapshot.player_right);
+}
+
+template class Physics<OriginalRules>;
+template class Physics<SymmetricRules>;
+template class Physics<HeadlessRules>;
+
 } // namespace pika
@@ -5,18 +5,21 @@
 #include <pikaball/random.hpp>
 
 namespace pika {
-Player::Player(const FieldSide &field_side) {
+template <PhysicsRules Rules>
+BasicPlayer<Rules>::BasicPlayer(const FieldSide &field_side) {
   field_side_ = field_side;
   initialize_game();
 }
 
-void Player::initialize_game() {
+template <PhysicsRules Rules>
+void BasicPlayer<Rules>::initialize_game() {
   game_ended_ = false;
   is_winner_ = false;
   initialize_round();
 }
 
-void Player::initialize_round() {
+template <PhysicsRules Rules>
+void BasicPlayer<Rules>::initialize_round() {
   x_ = (field_side_ == FieldSide::Left) ? 36 : ground_width - 36;
   y_ = player_ground_y;
   velocity_y_ = 0;
@@ -26,10 +29,10 @@ void Player::initialize_round() {
   anim_frame_number_ = 0;
   anim_arm_direction_ = 1;
   anim_frame_delay_ = 0;
-  sound_ = PlayerSound::None;
 }
 
-void Player::update(const PlayerInput& input) {
+template <PhysicsRules Rules>
+void BasicPlayer<Rules>::update(const PlayerInput& input, PhysicsEventQueue& events) {
   // Convert the left/right input keys to a [-1, 0, 1] integer
   // const int input_direction_x = get_input_direction_x(input);
 
@@ -48,11 +51,11 @@ void Player::update(const PlayerInput& input) {
   case PlayerState::Normal:
   case PlayerState::Jumping:
   case PlayerState::PowerHit:
-    velocity_x = static_cast<int>(input.direction_x) * 6;
+    velocity_x = static_cast<int>(input.direction_x) * Rules::player_velocity_x;
     break;
   case PlayerState::Diving:
   case PlayerState::AfterDiving:
-    velocity_x = static_cast<int>(diving_direction_) * 8;
+    velocity_x = static_cast<int>(diving_direction_) * Rules::dive_velocity_x;
     break;
   default:
     break;
@@ -73,16 +76,15 @@ void Player::update(const PlayerInput& input) {
   if (state_ == PlayerState::Normal &&
       input.direction_y == DirY::Up &&
       y_ == player_ground_y) {
-    velocity_y_ = -16;
+    velocity_y_ = Rules::jump_velocity_y;
     state_ = PlayerState::Jumping;
     anim_frame_number_ = 0;
 
-    // TODO: Sound
     // maybe-stereo-sound function FUN_00408470 (0x90) omitted:
     // refer to a detailed comment above about this function
     // maybe-sound code function (playerpointer + 0x90 + 0x10)? omitted
     // player.sound.chu = true;
-    sound_ = PlayerSound::Chu;
+    emit(PhysicsEventType::Jump, events);
   }
 
   // Gravity
@@ -110,7 +112,7 @@ void Player::update(const PlayerInput& input) {
   if (input.power_hit) {
     if (state_ == PlayerState::Jumping) {
       // If player is jumping... POWER HIT!!
-      anim_frame_delay_ = 5;
+      anim_frame_delay_ = player_animation(PlayerState::PowerHit).hold_ticks;
       anim_frame_number_ = 0;
       state_ = PlayerState::PowerHit;
 
@@ -119,7 +121,7 @@ void Player::update(const PlayerInput& input) {
       // refer to a detailed comment above about this function
       // maybe-sound function (playerpointer + 0x90 + 0x14)? omitted
       // player.sound.pika = true;
-      sound_ = PlayerSound::Pika;
+      emit(PhysicsEventType::PowerHit, events);
     }
     else if (state_ == PlayerState::Normal && input.direction_x != DirX::None) {
       // Diving!!
@@ -132,35 +134,20 @@ void Player::update(const PlayerInput& input) {
       // refer to a detailed comment above about this function
       // maybe-sound code function (playerpointer + 0x90 + 0x10)? omitted
       // player.sound.chu = true;
-      sound_ = PlayerSound::Chu;
+      emit(PhysicsEventType::Dive, events);
     }
   }
 
-  // Animations
-  if (state_ == PlayerState::Jumping) {
-    anim_frame_number_ = (anim_frame_number_ + 1) % 3;
+  // Animations (timings in player_animations)
+  // The power hit animation is part of the gameplay: the player goes back to
+  // the Jumping state when it ends. The rest of animations are only cosmetic.
+  // The winner / loser animations are advanced with the game end (below).
+  if (state_ == PlayerState::PowerHit) {
+    state_ = advance_animation(state_, anim_frame_number_, anim_frame_delay_, anim_arm_direction_);
   }
-  else if (state_ == PlayerState::PowerHit) {
-    if (anim_frame_delay_ < 1) {
-      anim_frame_number_++;
-      if (anim_frame_number_ > 4) {
-        anim_frame_number_ = 0;
-        state_ = PlayerState::Jumping;
-      }
-    }
-    else {
-      anim_frame_delay_--;
-    }
-  }
-  else if (state_ == PlayerState::Normal) {
-    anim_frame_delay_++;
-    if (anim_frame_delay_ > 3) {
-      anim_frame_delay_ = 0;
-      if (const int next_frame_number = anim_frame_number_ + anim_arm_direction_;
-          next_frame_number < 0 || next_frame_number > 4) {
-        anim_arm_direction_ = -anim_arm_direction_;
-      }
-      anim_frame_number_ += anim_arm_direction_;
+  else if constexpr (Rules::simulate_cosmetics) {
+    if (state_ != PlayerState::Winner && state_ != PlayerState::Loser) {
+      state_ = advance_animation(state_, anim_frame_number_, anim_frame_delay_, anim_arm_direction_);
     }
   }
 
@@ -174,7 +161,7 @@ void Player::update(const PlayerInput& input) {
         // refer to a detailed comment above about this function
         // maybe-sound code function (0x98 + 0x10) omitted
         // player.sound.pipikachu = true;
-        sound_ = PlayerSound::Pipikachu;
+        emit(PhysicsEventType::Win, events);
       }
       else {
         state_ = PlayerState::Loser;
@@ -186,25 +173,54 @@ void Player::update(const PlayerInput& input) {
     // FUN_004025e0
     // Process game end frames (winner / loser animations)
     // processGameEndFrameFor(player);
-    if (anim_frame_number_ < 4) {
-      anim_frame_delay_++;
-      if (anim_frame_delay_ > 4) {
-        anim_frame_delay_ = 0;
-        anim_frame_number_++;
-      }
+    // As in the OG game, the counters advance from the game end, even before the
+    // player lands and switches to the winner / loser state
+    if constexpr (Rules::simulate_cosmetics) {
+      const PlayerState end_state = is_winner_ ? PlayerState::Winner : PlayerState::Loser;
+      static_cast<void>(advance_animation(end_state, anim_frame_number_, anim_frame_delay_, anim_arm_direction_));
     }
 
   }
 }
 
-void Player::end_game(const bool is_winner) {
+template <PhysicsRules Rules>
+void BasicPlayer<Rules>::end_game(const bool is_winner) {
   game_ended_ = true;
   is_winner_ = is_winner;
 }
 
-void Player::reset_sound() {
-  sound_ = PlayerSound::None;
+template <PhysicsRules Rules>
+void BasicPlayer<Rules>::emit(const PhysicsEventType type, PhysicsEventQueue& events) const {
+  events.push({
+    .type = type,
+    .side = field_side_,
+    .x = x_,
+    .y = y_,
+  });
+}
+
+template <PhysicsRules Rules>
+PlayerSnapshot BasicPlayer<Rules>::snapshot() const {
+  return {
+    .x = static_cast<std::int16_t>(x_),
+    .y = static_cast<std::int16_t>(y_),
+    .state = static_cast<std::uint8_t>(state_),
+    .diving_direction = static_cast<std::int8_t>(diving_direction_),
+    .anim_frame_number = static_cast<std::uint8_t>(anim_frame_number_),
+  };
+}
+
+template <PhysicsRules Rules>
+void BasicPlayer<Rules>::restore(const PlayerSnapshot& snapshot) {
+  x_ = snapshot.x;
+  y_ = snapshot.y;
+  state_ = static_cast<PlayerState>(snapshot.state);
+  diving_direction_ = static_cast<DirX>(snapshot.diving_direction);
+  anim_frame_number_ = snapshot.anim_frame_number;
 }
 
+template class BasicPlayer<OriginalRules>;
+template class BasicPlayer<SymmetricRules>;
+template class BasicPlayer<HeadlessRules>;
 
 } // namespace pika
\ No newline at end of file
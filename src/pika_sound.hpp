@@ -1,11 +1,21 @@
 #ifndef PIKA_SOUND_HPP
 #define PIKA_SOUND_HPP
 
+#include <array>
+#include <future>
+#include <span>
+#include <utility>
+#include <vector>
+
 #include "SDL3/SDL_audio.h"
 #include "SDL3_mixer/SDL_mixer.h"
 
+#include <pikaball/alloc_tracking.hpp>
 #include <pikaball/resources.hpp>
+#include <pikaball/trace.hpp>
+#include <pikaball/worker_pool.hpp>
 #include <pikaball/physics/physics_common.hpp>  // For FieldSide
+#include <pikaball/physics/physics_events.hpp>
 
 namespace pika {
 
@@ -24,44 +34,60 @@ namespace pika {
  * A class to handle SDL resources (Window, Renderer, Audio, etc.)
  * Owns and manages the SDL objects.
  * It is responsible for calling SDL_Init and SDL_Quit.
+ *
+ * The game sounds are played by subscribing to the physics events.
+ * The sounds can be played live on the default audio device, or mixed offline
+ * (without audio device) to render the audio of an exported game faster than real time.
+ *
+ * The clips can be decoded in the background by a WorkerPool. In that case,
+ * wait_until_loaded() must be called before playing any sound.
+ * The short sound effects are fully decoded when loaded. The background music is not:
+ * it is decoded on the fly by the mixer, directly from the (embedded) MP3 data.
  */
-class PikaSound {
+class PikaSound final : public PhysicsEventListener {
 public:
   // Number of sound channels (number of elements in SoundChannel enum)
   static constexpr unsigned int num_channels = 4;
 
+  /** Where the mixed audio goes */
+  enum class Output {
+    Device,   // Played on the default playback device
+    Offline,  // Pulled by the caller with generate()
+  };
+
   PikaSound(PikaSound const&) = delete;
   PikaSound(PikaSound &&) = delete;
   PikaSound &operator=(PikaSound const&) = delete;
   PikaSound &operator=(PikaSound &&) = delete;
 
-  PikaSound() {
+  /**
+   * Open the mixer and load all the sounds
+   * @param output Where the mixed audio goes
+   * @param loader Optional pool to decode the clips in parallel. The constructor does not wait for them
+   */
+  explicit PikaSound(const Output output = Output::Device, WorkerPool* loader = nullptr) {
     // Initialize mixer
     MIX_Init();
-    // Open default audio device
-    audio_dev_id_ = SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &audio_spec_);
-    if(audio_dev_id_ == 0) {
-      SDL_Log("Unable to open audio! SDL error: %s\n", SDL_GetError());
-      throw std::runtime_error("Failed to open audio device");
+    if (output == Output::Device) {
+      // Open default audio device
+      audio_dev_id_ = SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &audio_spec_);
+      if(audio_dev_id_ == 0) {
+        SDL_Log("Unable to open audio! SDL error: %s\n", SDL_GetError());
+        throw std::runtime_error("Failed to open audio device");
+      }
+      // Initialize SDL_mixer
+      mixer_ = MIX_CreateMixerDevice(audio_dev_id_, &audio_spec_);
+    }
+    else {
+      // Mixer without device. The audio is only generated when requested
+      mixer_ = MIX_CreateMixer(&audio_spec_);
     }
-    // Initialize SDL_mixer
-    mixer_ = MIX_CreateMixerDevice(audio_dev_id_, &audio_spec_);
     if(!mixer_)
     {
       SDL_Log( "SDL_mixer could not initialize! SDL_mixer error: %s\n", SDL_GetError());
       throw std::runtime_error("SDL_mixer could not initialize");
     }
 
-    // Load sounds
-    sound_pi_ = load_audio(sound_pi_filename);
-    sound_pika_ = load_audio(sound_pika_filename);
-    sound_chu_ = load_audio(sound_chu_filename);
-    sound_pikachu_ = load_audio(sound_pikachu_filename);
-    sound_pipikachu_ = load_audio(sound_pipikachu_filename);
-    sound_ball_hit_ = load_audio(sound_ball_hit_filename);
-    sound_ball_ground_ = load_audio(sound_ball_ground_filename);
-    music_background_ = load_audio(music_background_filename);
-
     // Initialize tracks
     general_track_ = createTrack();
     pika_left_track_ = createTrack();
@@ -69,14 +95,49 @@ public:
     ball_track_ = createTrack();
     music_track_ = createTrack();
 
-    // Setup music track and volume
-    MIX_SetTrackAudio(music_track_, music_background_);
+    // Stream the music. Only the MP3 headers are read here
+    const Uint64 start_time = SDL_GetTicksNS();
+    if (!MIX_SetTrackIOStream(music_track_, load_resource(music_background_filename), true)) {
+      SDL_Log("Unable to load music! Filename: %s - SDL_mixer error: %s\n", music_background_filename, SDL_GetError());
+      throw std::runtime_error("Failed to open audio file");
+    }
+    SDL_Log("Opened %s for streaming in %.2f ms", music_background_filename,
+            static_cast<double>(SDL_GetTicksNS() - start_time) / 1e6);
     MIX_SetTrackGain(music_track_, 0.8);
 
     // TODO: Manage track left/right panning
+
+    // Load sounds
+    const std::array<std::pair<MIX_Audio**, const char*>, 7> clips {{
+      {&sound_pi_, sound_pi_filename},
+      {&sound_pika_, sound_pika_filename},
+      {&sound_chu_, sound_chu_filename},
+      {&sound_pikachu_, sound_pikachu_filename},
+      {&sound_pipikachu_, sound_pipikachu_filename},
+      {&sound_ball_hit_, sound_ball_hit_filename},
+      {&sound_ball_ground_, sound_ball_ground_filename},
+    }};
+    for (const auto& [clip, filename] : clips) {
+      if (loader == nullptr) {
+        *clip = load_audio(filename);
+      }
+      else {
+        pending_loads_.push_back(loader->submit([this, clip, filename] { *clip = load_audio(filename); }));
+      }
+    }
+    if (loader == nullptr) {
+      wait_until_loaded();
+    }
   }
 
-  ~PikaSound() {
+  ~PikaSound() override {
+    // The clips decoded in the background must be finished before destroying them
+    for (auto& pending : pending_loads_) {
+      if (pending.valid()) {
+        pending.wait();
+      }
+    }
+
     // Free audio chunks
     MIX_DestroyAudio(sound_pi_);
     MIX_DestroyAudio(sound_pika_);
@@ -89,7 +150,38 @@ public:
     // Close audio mixer and audio device
     MIX_DestroyMixer(mixer_);
     MIX_Quit();
-    SDL_CloseAudioDevice(audio_dev_id_);
+    if (audio_dev_id_ != 0) {
+      SDL_CloseAudioDevice(audio_dev_id_);
+    }
+  }
+
+  /**
+   * Wait until all the clips are decoded.
+   * Errors of the background decoding are rethrown here.
+   */
+  void wait_until_loaded() {
+    if (loaded_) {
+      return;
+    }
+    for (auto& pending : pending_loads_) {
+      pending.get();
+    }
+    pending_loads_.clear();
+    loaded_ = true;
+  }
+
+  /** Format of the mixed audio: interleaved stereo float samples at 44.1 kHz */
+  [[nodiscard]] static constexpr const SDL_AudioSpec& audio_spec() { return audio_spec_; }
+
+  /**
+   * Mix the next audio frames of the playing sounds (only with Output::Offline).
+   * Sounds started before this call begin at the first generated frame.
+   * @param samples Buffer for the interleaved samples (audio_spec().channels per audio frame)
+   * @return True if the whole buffer was generated
+   */
+  bool generate(const std::span<float> samples) const {
+    const auto bytes = static_cast<int>(samples.size_bytes());
+    return MIX_Generate(mixer_, samples.data(), bytes) == bytes;
   }
 
   /** Play the "Pi" sound used in the main menu */
@@ -158,6 +250,38 @@ public:
     MIX_PlayTrack(ball_track_, {});
   }
 
+  /**
+   * Play the sound associated to a physics event
+   * @param event The event emitted by the physics engine
+   */
+  void on_physics_event(const PhysicsEvent& event) override {
+    PIKA_TRACE_ZONE("PikaSound::on_physics_event");
+    PIKA_ALLOC_SCOPE(Sound);
+    switch (event.type) {
+    case PhysicsEventType::Jump:
+    case PhysicsEventType::Dive:
+      chu(event.side);
+      break;
+    case PhysicsEventType::PowerHit:
+      pika(event.side);
+      break;
+    case PhysicsEventType::Win:
+      pipikachu();
+      break;
+    case PhysicsEventType::BallHit:
+      // Only the power hits make a sound
+      if (event.power_hit) {
+        ball_hit();
+      }
+      break;
+    case PhysicsEventType::BallGround:
+      ball_ground();
+      break;
+    default:
+      break;
+    }
+  }
+
   void start_music() const {
     const SDL_PropertiesID play_properties = SDL_CreateProperties();
     SDL_SetNumberProperty(play_properties, MIX_PROP_PLAY_LOOPS_NUMBER, -1);
@@ -198,19 +322,25 @@ private:
   MIX_Audio* sound_pipikachu_ {nullptr};
   MIX_Audio* sound_ball_hit_ {nullptr};
   MIX_Audio* sound_ball_ground_ {nullptr};
-  MIX_Audio* music_background_ {nullptr};
 
+  // Clips decoded in the background
+  std::vector<std::future<void>> pending_loads_;
+  bool loaded_ {false};
+
+  /** Load and fully decode a clip. Can be called from any thread */
   [[nodiscard]] MIX_Audio* load_audio(const char* filename) const {
+    const Uint64 start_time = SDL_GetTicksNS();
     MIX_Audio* chunk = MIX_LoadAudio_IO(
       mixer_,
       load_resource(filename),
-      true,
-      true
+      true,  // Decode the whole clip now
+      true   // Close the stream
     );
     if (chunk == nullptr) {
       SDL_Log("Unable to load sound! Filename: %s - SDL_mixer error: %s\n", filename, SDL_GetError());
       throw std::runtime_error("Failed to open audio file");
     }
+    log_load_time(filename, start_time);
     return chunk;
   }
 
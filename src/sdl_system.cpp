@@ -1,5 +1,11 @@
 #include "sdl_system.hpp"
 #include "pikaball/resources.hpp"
+#include "pikaball/trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
 
 namespace pika {
 
@@ -10,7 +16,8 @@ SDLSystem::SDLSystem() :
   window_(nullptr, SDL_DestroyWindow),
   renderer_(nullptr, SDL_DestroyRenderer),
   sound_(nullptr),
-  text_font_(nullptr, TTF_CloseFont)
+  text_renderer_(nullptr),
+  start_time_(SDL_GetTicksNS())
 {
   if (!SDL_Init(sdl_init_flags)) {
     throw std::runtime_error("Failed to init SDL");
@@ -19,6 +26,60 @@ SDLSystem::SDLSystem() :
     throw std::runtime_error("Failed to init SDL_ttf");
   }
 
+  // Decode the assets in the background while the window is created.
+  // The sprite sheet is the first task, since the first frame cannot be rendered without it
+  std::future<SDL_Surface*> sprites_loading = loader_.submit([] {
+    const Uint64 start_time = SDL_GetTicksNS();
+    // Raw pixels baked at build time, ready for upload
+    SDL_IOStream* baked_sprites = find_resource(baked_sprite_sheet_filename);
+    baked::SDL_Surface_ptr baked_surface = baked::read_image(baked_sprites);
+    if (baked_sprites != nullptr) {
+      SDL_CloseIO(baked_sprites);
+    }
+    if (baked_surface) {
+      log_load_time(baked_sprite_sheet_filename, start_time);
+      return baked_surface.release();
+    }
+    // Fall back to decoding the PNG
+    SDL_Surface* sprites_surface = SDL_LoadPNG_IO(load_resource(sprite_sheet_filename), true);
+    if (sprites_surface == nullptr) {
+      SDL_Log( "Unable to load image %s! SDL Error: %s\n", sprite_sheet_filename, SDL_GetError());
+      throw std::runtime_error("Failed to load sprite sheet!");
+    }
+    log_load_time(sprite_sheet_filename, start_time);
+    return sprites_surface;
+  });
+  font_loading_ = loader_.submit([] {
+    const Uint64 start_time = SDL_GetTicksNS();
+    // Glyph atlas baked at build time
+    SDL_IOStream* baked_font = find_resource(baked_font_filename);
+    std::optional<baked::Font> font_atlas = baked::read_font(baked_font);
+    if (baked_font != nullptr) {
+      SDL_CloseIO(baked_font);
+    }
+    if (font_atlas) {
+      log_load_time(baked_font_filename, start_time);
+      return std::make_unique<view::TextRenderer>(std::move(*font_atlas));
+    }
+    // Fall back to rasterizing the TTF font
+    TTF_Font* font = TTF_OpenFontIO(load_resource(text_font_filename), true, text_font_size);
+    if (font == nullptr) {
+      SDL_Log( "Could not load TTF font! SDL_ttf error: %s\n", SDL_GetError());
+      throw std::runtime_error("Could not load TTF font");
+    }
+    log_load_time(text_font_filename, start_time);
+    return std::make_unique<view::TextRenderer>(font);
+  });
+  // The sound system is created here and only its clips are decoded by the loader, each one in
+  // its own task: a task of the pool must never wait for other tasks of the same pool
+  try {
+    sound_ = std::make_unique<PikaSound>(PikaSound::Output::Device, &loader_);
+  }
+  catch (const std::runtime_error&) {
+    // The error is logged by PikaSound. The game can be played without sounds
+    SDL_Log("The game runs without sound");
+  }
+
   SDL_Window* temp_window;
   SDL_Renderer* temp_renderer;
   if (!SDL_CreateWindowAndRenderer(
@@ -33,34 +94,32 @@ SDLSystem::SDLSystem() :
   }
   window_.reset(temp_window);
   renderer_.reset(temp_renderer);
+  resources_ = std::make_unique<view::RenderResources>(renderer_.get());
 
-  // Set a fixed logical size, so rendering can use fixed pixel coordinates
-  if (!SDL_SetRenderLogicalPresentation(
-    renderer_.get(),
-    screen_width,
-    screen_height,
-    SDL_LOGICAL_PRESENTATION_STRETCH
-  )) {
-    SDL_Log("Unable to set a fixed logical scale for the renderer! SDL Error: %s\n", SDL_GetError());
-    // TODO: Throw?? We actually need this for the physics engine
-  }
-
-  // Initialize sound subsystem
-  sound_ = std::make_unique<PikaSound>();
-
-  // Load the TTF font
-  text_font_.reset(TTF_OpenFontIO(load_resource(text_font_filename), true, text_font_size));
-  if(!text_font_)
-  {
-    SDL_Log( "Could not load TTF font! SDL_ttf error: %s\n", SDL_GetError());
-    throw std::runtime_error("Could not load TTF font");
-  }
+  // Render everything at the native resolution, so rendering can use fixed pixel coordinates
+  create_frame_target();
 
   // Load sprites and build the static background
-  load_sprite_sheet();
+  load_sprite_sheet(std::move(sprites_loading));
+  SDL_Log("Assets of the first frame ready in %.2f ms (%zu loader threads)",
+          static_cast<double>(SDL_GetTicksNS() - start_time_) / 1e6, loader_.size());
 }
 
 SDLSystem::~SDLSystem() {
+  // Background assets must be loaded before they can be released
+  try {
+    finish_loading();
+  }
+  catch (const std::exception& e) {
+    SDL_Log("Error loading the assets: %s", e.what());
+  }
+
+  // Textures must be destroyed before their renderer
+  frame_target_.reset();
+  sprite_sheet_.reset();
+  text_renderer_.reset();
+  resources_.reset();
+
   // Force free the window resources before calling SDL_Quit
   if (renderer_) {
       renderer_.reset();
@@ -69,10 +128,6 @@ SDLSystem::~SDLSystem() {
       window_.reset();
   }
 
-  if (text_font_) {
-    text_font_.reset();
-  }
-
   // Force Sound System to free resources before calling SDL_Quit
   if (sound_) {
       sound_.reset();
@@ -81,16 +136,33 @@ SDLSystem::~SDLSystem() {
   SDL_Quit();
 }
 
-void SDLSystem::load_sprite_sheet() {
-  // Load PNG from embedded data or from files. Throw if error.
-  // SDL_Surface* sprites_surface = SDL_LoadPNG_IO(load_resource(sprite_sheet_filename), true);
-  SDL_Surface* sprites_surface =
-    SDL_LoadPNG_IO(load_resource(sprite_sheet_filename), true);
+PikaSound* SDLSystem::get_sound() {
+  if (sound_ && !sound_loaded_) {
+    const Uint64 start_time = SDL_GetTicksNS();
+    try {
+      sound_->wait_until_loaded();
+      sound_loaded_ = true;
+      SDL_Log("Waited %.2f ms for the sounds", static_cast<double>(SDL_GetTicksNS() - start_time) / 1e6);
+    }
+    catch (const std::exception& e) {
+      // The game can be played without sounds
+      SDL_Log("Error loading the sounds, the game runs without sound: %s", e.what());
+      sound_.reset();
+    }
+  }
+  return sound_.get();
+}
 
-  if (sprites_surface == nullptr) {
-    SDL_Log( "Unable to load image %s! SDL Error: %s\n", sprite_sheet_filename, SDL_GetError());
-    throw std::runtime_error("Failed to load sprite sheet!");
+const view::TextRenderer* SDLSystem::get_text_renderer() {
+  if (font_loading_.valid()) {
+    text_renderer_ = font_loading_.get();
   }
+  return text_renderer_.get();
+}
+
+void SDLSystem::load_sprite_sheet(std::future<SDL_Surface*> sprites_loading) {
+  // PNG decoded from embedded data or from files. Throws if error.
+  SDL_Surface* sprites_surface = sprites_loading.get();
   // Generate the texture and save it
   sprite_sheet_.reset(SDL_CreateTextureFromSurface(renderer_.get(), sprites_surface));
   SDL_SetTextureScaleMode(sprite_sheet_.get(), SDL_SCALEMODE_NEAREST);
@@ -98,4 +170,81 @@ void SDLSystem::load_sprite_sheet() {
   SDL_DestroySurface(sprites_surface);
 }
 
+void SDLSystem::create_frame_target() {
+  frame_target_.reset(SDL_CreateTexture(
+    renderer_.get(),
+    SDL_PIXELFORMAT_ARGB8888,
+    SDL_TEXTUREACCESS_TARGET,
+    screen_width,
+    screen_height
+  ));
+  if (frame_target_) {
+    // The upscale blit must keep the pixels sharp and ignore the alpha channel
+    SDL_SetTextureScaleMode(frame_target_.get(), SDL_SCALEMODE_NEAREST);
+    SDL_SetTextureBlendMode(frame_target_.get(), SDL_BLENDMODE_NONE);
+    SDL_SetRenderTarget(renderer_.get(), frame_target_.get());
+    return;
+  }
+
+  SDL_Log("Unable to create the frame target texture! SDL Error: %s\n", SDL_GetError());
+  // Set a fixed logical size, so rendering can use fixed pixel coordinates
+  if (!SDL_SetRenderLogicalPresentation(
+    renderer_.get(),
+    screen_width,
+    screen_height,
+    SDL_LOGICAL_PRESENTATION_STRETCH
+  )) {
+    SDL_Log("Unable to set a fixed logical scale for the renderer! SDL Error: %s\n", SDL_GetError());
+    // TODO: Throw?? We actually need this for the physics engine
+  }
+}
+
+void SDLSystem::present() {
+  SDL_Renderer* renderer = renderer_.get();
+  if (!first_frame_presented_) {
+    first_frame_presented_ = true;
+    SDL_Log("Time to first frame: %.2f ms", static_cast<double>(SDL_GetTicksNS() - start_time_) / 1e6);
+  }
+  if (!frame_target_) {
+    // Views rendered directly to the window (logical presentation)
+    PIKA_TRACE_ZONE("SDL_RenderPresent");
+    SDL_RenderPresent(renderer);
+    return;
+  }
+
+  SDL_SetRenderTarget(renderer, nullptr);
+  int output_w = 0;
+  int output_h = 0;
+  SDL_GetCurrentRenderOutputSize(renderer, &output_w, &output_h);
+
+  SDL_FRect dst {
+    .x = 0,
+    .y = 0,
+    .w = static_cast<float>(output_w),
+    .h = static_cast<float>(output_h),
+  };
+  if (letterbox_) {
+    // Largest integer scale that fits in the window.
+    // Windows smaller than the native resolution are scaled down keeping the aspect ratio.
+    const int scale = std::min(output_w / screen_width, output_h / screen_height);
+    const float fit_scale = (scale >= 1) ? static_cast<float>(scale) : std::min(
+      static_cast<float>(output_w) / screen_width, static_cast<float>(output_h) / screen_height);
+    dst.w = fit_scale * screen_width;
+    dst.h = fit_scale * screen_height;
+    dst.x = std::floor((static_cast<float>(output_w) - dst.w) / 2);
+    dst.y = std::floor((static_cast<float>(output_h) - dst.h) / 2);
+
+    SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+    SDL_RenderClear(renderer);
+  }
+  SDL_RenderTexture(renderer, frame_target_.get(), nullptr, &dst);
+  {
+    PIKA_TRACE_ZONE("SDL_RenderPresent");
+    SDL_RenderPresent(renderer);
+  }
+
+  // Views render the next frame to the native resolution texture again
+  SDL_SetRenderTarget(renderer, frame_target_.get());
+}
+
 } // namespace pika
@@ -1,10 +1,14 @@
 #ifndef PIKA_WINDOW_HPP
 #define PIKA_WINDOW_HPP
 
+#include <future>
 #include <memory>
 #include "SDL3/SDL.h"
 #include "SDL3_ttf/SDL_ttf.h"
 #include "pika_sound.hpp"
+#include "view/render_resources.hpp"
+#include "view/text_renderer.hpp"
+#include <pikaball/worker_pool.hpp>
 
 namespace pika {
 
@@ -12,13 +16,18 @@ namespace pika {
  * A class to handle SDL resources (Window, Renderer, Audio, etc.)
  * Owns and manages the SDL objects.
  * It is responsible for calling SDL_Init and SDL_Quit.
+ *
+ * Only the sprite sheet (all the IntroView needs) is ready when the constructor returns.
+ * The sprite sheet and the font atlas are loaded from the pre-baked assets when available
+ * (no decoding), or decoded from the PNG and TTF files otherwise.
+ * The font and the sounds are loaded in the background by a worker pool, and the first
+ * call to get_text_renderer() or get_sound() waits until they are loaded.
  */
 class SDLSystem {
 public:
   using SDL_Window_ptr = std::unique_ptr<SDL_Window, decltype(&SDL_DestroyWindow)>;
   using SDL_Renderer_ptr = std::unique_ptr<SDL_Renderer, decltype(&SDL_DestroyRenderer)>;
   using SDL_Texture_ptr = std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)>;
-  using TTF_Font_ptr = std::unique_ptr<TTF_Font, decltype(&TTF_CloseFont)>;
 
   SDLSystem();
   ~SDLSystem();
@@ -32,32 +41,88 @@ public:
    */
   [[nodiscard]] SDL_Renderer* get_renderer() const { return renderer_.get(); }
 
-  /** Get a non-owning pointer to the sound system
-   * @return a non-owning pointer to the sound system to play sounds
+  /** Get a non-owning pointer to the sound system. Waits until all the sounds are loaded
+   * @return a non-owning pointer to the sound system to play sounds, or nullptr if the sounds
+   *         could not be loaded (the error is logged and the game runs without sound)
    */
-  [[nodiscard]] PikaSound* get_sound() const { return sound_.get(); }
+  [[nodiscard]] PikaSound* get_sound();
 
-  /** Get a non-owning pointer to the TTF font for rendering text
-   * @return a non-owning pointer to the TTF text font
+  /** Get a non-owning pointer to the text renderer. Waits until the font is loaded
+   * @return a non-owning pointer to the text renderer
    */
-  [[nodiscard]] TTF_Font* get_font() const { return text_font_.get(); }
+  [[nodiscard]] const view::TextRenderer* get_text_renderer();
 
   /** Get a non-owning pointer to the sprite sheet texture
    * @return a non-owning pointer to the SDL texture with the sprite sheet
    */
   [[nodiscard]] SDL_Texture* get_sprite_sheet() const { return sprite_sheet_.get(); }
 
+  /** Get a non-owning pointer to the native resolution texture the views render to
+   * @return a non-owning pointer to the frame target, or nullptr if rendering directly to the window
+   */
+  [[nodiscard]] SDL_Texture* get_frame_target() const { return frame_target_.get(); }
+
+  /** Get a non-owning pointer to the textures shared by the views
+   * @return a non-owning pointer to the render resources of the renderer
+   */
+  [[nodiscard]] view::RenderResources* get_render_resources() const { return resources_.get(); }
+
+  /**
+   * Present the current frame in the window.
+   * The views render to a texture with the native resolution of the game, which is
+   * upscaled to the window with a single nearest-neighbour blit.
+   * The frame target is set again as the render target for the next frame.
+   */
+  void present();
+
+  /**
+   * Toggle between an integer upscale with black bars (default, pixel-perfect)
+   * and a non-integer stretch that fills the whole window
+   */
+  void toggle_letterbox() { letterbox_ = !letterbox_; }
+
+  /** Wait until all the background assets are loaded */
+  void finish_loading() {
+    static_cast<void>(get_text_renderer());
+    static_cast<void>(get_sound());
+  }
+
 private:
   SDL_Window_ptr window_;
   SDL_Renderer_ptr renderer_;
   std::unique_ptr<PikaSound> sound_;
-  TTF_Font_ptr text_font_;
+  // The clips of sound_ are decoded in the background until get_sound() waits for them
+  bool sound_loaded_ {false};
+  std::unique_ptr<view::TextRenderer> text_renderer_;
+  std::unique_ptr<view::RenderResources> resources_;
 
   // Objects
   SDL_Texture_ptr sprite_sheet_ {nullptr, SDL_DestroyTexture};
+  // Render target with the native resolution of the game (screen_width x screen_height)
+  SDL_Texture_ptr frame_target_ {nullptr, SDL_DestroyTexture};
+  // Scale the frame by an integer factor and fill the rest of the window with black bars
+  bool letterbox_ {true};
+
+  // Startup metrics
+  Uint64 start_time_ {0};
+  bool first_frame_presented_ {false};
 
-  /** Load a new sprite sheet from disk and create a texture */
-  void load_sprite_sheet();
+  // Assets decoded in the background. Declared last, so the workers finish
+  // their tasks before the other members are destroyed
+  WorkerPool loader_;
+  std::future<std::unique_ptr<view::TextRenderer>> font_loading_;
+
+  /**
+   * Create a texture from the sprite sheet decoded in the background
+   * @param sprites_loading The decoding task of the sprite sheet surface
+   */
+  void load_sprite_sheet(std::future<SDL_Surface*> sprites_loading);
+  /**
+   * Create the native resolution render target.
+   * If it cannot be created, the renderer falls back to the logical presentation of SDL
+   * (every draw is scaled to the window resolution).
+   */
+  void create_frame_target();
 };
 
 } // namespace pika
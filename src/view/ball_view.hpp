@@ -17,8 +17,34 @@ public:
   /**
    * Draw the ball and the punch effect
    * @param ball The Ball object from the game Physics
+   * @param trail Draw the trail of power hits
+   * @param punch Draw the punch effect
    */
-  void draw_ball(const Ball& ball) const {
+  void draw_ball(const Ball& ball, const bool trail = true, const bool punch = true) const {
+    for_each_sprite(ball, [this](const SDL_FRect& src, const SDL_FRect& dst) {
+      SDL_RenderTexture(renderer_, sprite_sheet_, &src, &dst);
+    }, trail, punch);
+  }
+
+  /**
+   * Draw the shadow of the ball
+   * @param ball The Ball object from the game Physics
+   */
+  void draw_shadow(const Ball& ball) const {
+    const SDL_FRect dst = shadow_dst(ball);
+    SDL_RenderTexture(renderer_, sprite_sheet_, &sprite::objects_shadow, &dst);
+  }
+
+  /**
+   * Call a draw function for every sprite of the ball (ball, punch effect and trail),
+   * in drawing order. Shared by all the renderers.
+   * @param ball The Ball object from the game Physics
+   * @param draw Function called with the source sprite and the destination rects
+   * @param trail Include the trail of power hits
+   * @param punch Include the punch effect
+   */
+  template <typename DrawFunction>
+  static void for_each_sprite(const Ball& ball, DrawFunction&& draw, const bool trail = true, const bool punch = true) {
     constexpr int ball_width = static_cast<int>(sprite::ball_hyper.w);
     constexpr int ball_height = static_cast<int>(sprite::ball_hyper.h);
     const int x = ball.x() - ball_width / 2;
@@ -37,10 +63,10 @@ public:
       .w = sprite::ball_hyper.w,
       .h = sprite::ball_hyper.h,
     };
-    SDL_RenderTexture(renderer_, sprite_sheet_, &src_rect, &ball_dst);
+    draw(src_rect, ball_dst);
 
     // For punch effect, refer to FUN_00402ee0
-    if (ball.punch_effect_radius() > 0) {
+    if (punch && ball.punch_effect_radius() > 0) {
       const int punch_h_size = ball.punch_effect_radius();
       const int px = ball.punch_effect_x() - punch_h_size;
       const int py = ball.punch_effect_y() - punch_h_size;
@@ -50,9 +76,9 @@ public:
         .w = static_cast<float>(2 * punch_h_size),
         .h = static_cast<float>(2 * punch_h_size),
       };
-      SDL_RenderTexture(renderer_, sprite_sheet_, &sprite::ball_punch, &punch_dst);
+      draw(sprite::ball_punch, punch_dst);
     }
-    if (ball.power_hit()) {
+    if (trail && ball.power_hit()) {
       // The ball was hit hard. Draw a trailing effect (ball_hyper and ball_trail)
       for (size_t i = 0; i < 2; i++) {
         const SDL_FRect hyper_dst {
@@ -61,24 +87,22 @@ public:
           .w = ball_width,
           .h = ball_height,
         };
-        const auto ball_sprite = sprite::ball_trail_animation[i];  // Hyper or trail
-        SDL_RenderTexture(renderer_, sprite_sheet_, &ball_sprite, &hyper_dst);
+        draw(sprite::ball_trail_animation[i], hyper_dst);  // Hyper or trail
       }
     }
   }
 
   /**
-   * Draw the shadow of the ball
+   * Get the position of the ball shadow
    * @param ball The Ball object from the game Physics
    */
-  void draw_shadow(const Ball& ball) const {
-    const SDL_FRect shadow_dst {
+  [[nodiscard]] static SDL_FRect shadow_dst(const Ball& ball) {
+    return {
       .x = static_cast<float>(ball.x()) - sprite::objects_shadow.w / 2,
       .y = 273 - sprite::objects_shadow.h / 2,
       .w = sprite::objects_shadow.w,
       .h = sprite::objects_shadow.h,
     };
-    SDL_RenderTexture(renderer_, sprite_sheet_, &sprite::objects_shadow, &shadow_dst);
   }
 
 private:
@@ -1,10 +1,13 @@
 #ifndef PIKA_FPS_VIEW_HPP
 #define PIKA_FPS_VIEW_HPP
 
-#include <format>
+#include <array>
+#include <charconv>
+#include <string_view>
 
-#include "SDL3_ttf/SDL_ttf.h"
 #include "pikaball/common.hpp"
+#include "render_resources.hpp"
+#include "text_renderer.hpp"
 #include "view.hpp"
 
 namespace pika::view {
@@ -43,9 +46,15 @@ public:
   FPSView &operator=(FPSView const&) = delete;
   FPSView &operator=(FPSView &&) = delete;
 
-  explicit FPSView(SDL_Renderer* renderer, SDL_Texture* sprite_sheet, TTF_Font* text_font) :
+  explicit FPSView(
+    SDL_Renderer* renderer,
+    SDL_Texture* sprite_sheet,
+    RenderResources* resources,
+    const TextRenderer* text_renderer
+  ) :
     View(renderer, sprite_sheet),
-    text_font_(text_font)
+    resources_(resources),
+    text_renderer_(text_renderer)
   {
     preload_textures();
   }
@@ -53,78 +62,69 @@ public:
 
   /** Render the FPS text */
   void render(const float fps) const {
+    PIKA_TRACE_ZONE("FPSView::render");
     if (renderer_ == nullptr || sprite_sheet_ == nullptr) {
       return;
     }
 
     // Render background with 50% opacity
-    SDL_SetTextureAlphaModFloat(background_texture_.get(), 0.50);
-    SDL_RenderTexture(renderer_, background_texture_.get(), nullptr, &background_dst);
-
-    // Render FPS value
-    const std::string fps_str = std::format("{:.1f}", fps);
-    const auto fps_texture = FPSView::load_text_texture(renderer_, text_font_, fps_str);
-    SDL_RenderTexture(renderer_, fps_texture.get(), nullptr, &fps_dst);
+    render_black_rect(&background_dst, 0.50f);
+
+    // Render FPS value with the preloaded characters (the text is stretched to fit fps_dst).
+    // No text textures are created, so it does not allocate
+    std::array<char, 16> fps_str {};
+    const auto [end, error] = std::to_chars(
+      fps_str.data(), fps_str.data() + fps_str.size(), fps, std::chars_format::fixed, 1);
+    if (error != std::errc {}) {
+      return;
+    }
+    float text_width = 0;
+    for (const char* c = fps_str.data(); c != end; c++) {
+      if (const std::size_t index = fps_chars.find(*c); index != std::string_view::npos) {
+        text_width += char_widths_[index];
+      }
+    }
+    const float scale_x = (text_width > 0) ? fps_dst.w / text_width : 1.0f;
+    SDL_FRect dst = fps_dst;
+    for (const char* c = fps_str.data(); c != end; c++) {
+      const std::size_t index = fps_chars.find(*c);
+      if (index == std::string_view::npos) {
+        continue;
+      }
+      dst.w = char_widths_[index] * scale_x;
+      SDL_RenderTexture(renderer_, char_textures_[index].get(), nullptr, &dst);
+      dst.x += dst.w;
+    }
 
     // Render the FPS letters
     SDL_RenderTexture(renderer_, fps_txt_texture_.get(), nullptr, &fps_txt_dst);
   }
 
 private:
-  // Background black cover
-  SDL_Texture_ptr background_texture_ {nullptr, SDL_DestroyTexture};
-  SDL_Texture_ptr fps_txt_texture_ {nullptr, SDL_DestroyTexture};
-  // Pointer to text font
-  TTF_Font* text_font_ {nullptr};
+  // Characters of the FPS values
+  constexpr static std::string_view fps_chars {"0123456789."};
+
+  // Owner of the textures
+  RenderResources* resources_ {nullptr};
+  // Renders the text textures
+  const TextRenderer* text_renderer_ {nullptr};
+  RenderResources::Texture fps_txt_texture_;
+  // Texture and width of each character of fps_chars
+  std::array<RenderResources::Texture, fps_chars.size()> char_textures_ {};
+  std::array<float, fps_chars.size()> char_widths_ {};
 
   void preload_textures() {
     if (renderer_ == nullptr) {
       return;
     }
 
-    // Create a small black surface for the menu background
-    background_texture_.reset(SDL_CreateTexture(
-      renderer_,
-      SDL_PIXELFORMAT_ARGB8888,
-      SDL_TEXTUREACCESS_TARGET,
-      background_dst.w,
-      background_dst.h
-    ));
-    // Set the texture scaling mode to nearest interpolation
-    SDL_SetTextureScaleMode(background_texture_.get(), SDL_SCALEMODE_NEAREST);
-    // Clear the black texture with a black background
-    SDL_SetRenderTarget(renderer_, background_texture_.get());
-    SDL_SetRenderDrawColor(renderer_, 0x00, 0x00, 0x00, 0xFF);
-    SDL_RenderClear(renderer_);
-
-    // Set the render target back to the main window
-    SDL_SetRenderTarget(renderer_, nullptr);
-
-    // Load text textures
-    fps_txt_texture_ = FPSView::load_text_texture(renderer_, text_font_, "FPS");
-    // title_texture_ = load_text_texture(renderer_, text_font_, txt::str_options);
-  }
-
-
-  [[nodiscard]] static SDL_Texture_ptr load_text_texture(
-    SDL_Renderer* renderer,
-    TTF_Font* text_font,
-    const std::string & text,
-    const SDL_Color & text_color = {255, 255, 255})
-  {
-    // Load the text into a temporary surface
-    SDL_Surface* text_surface = TTF_RenderText_Solid(text_font, text.c_str(), 0, text_color);
-    if (text_surface == nullptr) {
-      SDL_Log("Unable to load text! SDL Error: %s\n", SDL_GetError());
-      throw std::runtime_error("Failed to load text!");
+    // Load text textures (the background is a filled rect)
+    fps_txt_texture_ = resources_->text(*text_renderer_, "FPS");
+    for (std::size_t i = 0; i < fps_chars.size(); i++) {
+      char_textures_[i] = resources_->text(*text_renderer_, std::string(1, fps_chars[i]));
+      SDL_GetTextureSize(char_textures_[i].get(), &char_widths_[i], nullptr);
     }
-    // Generate the texture and save it
-    View::SDL_Texture_ptr text_texture {nullptr, SDL_DestroyTexture};
-    text_texture.reset(SDL_CreateTextureFromSurface(renderer, text_surface));
-    // Release the temporary surface object
-    SDL_DestroySurface(text_surface);
-
-    return text_texture;
+    // title_texture_ = load_text_texture(renderer_, text_font_, txt::str_options);
   }
 
 };
@@ -40,8 +40,17 @@ public:
     View(renderer, sprite_sheet)
   {}
 
+  /**
+   * Check if a frame of the intro is the same as the previous one
+   * (the messages are fully visible between the fade effects)
+   */
+  [[nodiscard]] constexpr static bool is_static_frame(const unsigned int frame_counter) {
+    return frame_counter > 25 && frame_counter <= 100;
+  }
+
   /** Render the intro messages and the fade in/out effects */
   void render(const unsigned int frame_counter) {
+    PIKA_TRACE_ZONE("IntroView::render");
     if (renderer_ == nullptr || sprite_sheet_ == nullptr) {
       return;
     }
@@ -1,6 +1,7 @@
 #ifndef PIKA_MENU_VIEW_HPP
 #define PIKA_MENU_VIEW_HPP
 
+#include "render_resources.hpp"
 #include "view.hpp"
 #include <pikaball/sprites.hpp>
 
@@ -19,8 +20,9 @@ public:
   MenuView &operator=(MenuView const&) = delete;
   MenuView &operator=(MenuView &&) = delete;
 
-  explicit MenuView(SDL_Renderer* renderer, SDL_Texture* sprite_sheet) :
-    View(renderer, sprite_sheet)
+  explicit MenuView(SDL_Renderer* renderer, SDL_Texture* sprite_sheet, RenderResources* resources) :
+    View(renderer, sprite_sheet),
+    resources_(resources)
   {}
 
   /**
@@ -46,6 +48,7 @@ public:
    * @param frame_counter The current frame counter (used for animations)
    */
   void render(const unsigned int frame_counter) {
+    PIKA_TRACE_ZONE("MenuView::render");
     if (renderer_ == nullptr || sprite_sheet_ == nullptr) {
       return;
     }
@@ -87,10 +90,12 @@ public:
 private:
   MenuState state_ {MenuState::Menu};
   MenuPlayerSelection selection_ {MenuPlayerSelection::SinglePlayer};
+  // Owner of the textures
+  RenderResources* resources_ {nullptr};
   // Background with the repeating sitting pikachus
-  SDL_Texture_ptr background_texture_{nullptr, SDL_DestroyTexture};
+  RenderResources::Texture background_texture_;
   // Copyright message. Needs its own texture to apply an independent alpha.
-  SDL_Texture_ptr copyright_texture_{nullptr, SDL_DestroyTexture};
+  RenderResources::Texture copyright_texture_;
   // Offset for the sitting pikachu background sprites
   int background_offset_ {0};
   float pika_background_alpha_ {0.0};
@@ -282,65 +287,45 @@ private:
     constexpr int num_cols = screen_width / sprite_width + 2;
     constexpr int num_rows = screen_height / sprite_height + 2;
 
-    // Create a target texture to render all the background elements to
-    background_texture_.reset(SDL_CreateTexture(
-      renderer_,
-      SDL_PIXELFORMAT_ARGB8888,
-      SDL_TEXTUREACCESS_TARGET,
-      num_cols * sprite_width,
-      num_rows * sprite_height
-    ));
-    // Set the texture scaling mode to nearest interpolation
-    SDL_SetTextureScaleMode(background_texture_.get(), SDL_SCALEMODE_NEAREST);
-
-    // Focus the renderer on the target texture
-    SDL_SetRenderTarget(renderer_, background_texture_.get());
-
-    // Fill the background green
-    SDL_SetRenderDrawColor(renderer_, 0x00, 0xFF, 0x00, 0xFF);
-    SDL_RenderClear(renderer_);
-
-    // Build the sitting pikachu green background
-    SDL_FRect f_dst;
-    SDL_Rect dst = {
-      // Preset width and height with pikachu sprite size
-      .w = sprite_width,
-      .h = sprite_height,
-    };
-    for (int i = 0; i < num_cols; i++) {
-      for (int j = 0; j < num_rows; j++) {
-        // Set position and render texture
-        dst.x = i * sprite_width;
-        dst.y = j * sprite_height;
-        SDL_RectToFRect(&dst, &f_dst);
-        SDL_RenderTexture(
-          renderer_, sprite_sheet_, &sprite::sitting_pikachu, &f_dst);
-      }
-    }
-
-    // Then, change the target to the copyright texture
-    copyright_texture_.reset(SDL_CreateTexture(
-      renderer_,
-      SDL_PIXELFORMAT_ARGB8888,
-      SDL_TEXTUREACCESS_TARGET,
-      sprite::msg_copyright.w,
-      2 * sprite::msg_copyright.h
-    ));
-    // Set the texture scaling mode to nearest interpolation
-    SDL_SetTextureScaleMode(copyright_texture_.get(), SDL_SCALEMODE_NEAREST);
-
-    // Copy the texture from the sheet
-    SDL_SetRenderTarget(renderer_, copyright_texture_.get());
-    f_dst.x = 0;
-    f_dst.y = 0;
-    f_dst.w = sprite::msg_copyright.w;
-    f_dst.h = sprite::msg_copyright.h;
-    SDL_RenderTexture(renderer_, sprite_sheet_, &sprite::msg_copyright, &f_dst);
-    f_dst.y = sprite::msg_copyright.h - 4;
-    SDL_RenderTexture(renderer_, sprite_sheet_, &sprite::msg_copyright_extra, &f_dst);
-
-    // Set the render target back to the main window
-    SDL_SetRenderTarget(renderer_, nullptr);
+    // Render all the background elements to a target texture
+    background_texture_ = resources_->target("menu_background", num_cols * sprite_width, num_rows * sprite_height,
+      [this](SDL_Texture*) {
+        // Fill the background green
+        SDL_SetRenderDrawColor(renderer_, 0x00, 0xFF, 0x00, 0xFF);
+        SDL_RenderClear(renderer_);
+
+        // Build the sitting pikachu green background
+        SDL_FRect f_dst;
+        SDL_Rect dst = {
+          // Preset width and height with pikachu sprite size
+          .w = sprite_width,
+          .h = sprite_height,
+        };
+        for (int i = 0; i < num_cols; i++) {
+          for (int j = 0; j < num_rows; j++) {
+            // Set position and render texture
+            dst.x = i * sprite_width;
+            dst.y = j * sprite_height;
+            SDL_RectToFRect(&dst, &f_dst);
+            SDL_RenderTexture(
+              renderer_, sprite_sheet_, &sprite::sitting_pikachu, &f_dst);
+          }
+        }
+      });
+
+    // Then, copy the copyright messages from the sheet to their own texture
+    copyright_texture_ = resources_->target("menu_copyright", sprite::msg_copyright.w, 2 * sprite::msg_copyright.h,
+      [this](SDL_Texture*) {
+        SDL_FRect f_dst {
+          .x = 0,
+          .y = 0,
+          .w = sprite::msg_copyright.w,
+          .h = sprite::msg_copyright.h,
+        };
+        SDL_RenderTexture(renderer_, sprite_sheet_, &sprite::msg_copyright, &f_dst);
+        f_dst.y = sprite::msg_copyright.h - 4;
+        SDL_RenderTexture(renderer_, sprite_sheet_, &sprite::msg_copyright_extra, &f_dst);
+      });
   }
 };
 
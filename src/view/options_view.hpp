@@ -3,34 +3,14 @@
 
 #include <algorithm>
 
-#include "SDL3_ttf/SDL_ttf.h"
 #include "pikaball/common.hpp"
 #include "pikaball/sprites.hpp"
+#include "render_resources.hpp"
+#include "text_renderer.hpp"
 #include "view.hpp"
 
 namespace pika::view {
 
-[[nodiscard]] inline View::SDL_Texture_ptr load_text_texture(
-  SDL_Renderer* renderer,
-  TTF_Font* text_font,
-  const std::string & text,
-  const SDL_Color & text_color = {255, 255, 255})
-{
-  // Load the text into a temporary surface
-  SDL_Surface* text_surface = TTF_RenderText_Solid(text_font, text.c_str(), 0, text_color);
-  if (text_surface == nullptr) {
-    SDL_Log("Unable to load text! SDL Error: %s\n", SDL_GetError());
-    throw std::runtime_error("Failed to load text!");
-  }
-  // Generate the texture and save it
-  View::SDL_Texture_ptr text_texture {nullptr, SDL_DestroyTexture};
-  text_texture.reset(SDL_CreateTextureFromSurface(renderer, text_surface));
-  // Release the temporary surface object
-  SDL_DestroySurface(text_surface);
-
-  return text_texture;
-}
-
 /**
  * An abstract class to represent an option item with multiple values.
  *
@@ -49,21 +29,24 @@ public:
   /**
    * Create a new OptionItem
    * @param renderer A non-owning pointer to the SDL renderer
-   * @param text_font The TTF font used to generate the text textures
+   * @param resources Owner of the text textures
+   * @param text_renderer Renders the text textures
    * @param name The name for this option
    * @param y_position The vertical position to render this option (topmost)
    */
   explicit OptionItem(
     SDL_Renderer* renderer,
-    TTF_Font* text_font,
+    RenderResources* resources,
+    const TextRenderer* text_renderer,
     const std::string &name,
     const int y_position
   )
   : renderer_(renderer),
-    text_font_(text_font),
+    resources_(resources),
+    text_renderer_(text_renderer),
     y_position_(y_position)
   {
-    name_texture_ = load_text_texture(renderer, text_font, name);
+    name_texture_ = resources_->text(*text_renderer_, name);
     // Initialize name render position
     constexpr int name_h = 20;
     const int name_w = name_texture_->w * name_h / 40;
@@ -110,11 +93,10 @@ public:
   }
 
 protected:
-  // Convenient type alias to hold owning textures
-  using SDL_Texture_ptr = std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)>;
   SDL_Renderer* renderer_;
-  TTF_Font* text_font_;
-  SDL_Texture_ptr name_texture_ {nullptr, SDL_DestroyTexture};
+  RenderResources* resources_;
+  const TextRenderer* text_renderer_;
+  RenderResources::Texture name_texture_;
   const int y_position_ = 0;
   SDL_FRect name_dst_ {};
   int selected_ = 0;
@@ -130,27 +112,29 @@ public:
 
   explicit OptionItemList(
     SDL_Renderer* renderer,
-    TTF_Font* text_font,
+    RenderResources* resources,
+    const TextRenderer* text_renderer,
     const std::string &name,
     const int y_position
   )
-  :  OptionItem(renderer, text_font, name, y_position)
+  :  OptionItem(renderer, resources, text_renderer, name, y_position)
   {}
 
   explicit OptionItemList(
     SDL_Renderer* renderer,
-    TTF_Font* text_font,
+    RenderResources* resources,
+    const TextRenderer* text_renderer,
     const std::string &name,
     const int y_position,
     const std::initializer_list<std::string> option_values
   )
-  : OptionItem(renderer, text_font, name, y_position),
+  : OptionItem(renderer, resources, text_renderer, name, y_position),
     opt_values_(option_values)
   {
     for (const auto& opt_value : opt_values_) {
-      opt_textures_.emplace_back(load_text_texture(renderer_, text_font_, opt_value));
+      opt_textures_.emplace_back(resources_->text(*text_renderer_, opt_value));
       opt_select_textures_.emplace_back(
-        load_text_texture(renderer_, text_font_, opt_value, {255, 0, 0})
+        resources_->text(*text_renderer_, opt_value, {255, 0, 0})
       );
     }
   }
@@ -161,9 +145,9 @@ public:
    */
   void add_option(const std::string & option_value) {
     opt_values_.emplace_back(option_value);
-    opt_textures_.emplace_back(load_text_texture(renderer_, text_font_, option_value));
+    opt_textures_.emplace_back(resources_->text(*text_renderer_, option_value));
     opt_select_textures_.emplace_back(
-      load_text_texture(renderer_, text_font_, option_value, {255, 0, 0}))
+      resources_->text(*text_renderer_, option_value, {255, 0, 0}))
     ;
   }
 
@@ -210,8 +194,8 @@ public:
 
 private:
   std::vector<std::string> opt_values_;
-  std::vector<SDL_Texture_ptr> opt_textures_;
-  std::vector<SDL_Texture_ptr> opt_select_textures_;
+  std::vector<RenderResources::Texture> opt_textures_;
+  std::vector<RenderResources::Texture> opt_select_textures_;
 };
 
 class OptionsView final : public View {
@@ -230,15 +214,21 @@ public:
   OptionsView &operator=(OptionsView const&) = delete;
   OptionsView &operator=(OptionsView &&) = delete;
 
-  explicit OptionsView(SDL_Renderer* renderer, SDL_Texture* sprite_sheet, TTF_Font* text_font) :
+  explicit OptionsView(
+    SDL_Renderer* renderer,
+    SDL_Texture* sprite_sheet,
+    RenderResources* resources,
+    const TextRenderer* text_renderer
+  ) :
     View(renderer, sprite_sheet),
-    text_font_(text_font)
+    resources_(resources),
+    text_renderer_(text_renderer)
   {
     preload_textures();
 
     // Create option items
     auto speed_options = std::make_unique<OptionItemList>(
-      renderer_, text_font_, txt::str_opt_speed, background_dst.y + 75
+      renderer_, resources_, text_renderer_, txt::str_opt_speed, background_dst.y + 75
     );
     speed_options->add_option(txt::str_slow);
     speed_options->add_option(txt::str_medium);
@@ -246,7 +236,7 @@ public:
     options_[OptionMenuSelection::Speed] = std::move(speed_options);
 
     auto points_options = std::make_unique<OptionItemList>(
-      renderer_, text_font_, txt::str_opt_points, background_dst.y + 140
+      renderer_, resources_, text_renderer_, txt::str_opt_points, background_dst.y + 140
     );
     points_options->add_option(txt::str_5_pts);
     points_options->add_option(txt::str_10_pts);
@@ -254,7 +244,7 @@ public:
     options_[OptionMenuSelection::Points] = std::move(points_options);
 
     auto music_options = std::make_unique<OptionItemList>(
-      renderer_, text_font_, txt::str_opt_music, background_dst.y + 205
+      renderer_, resources_, text_renderer_, txt::str_opt_music, background_dst.y + 205
     );
     music_options->add_option(txt::str_on);
     music_options->add_option(txt::str_off);
@@ -290,13 +280,13 @@ public:
 
   /** Render the options text */
   void render() const {
+    PIKA_TRACE_ZONE("OptionsView::render");
     if (renderer_ == nullptr || sprite_sheet_ == nullptr) {
       return;
     }
 
     // Render background
-    SDL_SetTextureAlphaModFloat(background_texture_.get(), 0.92);
-    SDL_RenderTexture(renderer_, background_texture_.get(), nullptr, &background_dst);
+    render_black_rect(&background_dst, 0.92f);
 
     // Render title
     constexpr float title_h = 25;
@@ -328,12 +318,12 @@ public:
   }
 
 private:
-  // Background black cover
-  SDL_Texture_ptr background_texture_ {nullptr, SDL_DestroyTexture};
-  // Pointer to text font
-  TTF_Font* text_font_ {nullptr};
+  // Owner of the textures
+  RenderResources* resources_ {nullptr};
+  // Renders the text textures
+  const TextRenderer* text_renderer_ {nullptr};
   // Title text textures
-  SDL_Texture_ptr title_texture_ {nullptr, SDL_DestroyTexture};
+  RenderResources::Texture title_texture_;
   // Option items
   std::map<OptionMenuSelection, std::unique_ptr<OptionItem>> options_;
   OptionMenuSelection selection_ = OptionMenuSelection::Speed;
@@ -343,26 +333,8 @@ private:
       return;
     }
 
-    // Create a small black surface for the menu background
-    background_texture_.reset(SDL_CreateTexture(
-      renderer_,
-      SDL_PIXELFORMAT_ARGB8888,
-      SDL_TEXTUREACCESS_TARGET,
-      background_dst.w,
-      background_dst.h
-    ));
-    // Set the texture scaling mode to nearest interpolation
-    SDL_SetTextureScaleMode(background_texture_.get(), SDL_SCALEMODE_NEAREST);
-    // Clear the black texture with a black background
-    SDL_SetRenderTarget(renderer_, background_texture_.get());
-    SDL_SetRenderDrawColor(renderer_, 0x00, 0x00, 0x00, 0xFF);
-    SDL_RenderClear(renderer_);
-
-    // Set the render target back to the main window
-    SDL_SetRenderTarget(renderer_, nullptr);
-
-    // Load text textures
-    title_texture_ = load_text_texture(renderer_, text_font_, txt::str_options);
+    // Load text textures (the background is a filled rect)
+    title_texture_ = resources_->text(*text_renderer_, txt::str_options);
   }
 
 };
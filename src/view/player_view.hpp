@@ -1,7 +1,7 @@
 #ifndef PIKA_PLAYER_VIEW_HPP
 #define PIKA_PLAYER_VIEW_HPP
 
-#include <map>
+#include <array>
 
 #include <SDL3/SDL_render.h>
 #include <pikaball/physics/player.hpp>
@@ -9,15 +9,30 @@
 
 namespace pika::view {
 
-static const std::map<PlayerState, std::array<SDL_FRect, 5>> player_animations = {
-  {PlayerState::Normal, sprite::pikachu_normal_animation},
-  {PlayerState::Jumping, sprite::pikachu_jump_animation},
-  {PlayerState::PowerHit, sprite::pikachu_hit_animation},
-  {PlayerState::Diving, sprite::pikachu_dive_animation},
-  {PlayerState::AfterDiving, sprite::pikachu_after_diving_animation},  // Actually only one
-  {PlayerState::Winner, sprite::pikachu_winner_animation},
-  {PlayerState::Loser, sprite::pikachu_loser_animation}
-};
+/** Sprite of each frame of the player animations, indexed by state_index() and frame number */
+constexpr std::array<std::array<SDL_FRect, max_animation_frames>, num_player_states> player_sprites = [] {
+  std::array<std::array<SDL_FRect, max_animation_frames>, num_player_states> table {};
+  table[state_index(PlayerState::Normal)] = sprite::pikachu_normal_animation;
+  table[state_index(PlayerState::Jumping)] = sprite::pikachu_jump_animation;
+  table[state_index(PlayerState::PowerHit)] = sprite::pikachu_hit_animation;
+  table[state_index(PlayerState::Diving)] = sprite::pikachu_dive_animation;
+  table[state_index(PlayerState::AfterDiving)] = sprite::pikachu_after_diving_animation;  // Actually only one
+  table[state_index(PlayerState::Winner)] = sprite::pikachu_winner_animation;
+  table[state_index(PlayerState::Loser)] = sprite::pikachu_loser_animation;
+  return table;
+}();
+
+static_assert([] {
+  // Every state needs a sprite for each frame of its animation
+  for (std::size_t i = 0; i < num_player_states; i++) {
+    for (std::size_t frame = 0; frame < player_animations[i].frames; frame++) {
+      if (player_sprites[i][frame].w <= 0 || player_sprites[i][frame].h <= 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}(), "Missing player animation sprites");
 
 class PlayerView {
 public:
@@ -31,11 +46,52 @@ public:
    * @param player The Player object from the game Physics
    */
   void draw_player(const Player& player) const {
-    const PlayerState state = player.state();
-    const SDL_FRect src_sprite = player_animations.at(state)[player.anim_frame_number()];
-    const int player_width = static_cast<int>(src_sprite.w);
-    const int player_height = static_cast<int>(src_sprite.h);
+    const SDL_FRect& src_sprite = sprite(player);
+    const SDL_FRect player_dst = sprite_dst(player);
+    SDL_RenderTextureRotated(renderer_, sprite_sheet_,
+                             &src_sprite, &player_dst,
+                             0.0, nullptr, flip_mode(player));
+  }
 
+  /**
+   * Draw the shadow of the player
+   * @param player The Player object from the game Physics
+   */
+  void draw_shadow(const Player& player) const {
+    const SDL_FRect dst = shadow_dst(player);
+    SDL_RenderTexture(renderer_, sprite_sheet_, &sprite::objects_shadow, &dst);
+  }
+
+  /**
+   * Get the sprite of the current animation frame of the player
+   * @param player The Player object from the game Physics
+   */
+  [[nodiscard]] static const SDL_FRect& sprite(const Player& player) {
+    return player_sprites[state_index(player.state())][player.anim_frame_number()];
+  }
+
+  /**
+   * Get the position of the player sprite (centered on the player coordinates)
+   * @param player The Player object from the game Physics
+   */
+  [[nodiscard]] static SDL_FRect sprite_dst(const Player& player) {
+    const SDL_FRect& src_sprite = sprite(player);
+    const int x = player.x() - static_cast<int>(src_sprite.w) / 2;
+    const int y = player.y() - static_cast<int>(src_sprite.h) / 2;
+    return {
+      .x = static_cast<float>(x),
+      .y = static_cast<float>(y),
+      .w = src_sprite.w,
+      .h = src_sprite.h,
+    };
+  }
+
+  /**
+   * Get the orientation of the player sprite
+   * @param player The Player object from the game Physics
+   */
+  [[nodiscard]] static SDL_FlipMode flip_mode(const Player& player) {
+    const PlayerState state = player.state();
     // Initially, only flip the sprite of the right side
     SDL_FlipMode flip = player.side() == FieldSide::Left ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL;
     // If the player is diving... Only flip it when diving to the left
@@ -47,32 +103,20 @@ public:
         flip = SDL_FLIP_NONE;
       }
     }
-
-    const int x = player.x() - player_width / 2;
-    const int y = player.y() - player_height / 2;
-    const SDL_FRect player_dst {
-      .x = static_cast<float>(x),
-      .y = static_cast<float>(y),
-      .w = src_sprite.w,
-      .h = src_sprite.h,
-    };
-    SDL_RenderTextureRotated(renderer_, sprite_sheet_,
-                             &src_sprite, &player_dst,
-                             0.0, nullptr, flip);
+    return flip;
   }
 
   /**
-   * Draw the shadow of the player
+   * Get the position of the player shadow
    * @param player The Player object from the game Physics
    */
-  void draw_shadow(const Player& player) const {
-    const SDL_FRect shadow_dst {
+  [[nodiscard]] static SDL_FRect shadow_dst(const Player& player) {
+    return {
       .x = static_cast<float>(player.x()) - sprite::objects_shadow.w / 2,
       .y = 273 - sprite::objects_shadow.h / 2,
       .w = sprite::objects_shadow.w,
       .h = sprite::objects_shadow.h,
     };
-    SDL_RenderTexture(renderer_, sprite_sheet_, &sprite::objects_shadow, &shadow_dst);
   }
 
 private:
@@ -0,0 +1,201 @@
+#ifndef PIKA_RENDER_RESOURCES_HPP
+#define PIKA_RENDER_RESOURCES_HPP
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <SDL3/SDL_assert.h>
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_render.h>
+#include "text_renderer.hpp"
+
+namespace pika::view {
+
+/**
+ * Owner of the textures created by the views (render targets, text and other textures).
+ *
+ * Textures are shared: a view asking for a texture that already exists (same key, or same text
+ * and color) gets the same texture instead of a new one. They are reference counted and released
+ * when the last view that uses them releases them. The manager also keeps their size, to report
+ * the video memory used by the game.
+ * It must be used from the render thread, and it must not outlive its renderer.
+ */
+class RenderResources {
+public:
+  // Reference counted texture (destroyed when the last reference is released)
+  using Texture = std::shared_ptr<SDL_Texture>;
+
+  explicit RenderResources(SDL_Renderer* renderer) : renderer_(renderer) {}
+  RenderResources(RenderResources const&) = delete;
+  RenderResources(RenderResources &&) = delete;
+  RenderResources &operator=(RenderResources const&) = delete;
+  RenderResources &operator=(RenderResources &&) = delete;
+
+  /**
+   * Get a render target with static contents, drawn once when the texture is created
+   * @param key Name of the texture. Views asking for the same key share the texture (and must ask for the same size)
+   * @param width Texture width
+   * @param height Texture height
+   * @param draw Function that draws the contents. The texture is the render target while it is called
+   * @return The shared texture, or nullptr if it could not be created
+   */
+  template <typename DrawFunction>
+  [[nodiscard]] Texture target(const std::string& key, const int width, const int height, DrawFunction&& draw) {
+    if (Texture texture = find(entries_, key)) {
+      if (texture->w != width || texture->h != height) {
+        SDL_Log("The %s texture was requested with size %dx%d, but it exists with size %dx%d",
+                key.c_str(), width, height, texture->w, texture->h);
+      }
+      SDL_assert(texture->w == width && texture->h == height);
+      return texture;
+    }
+    Texture texture = add(entries_, key, SDL_CreateTexture(
+      renderer_,
+      SDL_PIXELFORMAT_ARGB8888,
+      SDL_TEXTUREACCESS_TARGET,
+      width,
+      height
+    ));
+    if (!texture) {
+      SDL_Log("Unable to create the %s texture! SDL Error: %s\n", key.c_str(), SDL_GetError());
+      return nullptr;
+    }
+    // Set the texture scaling mode to nearest interpolation
+    SDL_SetTextureScaleMode(texture.get(), SDL_SCALEMODE_NEAREST);
+    // Save the current render target (the frame target) to restore it later
+    SDL_Texture* previous_target = SDL_GetRenderTarget(renderer_);
+    SDL_SetRenderTarget(renderer_, texture.get());
+    draw(texture.get());
+    SDL_SetRenderTarget(renderer_, previous_target);
+    return texture;
+  }
+
+  /**
+   * Get a texture with a line of text (see TextRenderer::render)
+   * @param text_renderer Renders the text if there is no texture with the same text and color
+   * @param text The text to render
+   * @param text_color The color of the text
+   * @return The shared texture
+   */
+  [[nodiscard]] Texture text(
+    const TextRenderer& text_renderer,
+    const std::string& text,
+    const SDL_Color& text_color = {255, 255, 255})
+  {
+    // Looked up without copying the text: views ask for their texts again when they are created
+    const TextKeyView key {pack_color(text_color), text};
+    if (Texture texture = find(text_entries_, key)) {
+      return texture;
+    }
+    return add(text_entries_, TextKey {key.color, text}, text_renderer.render(renderer_, text, text_color).release());
+  }
+
+  /** Estimated video memory used by the live textures (bytes) */
+  [[nodiscard]] std::size_t vram_bytes() const {
+    std::size_t bytes = 0;
+    for (const auto& [key, entry] : entries_) {
+      if (!entry.texture.expired()) {
+        bytes += entry.bytes;
+      }
+    }
+    for (const auto& [key, entry] : text_entries_) {
+      if (!entry.texture.expired()) {
+        bytes += entry.bytes;
+      }
+    }
+    return bytes;
+  }
+
+  /** Log the live textures and the video memory they use */
+  void report() const {
+    std::size_t count = 0;
+    for (const auto& [key, entry] : entries_) {
+      if (entry.texture.expired()) {
+        continue;
+      }
+      count++;
+      SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Texture %s: %.1f KB (%ld users)", key.c_str(),
+                   static_cast<double>(entry.bytes) / 1024, entry.texture.use_count());
+    }
+    for (const auto& [key, entry] : text_entries_) {
+      if (entry.texture.expired()) {
+        continue;
+      }
+      count++;
+      SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Texture text #%08x %s: %.1f KB (%ld users)", key.color,
+                   key.text.c_str(), static_cast<double>(entry.bytes) / 1024, entry.texture.use_count());
+    }
+    SDL_Log("Textures: %zu, estimated video memory: %.1f KB", count, static_cast<double>(vram_bytes()) / 1024);
+  }
+
+private:
+  struct Entry {
+    std::weak_ptr<SDL_Texture> texture;
+    std::size_t bytes {0};
+  };
+
+  // Text textures are identified by their color (RGBA, 8 bits each) and their text
+  struct TextKey {
+    Uint32 color {0};
+    std::string text;
+  };
+  struct TextKeyView {
+    Uint32 color {0};
+    std::string_view text;
+  };
+  // Orders the stored keys and the lookup views together (transparent comparator)
+  struct TextKeyLess {
+    using is_transparent = void;
+    template <typename A, typename B>
+    bool operator()(const A& a, const B& b) const {
+      if (a.color != b.color) {
+        return a.color < b.color;
+      }
+      return std::string_view {a.text} < std::string_view {b.text};
+    }
+  };
+
+  SDL_Renderer* renderer_ {nullptr};
+  std::map<std::string, Entry> entries_;
+  std::map<TextKey, Entry, TextKeyLess> text_entries_;
+
+  [[nodiscard]] static Uint32 pack_color(const SDL_Color& color) {
+    return static_cast<Uint32>(color.r) << 24 | static_cast<Uint32>(color.g) << 16 |
+           static_cast<Uint32>(color.b) << 8 | static_cast<Uint32>(color.a);
+  }
+
+  /** Get a live texture. The entry of a texture released by all the views is removed */
+  template <typename Map, typename Key>
+  [[nodiscard]] static Texture find(Map& entries, const Key& key) {
+    const auto it = entries.find(key);
+    if (it == entries.end()) {
+      return nullptr;
+    }
+    Texture texture = it->second.texture.lock();
+    if (!texture) {
+      entries.erase(it);
+    }
+    return texture;
+  }
+
+  /** Share a new texture. The entries of the textures released by all the views are removed */
+  template <typename Map, typename Key>
+  static Texture add(Map& entries, Key&& key, SDL_Texture* texture) {
+    if (texture == nullptr) {
+      return nullptr;
+    }
+    Texture shared {texture, SDL_DestroyTexture};
+    // Textures are stored with 4 bytes per pixel
+    const std::size_t bytes = 4 * static_cast<std::size_t>(texture->w) * static_cast<std::size_t>(texture->h);
+    std::erase_if(entries, [](const auto& entry) { return entry.second.texture.expired(); });
+    entries.insert_or_assign(std::forward<Key>(key), Entry {shared, bytes});
+    return shared;
+  }
+};
+
+} // namespace pika::view
+
+#endif // PIKA_RENDER_RESOURCES_HPP
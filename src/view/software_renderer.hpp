@@ -0,0 +1,272 @@
+#ifndef PIKA_SOFTWARE_RENDERER_HPP
+#define PIKA_SOFTWARE_RENDERER_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_rect.h>
+#include <SDL3/SDL_surface.h>
+#include <pikaball/common.hpp>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace pika::view {
+
+namespace detail {
+
+static_assert(std::endian::native == std::endian::little,
+  "The software renderer stores RGBA32 pixels as little-endian 32-bit words");
+
+// RGBA32 pixels (bytes R, G, B, A in memory): the alpha channel is the high byte of each word
+constexpr std::uint32_t alpha_mask = 0xFF000000u;
+
+/**
+ * Blend one 8-bit channel: (src * alpha + dst * (255 - alpha)) / 255, rounded.
+ * The SIMD kernels use the same arithmetic, so all the paths give the same pixels.
+ */
+constexpr std::uint32_t blend_channel(const std::uint32_t src, const std::uint32_t dst, const std::uint32_t alpha) {
+  const std::uint32_t x = src * alpha + dst * (255 - alpha) + 128;
+  return (x + (x >> 8)) >> 8;
+}
+
+/** Blend a source pixel over an opaque destination pixel (the result is opaque) */
+constexpr std::uint32_t blend_pixel(const std::uint32_t src, const std::uint32_t dst) {
+  const std::uint32_t alpha = src >> 24;
+  if (alpha == 0xFF) {
+    return src;
+  }
+  if (alpha == 0) {
+    return dst;
+  }
+  std::uint32_t result = alpha_mask;
+  for (int shift = 0; shift < 24; shift += 8) {
+    result |= blend_channel((src >> shift) & 0xFF, (dst >> shift) & 0xFF, alpha) << shift;
+  }
+  return result;
+}
+
+#ifdef __SSE2__
+/** Blend 2 pixels (unpacked to 16-bit channels) with their own alpha. Same arithmetic as blend_channel() */
+inline __m128i blend_epi16(const __m128i src, const __m128i dst, const __m128i alpha) {
+  const __m128i inverse_alpha = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+  __m128i x = _mm_add_epi16(_mm_mullo_epi16(src, alpha), _mm_mullo_epi16(dst, inverse_alpha));
+  x = _mm_add_epi16(x, _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+#endif
+
+/**
+ * Blend a row of source pixels over an opaque row of the framebuffer.
+ * Fully opaque and fully transparent groups of pixels (most of the sprite pixels) skip the arithmetic.
+ */
+inline void blend_row(std::uint32_t* dst, const std::uint32_t* src, const std::size_t count) {
+  std::size_t i = 0;
+#ifdef __SSE2__
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i alpha_bits = _mm_set1_epi32(static_cast<int>(alpha_mask));
+  for (; i + 4 <= count; i += 4) {
+    const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i s_alpha = _mm_and_si128(s, alpha_bits);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(s_alpha, alpha_bits)) == 0xFFFF) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), s);
+      continue;
+    }
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(s_alpha, zero)) == 0xFFFF) {
+      continue;
+    }
+    const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    const __m128i s_lo = _mm_unpacklo_epi8(s, zero);
+    const __m128i s_hi = _mm_unpackhi_epi8(s, zero);
+    // Broadcast the alpha of each pixel to its 4 channels
+    const __m128i a_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_lo, 0xFF), 0xFF);
+    const __m128i a_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_hi, 0xFF), 0xFF);
+    const __m128i lo = blend_epi16(s_lo, _mm_unpacklo_epi8(d, zero), a_lo);
+    const __m128i hi = blend_epi16(s_hi, _mm_unpackhi_epi8(d, zero), a_hi);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(_mm_packus_epi16(lo, hi), alpha_bits));
+  }
+#endif
+  for (; i < count; i++) {
+    dst[i] = blend_pixel(src[i], dst[i]);
+  }
+}
+
+/** Blend a constant black color with the given alpha over a row of the framebuffer */
+inline void darken_row(std::uint32_t* dst, const std::size_t count, const std::uint32_t alpha) {
+  std::size_t i = 0;
+#ifdef __SSE2__
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i alpha_bits = _mm_set1_epi32(static_cast<int>(alpha_mask));
+  const __m128i a = _mm_set1_epi16(static_cast<short>(alpha));
+  for (; i + 4 <= count; i += 4) {
+    const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    const __m128i lo = blend_epi16(zero, _mm_unpacklo_epi8(d, zero), a);
+    const __m128i hi = blend_epi16(zero, _mm_unpackhi_epi8(d, zero), a);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(_mm_packus_epi16(lo, hi), alpha_bits));
+  }
+#endif
+  for (; i < count; i++) {
+    dst[i] = blend_pixel((alpha << 24), dst[i]);
+  }
+}
+
+} // namespace pika::view::detail
+
+/**
+ * CPU renderer that draws sprites from the sprite sheet into an RGBA framebuffer
+ * with the native resolution of the game (screen_width x screen_height).
+ *
+ * It does not use SDL_Renderer (only SDL surfaces to convert the sprite sheet),
+ * so it works on machines without a display or GPU.
+ * Sprites are drawn with the same semantics as SDL_RenderTexture() with nearest scaling
+ * and alpha blending. The framebuffer is always opaque.
+ * Pixels are stored as SDL_PIXELFORMAT_RGBA32 (bytes R, G, B, A in memory).
+ */
+class SoftwareRenderer {
+public:
+  /** Pixel format of the framebuffer and the sprite sheet */
+  constexpr static SDL_PixelFormat pixel_format = SDL_PIXELFORMAT_RGBA32;
+
+  /**
+   * Create the renderer and copy the sprite sheet pixels.
+   * @param sprite_sheet The decoded sprite sheet (any format). The surface is not modified.
+   */
+  explicit SoftwareRenderer(SDL_Surface* sprite_sheet) :
+    framebuffer_(static_cast<std::size_t>(screen_width) * screen_height, detail::alpha_mask)
+  {
+    SDL_Surface* converted = (sprite_sheet != nullptr) ?
+      SDL_ConvertSurface(sprite_sheet, pixel_format) : nullptr;
+    if (converted == nullptr) {
+      SDL_Log("Unable to convert the sprite sheet for the software renderer! SDL Error: %s\n", SDL_GetError());
+      throw std::runtime_error("Failed to load the sprite sheet pixels");
+    }
+    sheet_width_ = converted->w;
+    sheet_height_ = converted->h;
+    sheet_.resize(static_cast<std::size_t>(sheet_width_) * sheet_height_);
+    for (int y = 0; y < sheet_height_; y++) {
+      std::memcpy(
+        &sheet_[static_cast<std::size_t>(y) * sheet_width_],
+        static_cast<const std::uint8_t*>(converted->pixels) + static_cast<std::size_t>(y) * converted->pitch,
+        static_cast<std::size_t>(sheet_width_) * sizeof(std::uint32_t));
+    }
+    SDL_DestroySurface(converted);
+  }
+
+  /**
+   * Fill the framebuffer with an opaque color
+   * @param r, g, b The color components
+   */
+  void clear(const std::uint8_t r, const std::uint8_t g, const std::uint8_t b) {
+    const std::uint32_t color = detail::alpha_mask | static_cast<std::uint32_t>(b) << 16 |
+                                static_cast<std::uint32_t>(g) << 8 | r;
+    std::ranges::fill(framebuffer_, color);
+  }
+
+  /**
+   * Replace the whole framebuffer with a previously rendered frame (e.g. a static background)
+   * @param frame The pixels of a frame with the same size as the framebuffer
+   */
+  void copy(const std::span<const std::uint32_t> frame) {
+    std::ranges::copy(frame.first(framebuffer_.size()), framebuffer_.begin());
+  }
+
+  /**
+   * Draw a sprite from the sprite sheet. Same as SDL_RenderTexture() (or SDL_RenderTextureRotated()
+   * with a horizontal flip) with nearest scaling and blending enabled.
+   * @param src The sprite rect in the sprite sheet
+   * @param dst Destination rect in the framebuffer. It is scaled if the size is different.
+   * @param flip_horizontal Mirror the sprite horizontally
+   */
+  void draw(const SDL_FRect& src, const SDL_FRect& dst, const bool flip_horizontal = false) {
+    const int src_x = static_cast<int>(src.x);
+    const int src_y = static_cast<int>(src.y);
+    const int src_w = static_cast<int>(src.w);
+    const int src_h = static_cast<int>(src.h);
+    const int dst_x = static_cast<int>(dst.x);
+    const int dst_y = static_cast<int>(dst.y);
+    const int dst_w = static_cast<int>(dst.w);
+    const int dst_h = static_cast<int>(dst.h);
+    if (src_w <= 0 || src_h <= 0 || dst_w <= 0 || dst_h <= 0 ||
+        src_x < 0 || src_y < 0 || src_x + src_w > sheet_width_ || src_y + src_h > sheet_height_) {
+      return;
+    }
+
+    // Clip the destination to the framebuffer
+    const int x_begin = std::max(dst_x, 0);
+    const int x_end = std::min(dst_x + dst_w, screen_width);
+    const int y_begin = std::max(dst_y, 0);
+    const int y_end = std::min(dst_y + dst_h, screen_height);
+    if (x_begin >= x_end || y_begin >= y_end) {
+      return;
+    }
+    const auto count = static_cast<std::size_t>(x_end - x_begin);
+
+    if (!flip_horizontal && src_w == dst_w && src_h == dst_h) {
+      // Fast path: blend the rows of the sheet directly
+      for (int y = y_begin; y < y_end; y++) {
+        const std::uint32_t* src_row = sheet_row(src_y + y - dst_y) + src_x + (x_begin - dst_x);
+        detail::blend_row(frame_row(y) + x_begin, src_row, count);
+      }
+      return;
+    }
+
+    // Scaled or flipped: gather the source pixels of each row (nearest sample at the pixel centers)
+    std::array<int, screen_width> columns {};
+    for (int x = x_begin; x < x_end; x++) {
+      const int u = ((x - dst_x) * 2 + 1) * src_w / (2 * dst_w);
+      columns[x - x_begin] = src_x + (flip_horizontal ? src_w - 1 - u : u);
+    }
+    for (int y = y_begin; y < y_end; y++) {
+      const int v = ((y - dst_y) * 2 + 1) * src_h / (2 * dst_h);
+      const std::uint32_t* src_row = sheet_row(src_y + v);
+      for (std::size_t i = 0; i < count; i++) {
+        row_buffer_[i] = src_row[columns[i]];
+      }
+      detail::blend_row(frame_row(y) + x_begin, row_buffer_.data(), count);
+    }
+  }
+
+  /**
+   * Cover the whole framebuffer with black. Same as rendering the black fade texture of the views.
+   * @param alpha Opacity of the black cover [0.0, 1.0]
+   */
+  void fade(const float alpha) {
+    const auto alpha_8 = static_cast<std::uint32_t>(std::clamp(alpha, 0.0f, 1.0f) * 255.0f + 0.5f);
+    if (alpha_8 == 0) {
+      return;
+    }
+    detail::darken_row(framebuffer_.data(), framebuffer_.size(), alpha_8);
+  }
+
+  /** Get the framebuffer pixels (screen_width x screen_height, rows without padding) */
+  [[nodiscard]] std::span<const std::uint32_t> pixels() const { return framebuffer_; }
+  /** Size in bytes of a row of the framebuffer */
+  [[nodiscard]] constexpr static int pitch() { return screen_width * static_cast<int>(sizeof(std::uint32_t)); }
+
+private:
+  std::vector<std::uint32_t> framebuffer_;
+  std::vector<std::uint32_t> sheet_;
+  int sheet_width_ {0};
+  int sheet_height_ {0};
+  // Scratch row for scaled / flipped sprites
+  std::array<std::uint32_t, screen_width> row_buffer_ {};
+
+  [[nodiscard]] std::uint32_t* frame_row(const int y) {
+    return &framebuffer_[static_cast<std::size_t>(y) * screen_width];
+  }
+  [[nodiscard]] const std::uint32_t* sheet_row(const int y) const {
+    return &sheet_[static_cast<std::size_t>(y) * sheet_width_];
+  }
+};
+
+} // namespace pika::view
+
+#endif // PIKA_SOFTWARE_RENDERER_HPP
@@ -0,0 +1,185 @@
+#ifndef PIKA_SOFTWARE_VOLLEY_VIEW_HPP
+#define PIKA_SOFTWARE_VOLLEY_VIEW_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "software_renderer.hpp"
+#include "volley_view.hpp"
+
+namespace pika::view {
+
+/**
+ * Headless version of VolleyView that draws the same scene with the SoftwareRenderer.
+ * The sprite layout is shared with VolleyView, BallView and PlayerView, so both views
+ * render the same frames for the same states. Meant for video export without a display.
+ */
+class SoftwareVolleyView {
+public:
+  ~SoftwareVolleyView() = default;
+  SoftwareVolleyView(SoftwareVolleyView const&) = delete;
+  SoftwareVolleyView(SoftwareVolleyView &&) = delete;
+  SoftwareVolleyView &operator=(SoftwareVolleyView const&) = delete;
+  SoftwareVolleyView &operator=(SoftwareVolleyView &&) = delete;
+
+  /**
+   * Create the view and precompute the static background
+   * @param renderer The software renderer to draw with (must outlive the view)
+   */
+  explicit SoftwareVolleyView(SoftwareRenderer& renderer) :
+    renderer_(renderer)
+  {
+    // Fill the background white and draw all the background tiles once
+    renderer_.clear(0xFF, 0xFF, 0xFF);
+    VolleyView::for_each_background_sprite([this](const SDL_FRect& src, const SDL_FRect& dst) {
+      renderer_.draw(src, dst);
+    });
+    const auto pixels = renderer_.pixels();
+    background_.assign(pixels.begin(), pixels.end());
+  }
+
+  /** Reset the game state to start the first round (same as VolleyView::start()) */
+  void start() {
+    black_fade_alpha_ = 1.0f;
+    score_left_ = 0;
+    score_right_ = 0;
+    volley_game_state_ = VolleyGameState::NewGame;
+  }
+
+  /**
+   * Render the new frame based on the game state and the frame counter (same as VolleyView::render())
+   * @param frame_counter The current frame counter (used for animations)
+   * @param physics_view A const view of the Physics' objects
+   */
+  void render(const unsigned int frame_counter, const PhysicsView& physics_view) {
+    PIKA_TRACE_ZONE("SoftwareVolleyView::render");
+    // Static background, waves and clouds
+    renderer_.copy(background_);
+    render_waves();
+    render_clouds();
+    // Ball and players
+    render_physics(physics_view);
+    // Scoreboard
+    VolleyView::for_each_score_sprite(score_left_, score_right_, [this](const SDL_FRect& src, const SDL_FRect& dst) {
+      renderer_.draw(src, dst);
+    });
+
+    switch (volley_game_state_) {
+      case VolleyGameState::NewGame:
+        fade_in(1.0f / 17);
+        renderer_.draw(sprite::msg_game_start, VolleyView::game_start_dst(frame_counter));
+      break;
+      case VolleyGameState::StartRound:
+        fade_in(1.0f / 16);
+        if (VolleyView::ready_msg_visible(frame_counter)) {
+          renderer_.draw(sprite::msg_ready, VolleyView::ready_msg_dst);
+        }
+      break;
+      case VolleyGameState::PlayRound:
+      break;
+      case VolleyGameState::EndRound:
+        if (frame_counter >= 6) {
+          fade_out(1.0f / 16);
+        }
+        if (frame_counter >= VolleyView::end_round_frames) {
+          black_fade_alpha_ = 1.0f;
+        }
+      break;
+      case VolleyGameState::GameEnd:
+        renderer_.draw(sprite::msg_game_end, VolleyView::game_end_dst(frame_counter));
+      break;
+      case VolleyGameState::Replay:
+        black_fade_alpha_ = 0.0f;
+      break;
+    }
+  }
+
+  /**
+   * Change the volley game state to know what to render
+   * @param state The new VolleyGame state
+   */
+  void set_state(const VolleyGameState state) {
+    volley_game_state_ = state;
+  }
+
+  /**
+   * Update the players' score
+   * @param left Score for left player
+   * @param right Score for right player
+   */
+  void set_score(const int left, const int right) {
+    score_left_ = left;
+    score_right_ = right;
+  }
+
+  /**
+   * Set the alpha of the black cover (same as View::fade_out(1.0) between rounds)
+   * @param alpha The new alpha value [0.0, 1.0]
+   */
+  void set_fade_alpha(const float alpha) { black_fade_alpha_ = alpha; }
+
+private:
+  SoftwareRenderer& renderer_;
+  // Pixels of the static background
+  std::vector<std::uint32_t> background_;
+
+  VolleyGameState volley_game_state_ {VolleyGameState::NewGame};
+  int score_left_ {0};
+  int score_right_ {0};
+  float black_fade_alpha_ {1.0f};
+
+  Wave wave_;
+  CloudSet clouds_;
+
+  /** Update and render the waves */
+  void render_waves() {
+    wave_.update();
+    SDL_FRect dst {
+      .x = 0,
+      .y = 0,
+      .w = 16,
+      .h = 32,
+    };
+    for (const auto& w : wave_.get_coords()) {
+      dst.y = static_cast<float>(w);
+      renderer_.draw(sprite::objects_wave, dst);
+      dst.x += dst.w;
+    }
+  }
+
+  /** Update and render the clouds */
+  void render_clouds() {
+    clouds_.update();
+    for (const auto& cloud : clouds_.get_clouds()) {
+      renderer_.draw(cloud.is_special() ? sprite::objects_cloud_extra : sprite::objects_cloud, cloud.get_rect());
+    }
+  }
+
+  /** Render the ball and players (shadows first, so they don't get on top of the players) */
+  void render_physics(const PhysicsView& physics_view) {
+    renderer_.draw(sprite::objects_shadow, BallView::shadow_dst(physics_view.ball));
+    renderer_.draw(sprite::objects_shadow, PlayerView::shadow_dst(physics_view.player_left));
+    renderer_.draw(sprite::objects_shadow, PlayerView::shadow_dst(physics_view.player_right));
+    for (const Player* player : {&physics_view.player_left, &physics_view.player_right}) {
+      renderer_.draw(PlayerView::sprite(*player), PlayerView::sprite_dst(*player),
+                     PlayerView::flip_mode(*player) == SDL_FLIP_HORIZONTAL);
+    }
+    BallView::for_each_sprite(physics_view.ball, [this](const SDL_FRect& src, const SDL_FRect& dst) {
+      renderer_.draw(src, dst);
+    });
+  }
+
+  void fade_in(const float alpha_decrement) {
+    black_fade_alpha_ = std::max(0.0f, black_fade_alpha_ - alpha_decrement);
+    renderer_.fade(black_fade_alpha_);
+  }
+
+  void fade_out(const float alpha_increment) {
+    black_fade_alpha_ = std::min(1.0f, black_fade_alpha_ + alpha_increment);
+    renderer_.fade(black_fade_alpha_);
+  }
+};
+
+} // namespace pika::view
+
+#endif // PIKA_SOFTWARE_VOLLEY_VIEW_HPP
@@ -0,0 +1,173 @@
+#ifndef PIKA_TEXT_RENDERER_HPP
+#define PIKA_TEXT_RENDERER_HPP
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "SDL3_ttf/SDL_ttf.h"
+#include "pikaball/baked_assets.hpp"
+#include "view.hpp"
+
+namespace pika::view {
+
+/**
+ * Renders text into textures, either with the pre-baked glyph atlas or with a TTF font.
+ * The atlas is a single texture: the text is composed on the GPU and no font is rasterized.
+ * The TTF font is the fallback when the baked font is not available.
+ */
+class TextRenderer {
+public:
+  ~TextRenderer() {
+    if (ttf_font_ != nullptr) {
+      TTF_CloseFont(ttf_font_);
+    }
+  }
+  TextRenderer(TextRenderer const&) = delete;
+  TextRenderer(TextRenderer &&) = delete;
+  TextRenderer &operator=(TextRenderer const&) = delete;
+  TextRenderer &operator=(TextRenderer &&) = delete;
+
+  /**
+   * Render the text with a TTF font
+   * @param font The TTF font. The TextRenderer takes its ownership
+   */
+  explicit TextRenderer(TTF_Font* font) :
+    ttf_font_(font)
+  {}
+
+  /**
+   * Render the text with a baked glyph atlas. The atlas texture is created on the first render
+   * @param font The baked font
+   */
+  explicit TextRenderer(baked::Font font) :
+    baked_font_(std::move(font))
+  {}
+
+  /**
+   * Render a line of text into a new texture (transparent background)
+   * @param renderer The renderer that will use the texture
+   * @param text The text to render
+   * @param text_color The color of the text
+   * @return An owning pointer to the text texture
+   */
+  [[nodiscard]] View::SDL_Texture_ptr render(
+    SDL_Renderer* renderer,
+    const std::string & text,
+    const SDL_Color & text_color = {255, 255, 255}) const
+  {
+    if (ttf_font_ != nullptr) {
+      return render_ttf(renderer, text, text_color);
+    }
+    return render_baked(renderer, text, text_color);
+  }
+
+private:
+  TTF_Font* ttf_font_ {nullptr};
+  baked::Font baked_font_;
+  // Texture with the glyphs of the baked font
+  mutable View::SDL_Texture_ptr atlas_texture_ {nullptr, SDL_DestroyTexture};
+
+  [[nodiscard]] View::SDL_Texture_ptr render_ttf(
+    SDL_Renderer* renderer,
+    const std::string & text,
+    const SDL_Color & text_color) const
+  {
+    // Load the text into a temporary surface
+    SDL_Surface* text_surface = TTF_RenderText_Solid(ttf_font_, text.c_str(), 0, text_color);
+    if (text_surface == nullptr) {
+      SDL_Log("Unable to load text! SDL Error: %s\n", SDL_GetError());
+      throw std::runtime_error("Failed to load text!");
+    }
+    // Generate the texture and save it
+    View::SDL_Texture_ptr text_texture {nullptr, SDL_DestroyTexture};
+    text_texture.reset(SDL_CreateTextureFromSurface(renderer, text_surface));
+    // Release the temporary surface object
+    SDL_DestroySurface(text_surface);
+
+    return text_texture;
+  }
+
+  [[nodiscard]] View::SDL_Texture_ptr render_baked(
+    SDL_Renderer* renderer,
+    const std::string & text,
+    const SDL_Color & text_color) const
+  {
+    if (!atlas_texture_) {
+      atlas_texture_.reset(SDL_CreateTextureFromSurface(renderer, baked_font_.atlas.get()));
+      if (!atlas_texture_) {
+        SDL_Log("Unable to create the font atlas texture! SDL Error: %s\n", SDL_GetError());
+        throw std::runtime_error("Failed to load text!");
+      }
+      SDL_SetTextureScaleMode(atlas_texture_.get(), SDL_SCALEMODE_NEAREST);
+      SDL_SetTextureBlendMode(atlas_texture_.get(), SDL_BLENDMODE_BLEND);
+    }
+
+    // Size of the text (glyphs are placed one after the other, adjusted by the kerning of each
+    // pair of characters as TTF_RenderText_Solid() does)
+    int text_width = 1;
+    int pen_x = 0;
+    char previous = 0;
+    for (const char c : text) {
+      if (const baked::Glyph* glyph = baked_font_.glyph(c)) {
+        pen_x += baked_font_.kerning(previous, c);
+        text_width = std::max(text_width, pen_x + glyph->w);
+        pen_x += glyph->advance;
+        previous = c;
+      }
+    }
+
+    View::SDL_Texture_ptr text_texture {nullptr, SDL_DestroyTexture};
+    text_texture.reset(SDL_CreateTexture(
+      renderer,
+      SDL_PIXELFORMAT_ARGB8888,
+      SDL_TEXTUREACCESS_TARGET,
+      text_width,
+      baked_font_.height
+    ));
+    if (!text_texture) {
+      SDL_Log("Unable to load text! SDL Error: %s\n", SDL_GetError());
+      throw std::runtime_error("Failed to load text!");
+    }
+    SDL_SetTextureBlendMode(text_texture.get(), SDL_BLENDMODE_BLEND);
+
+    // Save the current render target (the frame target) to restore it later
+    SDL_Texture* previous_target = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, text_texture.get());
+    SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0x00);
+    SDL_RenderClear(renderer);
+    SDL_SetTextureColorMod(atlas_texture_.get(), text_color.r, text_color.g, text_color.b);
+    pen_x = 0;
+    previous = 0;
+    for (const char c : text) {
+      const baked::Glyph* glyph = baked_font_.glyph(c);
+      if (glyph == nullptr) {
+        continue;
+      }
+      pen_x += baked_font_.kerning(previous, c);
+      previous = c;
+      const SDL_FRect src {
+        .x = static_cast<float>(glyph->x),
+        .y = static_cast<float>(glyph->y),
+        .w = static_cast<float>(glyph->w),
+        .h = static_cast<float>(glyph->h),
+      };
+      const SDL_FRect dst {
+        .x = static_cast<float>(pen_x),
+        .y = 0,
+        .w = src.w,
+        .h = src.h,
+      };
+      SDL_RenderTexture(renderer, atlas_texture_.get(), &src, &dst);
+      pen_x += glyph->advance;
+    }
+    SDL_SetRenderTarget(renderer, previous_target);
+
+    return text_texture;
+  }
+};
+
+} // namespace pika::view
+
+#endif // PIKA_TEXT_RENDERER_HPP
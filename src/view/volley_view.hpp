@@ -2,22 +2,36 @@
 #define PIKA_VOLLEY_VIEW_HPP
 
 #include "view.hpp"
+#include "render_resources.hpp"
 #include "cloud.hpp"
 #include "wave.hpp"
 #include "ball_view.hpp"
 #include "player_view.hpp"
+#include "pikaball/game_state.hpp"
 #include "pikaball/physics/physics.hpp"
+#include "pikaball/volley_match.hpp"
 
 namespace pika::view {
 
+/** Render quality of the VolleyView. Each level also drops the cosmetic layers of the levels above */
+enum class RenderQuality {
+  Full,
+  NoClouds,
+  NoWaves,      // Only the cached static background
+  NoTrails,     // No trail of power hits
+  NoEffects,    // No punch effect
+};
+constexpr int max_render_quality_level = static_cast<int>(RenderQuality::NoEffects);
+constexpr const char* render_quality_names[] {"full", "no clouds", "no waves", "no trails", "no effects"};
+
 class VolleyView final : public View {
 public:
-  // Number of frames for the NewGame state
-  constexpr static unsigned int new_game_frames = 71;
-  constexpr static unsigned int start_round_frames = 30;
-  constexpr static unsigned int end_round_frames = 11;
-  constexpr static unsigned int game_end_frames = 211;
-  constexpr static unsigned int game_end_skip_frames = 70;
+  // Number of frames of the volley game states (the animations are timed with them)
+  constexpr static unsigned int new_game_frames = VolleyMatch::new_game_frames;
+  constexpr static unsigned int start_round_frames = VolleyMatch::start_round_frames;
+  constexpr static unsigned int end_round_frames = VolleyMatch::end_round_frames;
+  constexpr static unsigned int game_end_frames = VolleyMatch::game_end_frames;
+  constexpr static unsigned int game_end_skip_frames = VolleyMatch::game_end_skip_frames;
 
   ~VolleyView() override = default;
   VolleyView(VolleyView const&) = delete;
@@ -25,8 +39,9 @@ public:
   VolleyView &operator=(VolleyView const&) = delete;
   VolleyView &operator=(VolleyView &&) = delete;
 
-  explicit VolleyView(SDL_Renderer* renderer, SDL_Texture* sprite_sheet) :
+  explicit VolleyView(SDL_Renderer* renderer, SDL_Texture* sprite_sheet, RenderResources* resources) :
     View(renderer, sprite_sheet),
+    resources_(resources),
     ball_view_(renderer, sprite_sheet),
     player_view_left_(renderer, sprite_sheet),
     player_view_right_(renderer, sprite_sheet)
@@ -53,6 +68,7 @@ public:
    * @param physics_view A const view of the Physics' objects
    */
   void render(const unsigned int frame_counter, const PhysicsView& physics_view) {
+    PIKA_TRACE_ZONE("VolleyView::render");
     if (renderer_ == nullptr || sprite_sheet_ == nullptr) {
       return;
     }
@@ -91,6 +107,10 @@ public:
         // Draw the "Game end" message
         render_game_end(frame_counter);
       break;
+      case VolleyGameState::Replay:
+        // The replay is shown without any cover
+        black_fade_alpha_ = 0.0f;
+      break;
     }
   }
 
@@ -102,24 +122,26 @@ public:
     if (sprite_sheet_ == nullptr || renderer_ == nullptr) {
       return;
     }
-    // Create a target texture to render all the background elements to
-    background_texture_.reset(SDL_CreateTexture(
-      renderer_,
-      SDL_PIXELFORMAT_ARGB8888,
-      SDL_TEXTUREACCESS_TARGET,
-      screen_width,
-      screen_height
-    ));
-    // Set the texture scaling mode to nearest interpolation
-    SDL_SetTextureScaleMode(background_texture_.get(), SDL_SCALEMODE_NEAREST);
-
-    // Focus the renderer on the target texture
-    SDL_SetRenderTarget(renderer_, background_texture_.get());
-
-    // Fill the background white
-    SDL_SetRenderDrawColor(renderer_, 0xFF, 0xFF, 0xFF, 0xFF);
-    SDL_RenderClear(renderer_);
+    // Render all the background elements to a target texture
+    background_texture_ = resources_->target("volley_background", screen_width, screen_height, [this](SDL_Texture*) {
+      // Fill the background white
+      SDL_SetRenderDrawColor(renderer_, 0xFF, 0xFF, 0xFF, 0xFF);
+      SDL_RenderClear(renderer_);
+
+      // Draw all the background tiles
+      for_each_background_sprite([this](const SDL_FRect& src, const SDL_FRect& dst) {
+        SDL_RenderTexture(renderer_, sprite_sheet_, &src, &dst);
+      });
+    });
+  }
 
+  /**
+   * Call a draw function for every sprite of the static background, in drawing order.
+   * Shared by all the renderers.
+   * @param draw Function called with the source sprite and the destination rects
+   */
+  template <typename DrawFunction>
+  static void for_each_background_sprite(DrawFunction&& draw) {
     // Build the sky
     SDL_FRect f_dst;
     SDL_Rect dst = {
@@ -133,8 +155,7 @@ public:
         dst.x = i * 16;
         dst.y = j * 16;
         SDL_RectToFRect(&dst, &f_dst);
-        SDL_RenderTexture(
-          renderer_, sprite_sheet_, &sprite::objects_sky_blue, &f_dst);
+        draw(sprite::objects_sky_blue, f_dst);
       }
     }
     // Render the mountain sprite
@@ -143,8 +164,7 @@ public:
     dst.w = 432;
     dst.h = 64;
     SDL_RectToFRect(&dst, &f_dst);
-    SDL_RenderTexture(
-      renderer_, sprite_sheet_, &sprite::objects_mountain, &f_dst);
+    draw(sprite::objects_mountain, f_dst);
 
     // Render the red ground
     dst.y = 248;
@@ -153,27 +173,23 @@ public:
     for (int i = 0; i < screen_width / 16; i++) {
       dst.x = i * 16;
       SDL_RectToFRect(&dst, &f_dst);
-      SDL_RenderTexture(
-        renderer_, sprite_sheet_, &sprite::objects_ground_red, &f_dst);
+      draw(sprite::objects_ground_red, f_dst);
     }
 
     // Render the ground line (the field delimiters)
     dst.x = 0;
     dst.y = 264;
     SDL_RectToFRect(&dst, &f_dst);
-    SDL_RenderTexture(
-      renderer_, sprite_sheet_, &sprite::objects_ground_line_leftmost, &f_dst);
+    draw(sprite::objects_ground_line_leftmost, f_dst);
     for (int i = 1; i < screen_width / 16 - 1; i++) {
       dst.x = i * 16;
       SDL_RectToFRect(&dst, &f_dst);
-      SDL_RenderTexture(
-        renderer_, sprite_sheet_, &sprite::objects_ground_line, &f_dst);
+      draw(sprite::objects_ground_line, f_dst);
     }
     dst.x = screen_width - 16;
     dst.y = 264;
     SDL_RectToFRect(&dst, &f_dst);
-    SDL_RenderTexture(
-      renderer_, sprite_sheet_, &sprite::objects_ground_line_rightmost, &f_dst);
+    draw(sprite::objects_ground_line_rightmost, f_dst);
 
     // Render the yellow ground
     for (int i = 0; i < screen_width / 16; i++) {
@@ -181,8 +197,7 @@ public:
         dst.x = i * 16;
         dst.y = 280 + j * 16;
         SDL_RectToFRect(&dst, &f_dst);
-        SDL_RenderTexture(
-          renderer_, sprite_sheet_, &sprite::objects_ground_yellow, &f_dst);
+        draw(sprite::objects_ground_yellow, f_dst);
       }
     }
 
@@ -192,17 +207,123 @@ public:
     dst.w = 8;
     dst.h = 8;
     SDL_RectToFRect(&dst, &f_dst);
-    SDL_RenderTexture(
-      renderer_, sprite_sheet_, &sprite::objects_net_pillar_top, &f_dst);
+    draw(sprite::objects_net_pillar_top, f_dst);
     for (int j = 0; j < 12; j++) {
       dst.y = 184 + j * 8;
       SDL_RectToFRect(&dst, &f_dst);
-      SDL_RenderTexture(
-        renderer_, sprite_sheet_, &sprite::objects_net_pillar, &f_dst);
+      draw(sprite::objects_net_pillar, f_dst);
     }
+  }
 
-    // Set the render target back to the main window
-    SDL_SetRenderTarget(renderer_, nullptr);
+  /**
+   * Get the position of the "game start" message (it grows during the NewGame state)
+   * @param frame_counter Frame counter of the NewGame state
+   */
+  [[nodiscard]] static SDL_FRect game_start_dst(const unsigned int frame_counter) {
+    // Estimate the message size and position for the current frame_counter
+    static constexpr int w = static_cast<int>(sprite::msg_game_start.w);
+    static constexpr int h = static_cast<int>(sprite::msg_game_start.h);
+    const int half_width = static_cast<int>(w * frame_counter / 50);
+    const int half_height = static_cast<int>(h * frame_counter / 50);
+    return {
+      .x = static_cast<float>(216 - half_width),
+      .y = static_cast<float>(50 + 2 * half_height),
+      .w = static_cast<float>(2 * half_width),
+      .h = static_cast<float>(2 * half_height),
+    };
+  }
+
+  /** Position of the "Ready" message */
+  constexpr static SDL_FRect ready_msg_dst {
+    .x = 176,
+    .y = 38,
+    .w = sprite::msg_ready.w,
+    .h = sprite::msg_ready.h,
+  };
+
+  /**
+   * Check if the blinking "Ready" message is shown (5 frames yes / 5 frames no)
+   * @param frame_counter Frame counter of the StartRound state
+   */
+  [[nodiscard]] constexpr static bool ready_msg_visible(const unsigned int frame_counter) {
+    return frame_counter / 5 % 2 != 0;
+  }
+
+  /**
+   * Get the position of the "game end" message (it shrinks in the first frames of the GameEnd state)
+   * @param frame_counter Frame counter of the GameEnd state
+   */
+  [[nodiscard]] static SDL_FRect game_end_dst(const unsigned int frame_counter) {
+    SDL_FRect dst = {
+      .x = 216 - sprite::msg_game_end.w / 2,
+      .y = 50,
+      .w = sprite::msg_game_end.w,
+      .h = sprite::msg_game_end.h,
+    };
+    if (frame_counter < 50) {
+      // In the first frames, reduce the message size
+      // Estimate the message size and position for the current frame_counter
+      static constexpr int w = static_cast<int>(sprite::msg_game_end.w);
+      static constexpr int h = static_cast<int>(sprite::msg_game_end.h);
+      const int width_increment = 2 * static_cast<int>(w * (50 - frame_counter) / 50);
+      const int height_increment = 2 * static_cast<int>(h * (50 - frame_counter) / 50);
+      dst.x -= static_cast<float>(width_increment);
+      dst.y -= static_cast<float>(height_increment);
+      dst.w += static_cast<float>(2 * width_increment);
+      dst.h += static_cast<float>(2 * height_increment);
+    }
+    return dst;
+  }
+
+  /**
+   * Call a draw function for every digit of the scoreboard. Shared by all the renderers.
+   * @param score_left Score of the left player
+   * @param score_right Score of the right player
+   * @param draw Function called with the source sprite and the destination rects
+   */
+  template <typename DrawFunction>
+  static void for_each_score_sprite(const int score_left, const int score_right, DrawFunction&& draw) {
+    // Set score sprite positions
+    static constexpr SDL_FRect dst_left_tens {
+      .x = 14,
+      .y = 10,
+      .w = sprite::number_0.w,
+      .h = sprite::number_0.h,
+    };
+    static constexpr SDL_FRect dst_left_units {
+      .x = 14 + sprite::number_0.w,
+      .y = 10,
+      .w = sprite::number_0.w,
+      .h = sprite::number_0.h,
+    };
+    static constexpr SDL_FRect dst_right_tens {
+      .x = screen_width - 2 * sprite::number_0.w - 14,
+      .y = 10,
+      .w = sprite::number_0.w,
+      .h = sprite::number_0.h,
+    };
+    static constexpr SDL_FRect dst_right_units {
+      .x = screen_width - sprite::number_0.w - 14,
+      .y = 10,
+      .w = sprite::number_0.w,
+      .h = sprite::number_0.h,
+    };
+
+    // Draw left score
+    const int units_left = score_left % 10;
+    draw(sprite::numbers[units_left], dst_left_units);
+    if (score_left >= 10) {
+      const int tens_left = score_left / 10 % 10;
+      draw(sprite::numbers[tens_left], dst_left_tens);
+    }
+
+    // Draw right score
+    const int units_right = score_right % 10;
+    draw(sprite::numbers[units_right], dst_right_units);
+    if (score_right >= 10) {
+      const int tens_right = score_right / 10 % 10;
+      draw(sprite::numbers[tens_right], dst_right_tens);
+    }
   }
 
   /**
@@ -223,14 +344,25 @@ public:
     score_right_ = right;
   }
 
+  /**
+   * Change the cosmetic layers that are drawn (the game state is always rendered)
+   * @param quality The new render quality
+   */
+  void set_quality(const RenderQuality quality) {
+    quality_ = quality;
+  }
+
 private:
   VolleyGameState volley_game_state_ {VolleyGameState::NewGame};
+  RenderQuality quality_ {RenderQuality::Full};
 
   int score_left_ {0};
   int score_right_ {0};
 
+  // Owner of the textures
+  RenderResources* resources_ {nullptr};
   // View objects
-  SDL_Texture_ptr background_texture_ {nullptr, SDL_DestroyTexture};
+  RenderResources::Texture background_texture_;
   Wave wave_;
   CloudSet clouds_;
   BallView ball_view_;
@@ -256,7 +388,11 @@ private:
     if (sprite_sheet_ == nullptr) {
       return;
     }
+    // The waves keep moving while they are not drawn
     wave_.update();
+    if (quality_ >= RenderQuality::NoWaves) {
+      return;
+    }
     SDL_FRect f_dst;
     SDL_Rect dst = {
       .x = 0,
@@ -278,6 +414,9 @@ private:
       return;
     }
     clouds_.update();
+    if (quality_ >= RenderQuality::NoClouds) {
+      return;
+    }
     for (const auto& cloud : clouds_.get_clouds()) {
       const SDL_FRect dst = cloud.get_rect();
       const SDL_FRect* cloud_sprite =
@@ -296,7 +435,7 @@ private:
     // Render ball and players
     player_view_left_.draw_player(physics_view.player_left);
     player_view_right_.draw_player(physics_view.player_right);
-    ball_view_.draw_ball(physics_view.ball);
+    ball_view_.draw_ball(physics_view.ball, quality_ < RenderQuality::NoTrails, quality_ < RenderQuality::NoEffects);
   }
 
   /** Render the game start message in the NewGame state */
@@ -308,18 +447,8 @@ private:
     // Apply a fade-in the first 17 frames
     fade_in(1.0f / 17);
 
-    // Estimate the message size and position for the current frame_counter
-    static constexpr int w = static_cast<int>(sprite::msg_game_start.w);
-    static constexpr int h = static_cast<int>(sprite::msg_game_start.h);
-    const int half_width = static_cast<int>(w * frame_counter / 50);
-    const int half_height = static_cast<int>(h * frame_counter / 50);
-    const SDL_FRect dst = {
-      .x = static_cast<float>(216 - half_width),
-      .y = static_cast<float>(50 + 2 * half_height),
-      .w = static_cast<float>(2 * half_width),
-      .h = static_cast<float>(2 * half_height),
-    };
     // Draw the "game start" message
+    const SDL_FRect dst = game_start_dst(frame_counter);
     SDL_RenderTexture(renderer_, sprite_sheet_, &sprite::msg_game_start, &dst);
   }
 
@@ -328,17 +457,10 @@ private:
    * The message is toggled every 5 frames
    */
   void render_ready_msg(const unsigned int frame_counter) const {
-    // Only show the message every 5 frames (5 yes / 5 no)
-    if (!sprite_sheet_ || frame_counter / 5 % 2 == 0) {
+    if (!sprite_sheet_ || !ready_msg_visible(frame_counter)) {
       return;
     }
-    constexpr static SDL_FRect dst {
-      .x = 176,
-      .y = 38,
-      .w = sprite::msg_ready.w,
-      .h = sprite::msg_ready.h,
-    };
-    SDL_RenderTexture(renderer_, sprite_sheet_, &sprite::msg_ready, &dst);
+    SDL_RenderTexture(renderer_, sprite_sheet_, &sprite::msg_ready, &ready_msg_dst);
   }
 
   /** Render the game start message in the NewGame state */
@@ -347,25 +469,8 @@ private:
       return;
     }
 
-    SDL_FRect dst = {
-      .x = 216 - sprite::msg_game_end.w / 2,
-      .y = 50,
-      .w = sprite::msg_game_end.w,
-      .h = sprite::msg_game_end.h,
-    };
-    if (frame_counter < 50) {
-      // In the first frames, reduce the message size
-      // Estimate the message size and position for the current frame_counter
-      static constexpr int w = static_cast<int>(sprite::msg_game_end.w);
-      static constexpr int h = static_cast<int>(sprite::msg_game_end.h);
-      const int width_increment = 2 * static_cast<int>(w * (50 - frame_counter) / 50);
-      const int height_increment = 2 * static_cast<int>(h * (50 - frame_counter) / 50);
-      dst.x -= static_cast<float>(width_increment);
-      dst.y -= static_cast<float>(height_increment);
-      dst.w += static_cast<float>(2 * width_increment);
-      dst.h += static_cast<float>(2 * height_increment);
-    }
-    // Draw the "game start" message
+    // Draw the "game end" message
+    const SDL_FRect dst = game_end_dst(frame_counter);
     SDL_RenderTexture(renderer_, sprite_sheet_, &sprite::msg_game_end, &dst);
   }
 
@@ -375,47 +480,9 @@ private:
       return;
     }
 
-    // Set score sprite positions
-    static constexpr SDL_FRect dst_left_tens {
-      .x = 14,
-      .y = 10,
-      .w = sprite::number_0.w,
-      .h = sprite::number_0.h,
-    };
-    static constexpr SDL_FRect dst_left_units {
-      .x = 14 + sprite::number_0.w,
-      .y = 10,
-      .w = sprite::number_0.w,
-      .h = sprite::number_0.h,
-    };
-    static constexpr SDL_FRect dst_right_tens {
-      .x = screen_width - 2 * sprite::number_0.w - 14,
-      .y = 10,
-      .w = sprite::number_0.w,
-      .h = sprite::number_0.h,
-    };
-    static constexpr SDL_FRect dst_right_units {
-      .x = screen_width - sprite::number_0.w - 14,
-      .y = 10,
-      .w = sprite::number_0.w,
-      .h = sprite::number_0.h,
-    };
-
-    // Draw left score
-    const int units_left = score_left_ % 10;
-    SDL_RenderTexture(renderer_, sprite_sheet_, &sprite::numbers[units_left], &dst_left_units);
-    if (score_left_ >= 10) {
-      const int tens_left = score_left_ / 10 % 10;
-      SDL_RenderTexture(renderer_, sprite_sheet_, &sprite::numbers[tens_left], &dst_left_tens);
-    }
-
-    // Draw right score
-    const int units_right = score_right_ % 10;
-    SDL_RenderTexture(renderer_, sprite_sheet_, &sprite::numbers[units_right], &dst_right_units);
-    if (score_right_ >= 10) {
-      const int tens_right = score_right_ / 10 % 10;
-      SDL_RenderTexture(renderer_, sprite_sheet_, &sprite::numbers[tens_right], &dst_right_tens);
-    }
+    for_each_score_sprite(score_left_, score_right_, [this](const SDL_FRect& src, const SDL_FRect& dst) {
+      SDL_RenderTexture(renderer_, sprite_sheet_, &src, &dst);
+    });
   }
 
 };
@@ -0,0 +1,152 @@
+/**
+ * Round trips of the asset pack and its compression (see asset_pack.hpp).
+ * Covers empty, incompressible and highly repetitive data (overlapping matches),
+ * and checks that corrupted blocks and packs are rejected.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <pikaball/asset_pack.hpp>
+
+using namespace pika;
+
+namespace {
+
+int failures = 0;
+
+void check(const bool condition, const char* description) {
+  if (!condition) {
+    std::printf("FAILED: %s\n", description);
+    failures++;
+  }
+}
+
+std::vector<std::byte> random_bytes(const std::size_t size) {
+  std::mt19937 generator {1234};
+  std::vector<std::byte> data(size);
+  for (auto& byte : data) {
+    byte = static_cast<std::byte>(generator() & 0xFF);
+  }
+  return data;
+}
+
+std::vector<std::byte> repeated_pattern(const std::string& pattern, const std::size_t size) {
+  std::vector<std::byte> data(size);
+  for (std::size_t i = 0; i < size; i++) {
+    data[i] = static_cast<std::byte>(pattern[i % pattern.size()]);
+  }
+  return data;
+}
+
+/** Compress and decompress the data, and check that it comes back the same */
+bool round_trip(const std::vector<std::byte>& data) {
+  const std::vector<std::byte> compressed = lz::compress(data);
+  std::vector<std::byte> decompressed(data.size());
+  return lz::decompress(compressed, decompressed) && decompressed == data;
+}
+
+void test_codec() {
+  check(round_trip({}), "empty block round trip");
+  check(round_trip(random_bytes(5)), "block shorter than the match margin");
+
+  const std::vector<std::byte> incompressible = random_bytes(100000);
+  check(round_trip(incompressible), "incompressible block round trip");
+  check(lz::compress(incompressible).size() <= incompressible.size() + incompressible.size() / 255 + 16,
+        "incompressible block does not grow over the bound");
+
+  // A single repeated byte is a match with offset 1, which overlaps the bytes it writes
+  const std::vector<std::byte> single_byte = repeated_pattern("a", 100000);
+  check(round_trip(single_byte), "single byte run round trip (overlapping match)");
+  check(lz::compress(single_byte).size() < single_byte.size() / 100, "single byte run is compressed");
+  const std::vector<std::byte> pattern = repeated_pattern("pikachu", 70000);
+  check(round_trip(pattern), "repeated pattern round trip (overlapping match)");
+  check(lz::compress(pattern).size() < pattern.size() / 100, "repeated pattern is compressed");
+}
+
+void test_corrupted_blocks() {
+  const std::vector<std::byte> data = repeated_pattern("volleyball ", 5000);
+  const std::vector<std::byte> compressed = lz::compress(data);
+  std::vector<std::byte> output(data.size());
+
+  const std::vector<std::byte> truncated(compressed.begin(), compressed.end() - 1);
+  check(!lz::decompress(truncated, output), "truncated block is rejected");
+  std::vector<std::byte> shorter(data.size() - 1);
+  check(!lz::decompress(compressed, shorter), "output smaller than the data is rejected");
+  std::vector<std::byte> longer(data.size() + 1);
+  check(!lz::decompress(compressed, longer), "output larger than the data is rejected");
+
+  // First sequence: token with 11 literals (the pattern), the literals, then the match offset
+  std::vector<std::byte> zero_offset = compressed;
+  zero_offset[12] = std::byte {0};
+  zero_offset[13] = std::byte {0};
+  check(!lz::decompress(zero_offset, output), "match with offset 0 is rejected");
+  std::vector<std::byte> far_offset = compressed;
+  far_offset[12] = std::byte {0xFF};
+  far_offset[13] = std::byte {0xFF};
+  check(!lz::decompress(far_offset, output), "match before the start of the output is rejected");
+
+  // Any corruption must fail cleanly (no crash or out of bounds access, e.g. with sanitizers)
+  std::mt19937 generator {42};
+  for (int i = 0; i < 1000; i++) {
+    std::vector<std::byte> corrupted = compressed;
+    corrupted[generator() % corrupted.size()] = static_cast<std::byte>(generator() & 0xFF);
+    static_cast<void>(lz::decompress(corrupted, output));
+  }
+}
+
+void test_pack() {
+  const std::vector<AssetPack::Input> assets {
+    {"assets/empty.bin", {}},
+    {"assets/noise.bin", random_bytes(20000)},
+    {"assets/pattern.bin", repeated_pattern("pi", 20000)},
+  };
+  const std::vector<std::byte> data = AssetPack::build(assets);
+  const AssetPack pack {data};
+  check(pack.is_valid(), "pack is valid");
+  check(pack.size() == assets.size(), "pack has all the assets");
+  for (const auto& asset : assets) {
+    const auto contents = pack.find(asset.name);
+    check(contents.has_value() && std::vector<std::byte>(contents->begin(), contents->end()) == asset.data,
+          ("pack round trip of " + asset.name).c_str());
+  }
+  check(!pack.find("assets/missing.bin").has_value(), "missing asset is not found");
+
+  std::vector<std::byte> bad_magic = data;
+  bad_magic[0] = std::byte {0};
+  check(!AssetPack(bad_magic).is_valid(), "pack with a wrong magic is rejected");
+  const std::vector<std::byte> truncated(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(data.size() / 2));
+  check(!AssetPack(truncated).is_valid(), "truncated pack is rejected");
+
+  // Corrupt the offset of the first match of the compressed asset (token, "pi", offset):
+  // only that asset fails to load
+  const std::vector<std::byte> block = lz::compress(assets[2].data);
+  std::vector<std::byte> corrupted = data;
+  const auto position = std::ranges::search(corrupted, block).begin();
+  check(position != corrupted.end(), "compressed asset is stored compressed");
+  if (position != corrupted.end()) {
+    position[3] = std::byte {0};
+    position[4] = std::byte {0};
+  }
+  const AssetPack corrupted_pack {corrupted};
+  check(corrupted_pack.is_valid(), "pack with corrupted data has a valid index");
+  check(!corrupted_pack.find("assets/pattern.bin").has_value(), "corrupted asset is rejected");
+  check(corrupted_pack.find("assets/noise.bin").has_value(), "uncorrupted asset is still found");
+}
+
+} // namespace
+
+int main() {
+  test_codec();
+  test_corrupted_blocks();
+  test_pack();
+  if (failures > 0) {
+    std::printf("%d checks failed\n", failures);
+    return EXIT_FAILURE;
+  }
+  std::printf("All checks passed\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,109 @@
+/**
+ * Check of the cached landing prediction of the ball (see BasicBall::update_landing_point).
+ * The prediction is only recomputed when the trajectory changes, so after every frame the
+ * cached landing point and remaining frames must be the same as a fresh prediction.
+ * Matches are played with the computer and random inputs, for each rules policy.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include <pikaball/controller/computer_controller.hpp>
+#include <pikaball/physics/physics.hpp>
+
+using namespace pika;
+
+namespace {
+
+constexpr long match_frames = 200000;
+// Frames between the ball touching the ground and the next round (like the game)
+constexpr int round_end_frames = 11;
+
+/** Input with random directions and power hits */
+PlayerInput random_input(std::mt19937& generator) {
+  return PlayerInput {
+    static_cast<DirX>(static_cast<int>(generator() % 3) - 1),
+    static_cast<DirY>(static_cast<int>(generator() % 3) - 1),
+    generator() % 2 == 0,
+  };
+}
+
+/**
+ * Compare the cached prediction with a new one from the same ball
+ * @return false (and print the frame) if they differ
+ */
+template <PhysicsRules Rules>
+bool check_landing(const BasicBall<Rules>& ball, const long frame, const char* name) {
+  BasicBall<Rules> fresh {ball};
+  fresh.calculate_landing_point();
+  if (fresh.expected_landing_x() != ball.expected_landing_x() ||
+      fresh.frames_until_landing() != ball.frames_until_landing()) {
+    std::printf("FAILED: %s, frame %ld: cached landing x %d in %d frames, predicted x %d in %d frames\n",
+                name, frame, ball.expected_landing_x(), ball.frames_until_landing(),
+                fresh.expected_landing_x(), fresh.frames_until_landing());
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Play a match and check the landing prediction after every frame
+ * @param computer Whether the players are controlled by the computer (with random noise)
+ *                 or only by random inputs
+ */
+template <PhysicsRules Rules>
+bool play_match(const char* name, const bool computer) {
+  std::mt19937 generator {2024};
+  Physics<Rules> physics;
+  ComputerController computer_left {FieldSide::Left};
+  ComputerController computer_right {FieldSide::Right};
+  const auto start_round = [&](const FieldSide side) {
+    physics.init_round(side);
+    if constexpr (requires { PhysicsView(physics); }) {
+      computer_left.on_round_start(PhysicsView(physics));
+      computer_right.on_round_start(PhysicsView(physics));
+    }
+  };
+
+  start_round(FieldSide::Left);
+  int round_end_timer = -1;
+  for (long frame = 0; frame < match_frames; frame++) {
+    PlayerInput input_left = random_input(generator);
+    PlayerInput input_right = random_input(generator);
+    if constexpr (requires { PhysicsView(physics); }) {
+      // Mostly the computer, with some random inputs to reach unusual trajectories
+      if (computer && generator() % 7 != 0) {
+        input_left = computer_left.on_update(PhysicsView(physics));
+        input_right = computer_right.on_update(PhysicsView(physics));
+      }
+    }
+    const bool ball_on_ground = physics.update(input_left, input_right);
+    if (!check_landing(physics.ball(), frame, name)) {
+      return false;
+    }
+    if (ball_on_ground && round_end_timer < 0) {
+      round_end_timer = round_end_frames;
+    }
+    if (round_end_timer >= 0 && --round_end_timer == 0) {
+      round_end_timer = -1;
+      start_round((generator() % 2 == 0) ? FieldSide::Left : FieldSide::Right);
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main() {
+  bool passed = true;
+  passed &= play_match<OriginalRules>("original rules, computer", true);
+  passed &= play_match<OriginalRules>("original rules, random inputs", false);
+  passed &= play_match<HeadlessRules>("headless rules, computer", true);
+  // Other wall bounds (the prediction must follow the rules of the ball)
+  passed &= play_match<SymmetricRules>("symmetric rules, random inputs", false);
+  if (!passed) {
+    return EXIT_FAILURE;
+  }
+  std::printf("All checks passed\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,119 @@
+/**
+ * Check of the multi-lane landing prediction (see predict_landings()).
+ * Every lane must give exactly the same prediction as predict_landing() with the same state,
+ * for random balls and batch sizes that are not a multiple of the number of lanes.
+ * The game rules never reach the loop limit with these balls, so a rules policy with a short
+ * limit checks the lanes that are stopped before landing.
+ */
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <type_traits>
+
+#include <pikaball/physics/trajectory_batch.hpp>
+
+using namespace pika;
+
+namespace {
+
+constexpr int batches = 2000;
+
+/** Random ball inside the world, with velocities like the ones of the game */
+BallState random_ball(std::mt19937& generator) {
+  return BallState {
+    .x = static_cast<int>(generator() % (ground_width - 2 * ball_radius)) + ball_radius,
+    .y = static_cast<int>(generator() % ball_ground_y),
+    .velocity_x = static_cast<int>(generator() % 41) - 20,
+    .velocity_y = static_cast<int>(generator() % 61) - 30,
+  };
+}
+
+/** Original rules with a loop limit that many of the random balls reach before landing */
+struct ShortLoopRules : OriginalRules {
+  static constexpr unsigned int infinite_loop_limit = 24;
+};
+
+/**
+ * Serial landing prediction of a lane.
+ * Only the rules of the game are instantiated in the physics library, so the prediction of
+ * ShortLoopRules runs the same loop as predict_landing() with the trajectory of the original
+ * rules (they have the same bounds).
+ */
+template <PhysicsRules Rules>
+LandingPrediction expected_landing(BallState state) {
+  if constexpr (std::is_same_v<Rules, ShortLoopRules>) {
+    LandingPrediction prediction {};
+    while (true) {
+      prediction.frames++;
+      prediction.landed = step_trajectory<OriginalRules>(state);
+      if (prediction.landed || prediction.frames >= static_cast<int>(Rules::infinite_loop_limit)) {
+        break;
+      }
+    }
+    prediction.x = state.x;
+    return prediction;
+  }
+  else {
+    return predict_landing<Rules>(state);
+  }
+}
+
+/**
+ * Compare predict_landings() with the serial prediction for random batches of K balls
+ * @return The number of lanes that differ
+ */
+template <std::size_t K, PhysicsRules Rules>
+int check_batches(const char* name) {
+  std::mt19937 generator {2024};
+  int errors = 0;
+  int not_landed = 0;
+  for (int b = 0; b < batches; b++) {
+    std::array<BallState, K> states {};
+    for (BallState& state : states) {
+      state = random_ball(generator);
+    }
+    const auto predictions = predict_landings<K, Rules>(states);
+    for (std::size_t i = 0; i < K; i++) {
+      const LandingPrediction expected = expected_landing<Rules>(states[i]);
+      const LandingPrediction& actual = predictions[i];
+      not_landed += expected.landed ? 0 : 1;
+      if (actual.x != expected.x || actual.frames != expected.frames || actual.landed != expected.landed) {
+        if (errors == 0) {
+          std::printf("FAILED: %s, K = %zu, batch %d, lane %zu: x %d in %d frames (landed %d), expected x %d in %d frames (landed %d)\n",
+                      name, K, b, i, actual.x, actual.frames, actual.landed, expected.x, expected.frames, expected.landed);
+        }
+        errors++;
+      }
+    }
+  }
+  // The short loop limit must really stop some lanes, or they are not checked
+  if (Rules::infinite_loop_limit < pika::infinite_loop_limit && not_landed == 0) {
+    std::printf("FAILED: %s, K = %zu: no lane reached the loop limit\n", name, K);
+    errors++;
+  }
+  return errors;
+}
+
+template <PhysicsRules Rules>
+int check_rules(const char* name) {
+  constexpr std::size_t lanes = detail::trajectory_lanes;
+  return check_batches<1, Rules>(name) +
+         check_batches<6, Rules>(name) +
+         check_batches<lanes, Rules>(name) +
+         check_batches<2 * lanes + 3, Rules>(name);
+}
+
+} // namespace
+
+int main() {
+  const int errors = check_rules<OriginalRules>("original rules") +
+                     check_rules<SymmetricRules>("symmetric rules") +
+                     check_rules<ShortLoopRules>("short loop limit");
+  if (errors > 0) {
+    return EXIT_FAILURE;
+  }
+  std::printf("All checks passed\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,142 @@
+/**
+ * Check that a recorded match plays again exactly the same (see VolleyMatch).
+ * A match between computer players is played with its frames recorded (including instant replay
+ * skips, skipped end frames and a change of the winning score). Then the frames are played again
+ * on a new physics object with the same seed, and every frame must have the same state.
+ */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <pikaball/controller/computer_controller.hpp>
+#include <pikaball/physics/physics.hpp>
+#include <pikaball/random.hpp>
+#include <pikaball/volley_match.hpp>
+
+using namespace pika;
+
+namespace {
+
+constexpr std::uint32_t match_seed = 2024;
+// Frames are limited in case the match never ends
+constexpr std::size_t max_frames = 200000;
+
+/** State of a frame of the match */
+struct FrameState {
+  VolleyMatch::Transition transition {VolleyMatch::Transition::None};
+  std::uint64_t hash {0};
+};
+
+/** Hash of the state of the match and the physics (FNV-1a) */
+std::uint64_t state_hash(const VolleyMatch& match, const Physics<>& physics) {
+  std::uint64_t hash = 1469598103934665603ull;
+  const auto mix = [&hash](const long value) {
+    hash ^= static_cast<std::uint64_t>(value);
+    hash *= 1099511628211ull;
+  };
+  mix(static_cast<long>(match.state()));
+  mix(match.frame_counter());
+  mix(match.score_left());
+  mix(match.score_right());
+  const auto& ball = physics.ball();
+  for (const int value : {ball.x(), ball.y(), ball.velocity_x(), ball.velocity_y(), ball.expected_landing_x(),
+                          ball.rotation(), ball.punch_effect_x(), ball.punch_effect_radius()}) {
+    mix(value);
+  }
+  for (const auto side : {FieldSide::Left, FieldSide::Right}) {
+    const auto& player = physics.player(side);
+    mix(player.x());
+    mix(player.y());
+    mix(static_cast<long>(player.state()));
+    mix(player.anim_frame_number());
+  }
+  for (std::size_t i = 0; i < physics.events().size(); i++) {
+    mix(static_cast<long>(physics.events()[i].type));
+  }
+  return hash;
+}
+
+/**
+ * Play a match with the computer controllers
+ * @param frames Output with the frames of the match
+ * @param states Output with the state after each frame
+ * @return True if the match ended with the winning score
+ */
+bool play_match(std::vector<MatchFrame>& frames, std::vector<FrameState>& states) {
+  std::mt19937 generator {42};
+  Physics<> physics;
+  VolleyMatch match {physics};
+  ComputerController computer_left {FieldSide::Left};
+  ComputerController computer_right {FieldSide::Right};
+  match.start(match_seed);
+  computer_left.on_game_start(PhysicsView(physics));
+  computer_right.on_game_start(PhysicsView(physics));
+
+  while (frames.size() < max_frames) {
+    MatchFrame frame {
+      .input_left = computer_left.on_update(PhysicsView(physics)),
+      .input_right = computer_right.on_update(PhysicsView(physics)),
+      // The winning score is lowered in the middle of the game
+      .win_score = frames.size() < 5000 ? 15 : 10,
+      .skip_game_end = generator() % 50 == 0,
+      // Some rounds end early, as after an instant replay
+      .next_round = match.state() == VolleyGameState::EndRound && generator() % 20 == 0,
+    };
+    const auto transition = match.step(frame, [&physics](const PlayerInput& input_left, const PlayerInput& input_right) {
+      return physics.update(input_left, input_right);
+    });
+    if (transition == VolleyMatch::Transition::RoundStarted) {
+      computer_left.on_round_start(PhysicsView(physics));
+      computer_right.on_round_start(PhysicsView(physics));
+    }
+    frames.push_back(frame);
+    states.push_back({transition, state_hash(match, physics)});
+    if (transition == VolleyMatch::Transition::GameOver) {
+      return match.score_left() >= 10 || match.score_right() >= 10;
+    }
+  }
+  return false;
+}
+
+/**
+ * Play the recorded frames again and compare the state of each frame
+ * @return The number of frames that differ
+ */
+std::size_t replay_match(const std::vector<MatchFrame>& frames, const std::vector<FrameState>& states) {
+  Physics<> physics;
+  VolleyMatch match {physics};
+  match.start(match_seed);
+  std::size_t differences = 0;
+  for (std::size_t i = 0; i < frames.size(); i++) {
+    // Other objects use the shared random generator in the meantime: the match must not depend on it
+    static_cast<void>(rand_int());
+    const auto transition = match.step(frames[i], [&physics](const PlayerInput& input_left, const PlayerInput& input_right) {
+      return physics.update(input_left, input_right);
+    });
+    if (transition != states[i].transition || state_hash(match, physics) != states[i].hash) {
+      if (differences == 0) {
+        std::printf("FAILED: the replayed match differs at frame %zu\n", i);
+      }
+      differences++;
+    }
+  }
+  return differences;
+}
+
+} // namespace
+
+int main() {
+  std::vector<MatchFrame> frames;
+  std::vector<FrameState> states;
+  if (!play_match(frames, states)) {
+    std::printf("FAILED: the match did not end with the winning score\n");
+    return EXIT_FAILURE;
+  }
+  if (replay_match(frames, states) > 0) {
+    return EXIT_FAILURE;
+  }
+  std::printf("All checks passed (%zu frames)\n", frames.size());
+  return EXIT_SUCCESS;
+}